@@ -30,8 +30,11 @@
 #include "util/XDRStream.h"
 #include "util/make_unique.h"
 #include "xdrpp/message.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <future>
+#include <thread>
 
 namespace stellar
 {
@@ -51,6 +54,31 @@ randomBucketName(std::string const& tmpDir)
     }
 }
 
+// Save `index` next to a freshly written bucket file and adopt both.
+static std::shared_ptr<Bucket>
+adoptWithIndex(BucketManager& bucketManager, std::string const& filename,
+               uint256 const& hash, size_t nObjects, size_t nBytes,
+               std::shared_ptr<BucketIndex const> index)
+{
+    try
+    {
+        index->save(BucketIndex::filenameFor(filename));
+    }
+    catch (std::exception& e)
+    {
+        // Not fatal: the index is rebuilt from the bucket if it's missing.
+        CLOG(WARNING, "Bucket") << "Failed to save index of " << filename
+                                << ": " << e.what();
+    }
+    auto b =
+        bucketManager.adoptFileAsBucket(filename, hash, nObjects, nBytes);
+    if (!b->getFilename().empty())
+    {
+        b->setIndex(index);
+    }
+    return b;
+}
+
 Bucket::Bucket(std::string const& filename, Hash const& hash)
     : mFilename(filename), mHash(hash)
 {
@@ -68,6 +96,7 @@ Bucket::~Bucket()
     {
         CLOG(TRACE, "Bucket") << "Bucket::~Bucket removing file: " << mFilename;
         std::remove(mFilename.c_str());
+        std::remove(BucketIndex::filenameFor(mFilename).c_str());
     }
 }
 
@@ -100,6 +129,7 @@ Bucket::setRetain(bool r)
 void
 Bucket::InputIterator::loadEntry()
 {
+    mEntryOffset = mIn.pos();
     if (mIn.readOne(mEntry))
     {
         mEntryPtr = &mEntry;
@@ -150,15 +180,32 @@ Bucket::InputIterator& Bucket::InputIterator::operator++()
     return *this;
 }
 
+std::streamoff
+Bucket::InputIterator::getOffset() const
+{
+    return mEntryOffset;
+}
+
+void
+Bucket::InputIterator::seek(std::streamoff offset)
+{
+    if (!mBucket->mFilename.empty())
+    {
+        mIn.seek(offset);
+        loadEntry();
+    }
+}
+
 /**
  * Helper class that points to an output tempfile. Absorbs BucketEntries and
  * hashes them while writing to either destination. Produces a Bucket when done.
  */
 Bucket::OutputIterator::OutputIterator(std::string const& tmpDir,
-                                       bool keepDeadEntries)
+                                       bool keepDeadEntries, bool hashEntries)
     : mFilename(randomBucketName(tmpDir))
     , mBuf(nullptr)
-    , mHasher(SHA256::create())
+    , mHasher(hashEntries ? SHA256::create() : nullptr)
+    , mIndex(std::make_shared<BucketIndex>())
     , mKeepDeadEntries(keepDeadEntries)
 {
     CLOG(TRACE, "Bucket") << "Bucket::OutputIterator opening file to write: "
@@ -166,6 +213,24 @@ Bucket::OutputIterator::OutputIterator(std::string const& tmpDir,
     mOut.open(mFilename);
 }
 
+void
+Bucket::OutputIterator::writeBuffered()
+{
+    mIndex->noteEntry(*mBuf, static_cast<std::streamoff>(mBytesPut));
+    mOut.writeOne(*mBuf, mHasher.get(), &mBytesPut);
+    mObjectsPut++;
+}
+
+void
+Bucket::OutputIterator::closeOutput()
+{
+    if (!mOut.close())
+    {
+        std::remove(mFilename.c_str());
+        throw std::runtime_error("failed to write bucket file " + mFilename);
+    }
+}
+
 void
 Bucket::OutputIterator::put(BucketEntry const& e)
 {
@@ -185,8 +250,7 @@ Bucket::OutputIterator::put(BucketEntry const& e)
         // merely replace (same identity), the buffered entry.
         if (mCmp(*mBuf, e))
         {
-            mOut.writeOne(*mBuf, mHasher.get(), &mBytesPut);
-            mObjectsPut++;
+            writeBuffered();
         }
     }
     else
@@ -202,14 +266,14 @@ std::shared_ptr<Bucket>
 Bucket::OutputIterator::getBucket(BucketManager& bucketManager)
 {
     assert(mOut);
+    assert(mHasher);
     if (mBuf)
     {
-        mOut.writeOne(*mBuf, mHasher.get(), &mBytesPut);
-        mObjectsPut++;
+        writeBuffered();
         mBuf.reset();
     }
 
-    mOut.close();
+    closeOutput();
     if (mObjectsPut == 0 || mBytesPut == 0)
     {
         assert(mObjectsPut == 0);
@@ -218,26 +282,128 @@ Bucket::OutputIterator::getBucket(BucketManager& bucketManager)
         std::remove(mFilename.c_str());
         return std::make_shared<Bucket>();
     }
-    return bucketManager.adoptFileAsBucket(mFilename, mHasher->finish(),
-                                           mObjectsPut, mBytesPut);
+    mIndex->noteEnd(static_cast<std::streamoff>(mBytesPut));
+    return adoptWithIndex(bucketManager, mFilename, mHasher->finish(),
+                          mObjectsPut, mBytesPut, mIndex);
+}
+
+std::string
+Bucket::OutputIterator::finishPart(size_t& nObjects, size_t& nBytes)
+{
+    assert(mOut);
+    if (mBuf)
+    {
+        writeBuffered();
+        mBuf.reset();
+    }
+
+    closeOutput();
+    nObjects += mObjectsPut;
+    nBytes += mBytesPut;
+    return mFilename;
+}
+
+std::shared_ptr<BucketIndex>
+Bucket::OutputIterator::getIndex() const
+{
+    return mIndex;
+}
+
+std::shared_ptr<BucketIndex const>
+Bucket::getIndex() const
+{
+    assert(!mFilename.empty());
+    std::lock_guard<std::mutex> lock(mIndexMutex);
+    if (!mIndex)
+    {
+        auto indexFilename = BucketIndex::filenameFor(mFilename);
+        if (fs::exists(indexFilename))
+        {
+            try
+            {
+                mIndex = BucketIndex::load(indexFilename);
+            }
+            catch (std::exception& e)
+            {
+                CLOG(WARNING, "Bucket") << "Failed to load bucket index "
+                                        << indexFilename << ": " << e.what();
+            }
+        }
+        if (!mIndex)
+        {
+            auto index = BucketIndex::build(mFilename);
+            try
+            {
+                index->save(indexFilename);
+            }
+            catch (std::exception& e)
+            {
+                CLOG(WARNING, "Bucket") << "Failed to save bucket index "
+                                        << indexFilename << ": " << e.what();
+            }
+            mIndex = index;
+        }
+    }
+    return mIndex;
+}
+
+void
+Bucket::setIndex(std::shared_ptr<BucketIndex const> index) const
+{
+    std::lock_guard<std::mutex> lock(mIndexMutex);
+    if (!mIndex)
+    {
+        mIndex = index;
+    }
+}
+
+// Compare the key of a bucket entry with a ledger key.
+static bool
+entryLessThanKey(BucketEntry const& e, LedgerKey const& key)
+{
+    LedgerEntryIdCmp cmp;
+    return e.type() == LIVEENTRY ? cmp(e.liveEntry(), key)
+                                 : cmp(e.deadEntry(), key);
 }
 
 bool
-Bucket::containsBucketIdentity(BucketEntry const& id) const
+Bucket::getEntry(LedgerKey const& key, BucketEntry& entry) const
 {
-    BucketEntryIdCmp cmp;
-    Bucket::InputIterator iter(shared_from_this());
-    while (iter)
+    if (mFilename.empty())
+    {
+        return false;
+    }
+    auto index = getIndex();
+    std::streamoff begin, end;
+    if (!index->mayContain(key) || !index->findPage(key, begin, end))
+    {
+        return false;
+    }
+
+    XDRInputFileStream in(0, static_cast<size_t>(end - begin));
+    in.open(mFilename);
+    in.seek(begin);
+    while (in.pos() < end && in.readOne(entry))
     {
-        if (!(cmp(*iter, id) || cmp(id, *iter)))
+        if (!entryLessThanKey(entry, key))
         {
-            return true;
+            LedgerEntryIdCmp cmp;
+            return entry.type() == LIVEENTRY ? !cmp(key, entry.liveEntry())
+                                             : !cmp(key, entry.deadEntry());
         }
-        ++iter;
     }
     return false;
 }
 
+bool
+Bucket::containsBucketIdentity(BucketEntry const& id) const
+{
+    BucketEntry entry;
+    return getEntry(id.type() == LIVEENTRY ? LedgerEntryKey(id.liveEntry())
+                                           : id.deadEntry(),
+                    entry);
+}
+
 std::pair<size_t, size_t>
 Bucket::countLiveAndDeadEntries() const
 {
@@ -313,34 +479,341 @@ Bucket::fresh(BucketManager& bucketManager,
     return Bucket::merge(bucketManager, liveBucket, deadBucket);
 }
 
+// Below this many bytes of input a merge is not worth splitting into parts.
+static const size_t kMinBytesPerMergePart = 16 * 1024 * 1024;
+
+// Buffer size for streams that read single entries at scattered offsets.
+static const size_t kProbeBufferSize = 4096;
+
+typedef std::vector<std::unique_ptr<Bucket::InputIterator>> InputIterators;
+
+namespace
+{
+// A shadow bucket being scanned alongside a merge, with its index so the scan
+// can skip the shadow entirely for keys its Bloom filter rules out, and jump
+// ahead to the right page for the rest.
+struct ShadowCursor
+{
+    std::unique_ptr<Bucket::InputIterator> mIter;
+    std::shared_ptr<BucketIndex const> mIndex;
+};
+}
+
 inline void
 maybe_put(BucketEntryIdCmp const& cmp, Bucket::OutputIterator& out,
-          Bucket::InputIterator& in,
-          std::vector<Bucket::InputIterator>& shadowIterators)
+          BucketEntry const& e, std::vector<ShadowCursor>& shadows)
 {
-    for (auto& si : shadowIterators)
+    if (shadows.empty())
+    {
+        out.put(e);
+        return;
+    }
+
+    auto key = BucketIndex::getKey(e);
+    auto keyHash = BucketBloomFilter::hashKey(key);
+    for (auto& shadow : shadows)
     {
-        // Advance the shadowIterator while it's less than the candidate
-        while (si && cmp(*si, *in))
+        auto& si = *shadow.mIter;
+        std::streamoff begin, end;
+        if (!si || !shadow.mIndex->mayContain(keyHash) ||
+            !shadow.mIndex->findPage(key, begin, end))
+        {
+            continue;
+        }
+        // Skip over the pages that can't hold the candidate, then advance
+        // the shadowIterator while it's less than the candidate.
+        if (si.getOffset() < begin)
+        {
+            si.seek(begin);
+        }
+        while (si && cmp(*si, e))
         {
             ++si;
         }
         // We have stepped si forward to the point that either si is exhausted,
-        // or else *si >= *in; we now check the opposite direction to see if we
+        // or else *si >= e; we now check the opposite direction to see if we
         // have equality.
-        if (si && !cmp(*in, *si))
+        if (si && !cmp(e, *si))
         {
-            // If so, then *in is shadowed in at least one level and we will
-            // not be doing a 'put'; we return early. There is no need to
-            // advance
+            // If so, then e is shadowed in at least one level and we will not
+            // be doing a 'put'; we return early. There is no need to advance
             // the other iterators, they will advance as and if necessary in
-            // future
-            // calls to maybe_put.
+            // future calls to maybe_put.
             return;
         }
     }
     // Nothing shadowed.
-    out.put(*in);
+    out.put(e);
+}
+
+namespace
+{
+// One key range of a merge: the offsets at which each input and shadow bucket
+// reaches the lower bound of the range, and the (exclusive) upper bound of the
+// range. Empty offsets mean "from the start", a null bound "to the end".
+struct MergeRange
+{
+    std::vector<std::streamoff> mInputStarts;
+    std::vector<std::streamoff> mShadowStarts;
+    std::shared_ptr<BucketEntry> mUpper;
+};
+
+struct MergePartResult
+{
+    std::string mFilename;
+    size_t mObjects{0};
+    size_t mBytes{0};
+    std::shared_ptr<BucketIndex> mIndex;
+};
+
+// A part of a parallel merge, posted to the worker pool. Whichever thread gets
+// to it first -- a worker, or the thread waiting on the merge -- runs it, so a
+// merge never waits on parts queued behind busy workers.
+struct MergePart
+{
+    std::atomic<bool> mClaimed{false};
+    std::packaged_task<MergePartResult()> mTask;
+
+    void
+    run()
+    {
+        if (!mClaimed.exchange(true))
+        {
+            mTask();
+        }
+    }
+};
+}
+
+// Merge the entries of `inputs` (ordered oldest-first) that fall in `range`,
+// minus any shadowed entries, into `out`.
+static void
+mergeRange(std::vector<std::shared_ptr<Bucket>> const& inputs,
+           std::vector<std::shared_ptr<Bucket>> const& shadows,
+           MergeRange const& range, Bucket::OutputIterator& out)
+{
+    InputIterators ins;
+    std::vector<ShadowCursor> shadowCursors;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        ins.emplace_back(make_unique<Bucket::InputIterator>(inputs[i]));
+        if (!range.mInputStarts.empty())
+        {
+            ins.back()->seek(range.mInputStarts[i]);
+        }
+    }
+    for (size_t i = 0; i < shadows.size(); ++i)
+    {
+        ShadowCursor cursor;
+        cursor.mIter = make_unique<Bucket::InputIterator>(shadows[i]);
+        cursor.mIndex = shadows[i]->getIndex();
+        if (!range.mShadowStarts.empty())
+        {
+            cursor.mIter->seek(range.mShadowStarts[i]);
+        }
+        shadowCursors.emplace_back(std::move(cursor));
+    }
+
+    BucketEntryIdCmp cmp;
+    for (;;)
+    {
+        // Find the input with the least next key; on equal keys the newest
+        // input wins.
+        Bucket::InputIterator* best = nullptr;
+        for (auto& in : ins)
+        {
+            if (*in && (!best || !cmp(**best, **in)))
+            {
+                best = in.get();
+            }
+        }
+        if (!best || (range.mUpper && !cmp(**best, *range.mUpper)))
+        {
+            break;
+        }
+
+        maybe_put(cmp, out, **best, shadowCursors);
+
+        // Step every older input holding the same key past it, then the
+        // winner itself.
+        for (auto& in : ins)
+        {
+            if (in.get() != best && *in && !cmp(**best, **in))
+            {
+                ++(*in);
+            }
+        }
+        ++(*best);
+    }
+}
+
+static BucketEntry
+readEntryAt(XDRInputFileStream& in, std::streamoff offset)
+{
+    BucketEntry e;
+    in.seek(offset);
+    if (!in.readOne(e))
+    {
+        throw std::runtime_error("failed to read bucket entry");
+    }
+    return e;
+}
+
+// Offset of the first entry in the bucket file that is not less than `key`.
+// The index narrows the search down to one page, so this reads at most a
+// page of the file.
+static std::streamoff
+lowerBoundOffset(std::string const& filename, BucketIndex const& index,
+                 BucketEntry const& key)
+{
+    std::streamoff begin, end;
+    if (!index.findPage(BucketIndex::getKey(key), begin, end))
+    {
+        // The key comes before the first entry.
+        return index.pageOffset(0);
+    }
+    XDRInputFileStream in(0, kProbeBufferSize);
+    in.open(filename);
+    in.seek(begin);
+    BucketEntryIdCmp cmp;
+    BucketEntry e;
+    for (std::streamoff off = begin; off < end; off = in.pos())
+    {
+        if (!in.readOne(e))
+        {
+            throw std::runtime_error("failed to read bucket entry");
+        }
+        if (!cmp(e, key))
+        {
+            return off;
+        }
+    }
+    return end;
+}
+
+// Split the key space into at most `nParts` ranges holding about the same
+// number of pages of the largest input. The split keys are the first entries
+// of evenly spaced pages of its index, so planning reads one entry per split
+// and at most a page of each bucket per split, however large the buckets.
+// Returns fewer than 2 ranges if the merge is too small to split.
+static std::vector<MergeRange>
+planMergeRanges(std::vector<std::shared_ptr<Bucket>> const& inputs,
+                std::vector<std::shared_ptr<Bucket>> const& shadows,
+                size_t nParts)
+{
+    std::vector<std::shared_ptr<BucketIndex const>> inputIndexes,
+        shadowIndexes;
+    size_t largest = 0;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        inputIndexes.emplace_back(inputs[i]->getIndex());
+        if (inputIndexes[i]->numPages() > inputIndexes[largest]->numPages())
+        {
+            largest = i;
+        }
+    }
+    for (auto const& b : shadows)
+    {
+        shadowIndexes.emplace_back(b->getIndex());
+    }
+
+    std::vector<MergeRange> ranges;
+    auto const& splitIndex = *inputIndexes[largest];
+    nParts = std::min(nParts, splitIndex.numPages());
+    if (nParts < 2)
+    {
+        return ranges;
+    }
+
+    XDRInputFileStream in(0, kProbeBufferSize);
+    in.open(inputs[largest]->getFilename());
+    ranges.resize(nParts);
+    for (size_t p = 1; p < nParts; ++p)
+    {
+        auto page = p * splitIndex.numPages() / nParts;
+        auto split = std::make_shared<BucketEntry>(
+            readEntryAt(in, splitIndex.pageOffset(page)));
+        ranges[p - 1].mUpper = split;
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            ranges[p].mInputStarts.push_back(lowerBoundOffset(
+                inputs[i]->getFilename(), *inputIndexes[i], *split));
+        }
+        for (size_t i = 0; i < shadows.size(); ++i)
+        {
+            ranges[p].mShadowStarts.push_back(lowerBoundOffset(
+                shadows[i]->getFilename(), *shadowIndexes[i], *split));
+        }
+    }
+    return ranges;
+}
+
+static size_t
+defaultMergeParts(std::vector<std::shared_ptr<Bucket>> const& inputs)
+{
+    size_t bytes = 0;
+    for (auto const& b : inputs)
+    {
+        std::ifstream in(b->getFilename(),
+                         std::ifstream::ate | std::ifstream::binary);
+        bytes += static_cast<size_t>(in.tellg());
+    }
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    return std::min(cores, bytes / kMinBytesPerMergePart);
+}
+
+// Concatenate the part files of a parallel merge in key order, hashing them
+// as they are copied, and adopt the result as a bucket.
+static std::shared_ptr<Bucket>
+concatenateParts(BucketManager& bucketManager,
+                 std::vector<MergePartResult> const& parts)
+{
+    size_t nObjects = 0, nBytes = 0;
+    for (auto const& p : parts)
+    {
+        nObjects += p.mObjects;
+        nBytes += p.mBytes;
+    }
+    if (nObjects == 0)
+    {
+        for (auto const& p : parts)
+        {
+            std::remove(p.mFilename.c_str());
+        }
+        return std::make_shared<Bucket>();
+    }
+
+    auto filename = randomBucketName(bucketManager.getTmpDir());
+    CLOG(TRACE, "Bucket") << "Concatenating " << parts.size()
+                          << " merged parts into " << filename;
+    std::ofstream out(filename, std::ofstream::binary | std::ofstream::trunc);
+    auto hasher = SHA256::create();
+    auto index = std::make_shared<BucketIndex>();
+    std::streamoff shift = 0;
+    std::vector<char> buf(1024 * 1024);
+    for (auto const& p : parts)
+    {
+        index->append(*p.mIndex, shift);
+        shift += static_cast<std::streamoff>(p.mBytes);
+        std::ifstream in(p.mFilename, std::ifstream::binary);
+        while (in)
+        {
+            in.read(buf.data(), buf.size());
+            auto n = static_cast<size_t>(in.gcount());
+            hasher->add(ByteSlice(buf.data(), n));
+            out.write(buf.data(), n);
+        }
+        in.close();
+        std::remove(p.mFilename.c_str());
+    }
+    out.close();
+    if (!out)
+    {
+        throw std::runtime_error("failed to write bucket file " + filename);
+    }
+    index->noteEnd(shift);
+    return adoptWithIndex(bucketManager, filename, hasher->finish(),
+                          nObjects, nBytes, index);
 }
 
 std::shared_ptr<Bucket>
@@ -356,52 +829,97 @@ Bucket::merge(BucketManager& bucketManager,
 
     assert(oldBucket);
     assert(newBucket);
+    return mergeMany(bucketManager, {oldBucket, newBucket}, shadows,
+                     keepDeadEntries);
+}
 
-    Bucket::InputIterator oi(oldBucket);
-    Bucket::InputIterator ni(newBucket);
-
-    std::vector<Bucket::InputIterator> shadowIterators(shadows.begin(),
-                                                       shadows.end());
+std::shared_ptr<Bucket>
+Bucket::mergeMany(BucketManager& bucketManager,
+                  std::vector<std::shared_ptr<Bucket>> const& inputs,
+                  std::vector<std::shared_ptr<Bucket>> const& shadows,
+                  bool keepDeadEntries, size_t nParts)
+{
+    // Empty buckets have no file and contribute nothing.
+    std::vector<std::shared_ptr<Bucket>> ins, shs;
+    auto nonEmpty = [](std::shared_ptr<Bucket> const& b) {
+        assert(b);
+        return !b->getFilename().empty();
+    };
+    std::copy_if(inputs.begin(), inputs.end(), std::back_inserter(ins),
+                 nonEmpty);
+    std::copy_if(shadows.begin(), shadows.end(), std::back_inserter(shs),
+                 nonEmpty);
 
     auto timer = bucketManager.getMergeTimer().TimeScope();
-    Bucket::OutputIterator out(bucketManager.getTmpDir(), keepDeadEntries);
+    auto const& tmpDir = bucketManager.getTmpDir();
 
-    BucketEntryIdCmp cmp;
-    while (oi || ni)
+    if (nParts == 0)
     {
-        if (!ni)
-        {
-            // Out of new entries, take old entries.
-            maybe_put(cmp, out, oi, shadowIterators);
-            ++oi;
-        }
-        else if (!oi)
-        {
-            // Out of old entries, take new entries.
-            maybe_put(cmp, out, ni, shadowIterators);
-            ++ni;
-        }
-        else if (cmp(*oi, *ni))
+        nParts = defaultMergeParts(ins);
+    }
+    std::vector<MergeRange> ranges;
+    if (nParts > 1 && !ins.empty())
+    {
+        ranges = planMergeRanges(ins, shs, nParts);
+    }
+    if (ranges.size() < 2)
+    {
+        Bucket::OutputIterator out(tmpDir, keepDeadEntries);
+        mergeRange(ins, shs, MergeRange(), out);
+        return out.getBucket(bucketManager);
+    }
+
+    CLOG(DEBUG, "Bucket") << "Merging " << ins.size() << " buckets in "
+                          << ranges.size() << " parts";
+
+    std::vector<std::shared_ptr<MergePart>> parts;
+    std::vector<std::future<MergePartResult>> futures;
+    for (auto const& range : ranges)
+    {
+        auto part = std::make_shared<MergePart>();
+        part->mTask = std::packaged_task<MergePartResult()>([&]() {
+            Bucket::OutputIterator out(tmpDir, keepDeadEntries, false);
+            mergeRange(ins, shs, range, out);
+            MergePartResult res;
+            res.mFilename = out.finishPart(res.mObjects, res.mBytes);
+            res.mIndex = out.getIndex();
+            return res;
+        });
+        futures.emplace_back(part->mTask.get_future());
+        parts.emplace_back(part);
+    }
+    for (size_t i = 1; i < parts.size(); ++i)
+    {
+        auto part = parts[i];
+        bucketManager.getWorkerIOService().post([part]() { part->run(); });
+    }
+    for (auto& part : parts)
+    {
+        part->run();
+    }
+
+    std::vector<MergePartResult> results;
+    std::exception_ptr error;
+    for (auto& f : futures)
+    {
+        try
         {
-            // Next old-entry has smaller key, take it.
-            maybe_put(cmp, out, oi, shadowIterators);
-            ++oi;
+            results.emplace_back(f.get());
         }
-        else if (cmp(*ni, *oi))
+        catch (...)
         {
-            // Next new-entry has smaller key, take it.
-            maybe_put(cmp, out, ni, shadowIterators);
-            ++ni;
+            error = std::current_exception();
         }
-        else
+    }
+    if (error)
+    {
+        for (auto const& r : results)
         {
-            // Old and new are for the same key, take new.
-            maybe_put(cmp, out, ni, shadowIterators);
-            ++oi;
-            ++ni;
+            std::remove(r.mFilename.c_str());
         }
+        std::rethrow_exception(error);
     }
-    return out.getBucket(bucketManager);
+    return concatenateParts(bucketManager, results);
 }
 
 static void
@@ -453,17 +971,13 @@ checkDBAgainstBuckets(medida::MetricsRegistry& metrics,
         return;
     }
 
-    // Step 2: merge all buckets into a single super-bucket.
-    auto i = buckets.begin();
-    assert(i != buckets.end());
-    std::shared_ptr<Bucket> superBucket = *i;
-    while (++i != buckets.end())
+    // Step 2: merge all buckets into a single super-bucket, oldest first.
+    std::shared_ptr<Bucket> superBucket;
     {
         auto mergeTimer =
             metrics.NewTimer({"bucket", "checkdb", "merge"}).TimeScope();
-        assert(superBucket);
-        assert(*i);
-        superBucket = Bucket::merge(bucketManager, *i, superBucket);
+        std::reverse(buckets.begin(), buckets.end());
+        superBucket = Bucket::mergeMany(bucketManager, buckets);
         assert(superBucket);
     }
 
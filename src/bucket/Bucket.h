@@ -4,11 +4,13 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include "bucket/BucketIndex.h"
 #include "bucket/LedgerCmp.h"
 #include "crypto/Hex.h"
 #include "overlay/StellarXDR.h"
 #include "util/NonCopyable.h"
 #include "util/XDRStream.h"
+#include <mutex>
 #include <string>
 
 namespace medida
@@ -42,6 +44,10 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
     Hash const mHash;
     bool mRetain{false};
 
+    // Index over the bucket's entries, loaded or built on first use.
+    mutable std::mutex mIndexMutex;
+    mutable std::shared_ptr<BucketIndex const> mIndex;
+
   public:
     // Helper class that reads through the entries in a bucket.
     class InputIterator
@@ -54,6 +60,7 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
         BucketEntry const* mEntryPtr;
         XDRInputFileStream mIn;
         BucketEntry mEntry;
+        std::streamoff mEntryOffset{0};
 
         void loadEntry();
 
@@ -67,6 +74,13 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
         ~InputIterator();
 
         InputIterator& operator++();
+
+        // Offset of the current entry in the bucket file.
+        std::streamoff getOffset() const;
+
+        // Reposition the iterator at the record starting at `offset` in the
+        // bucket file, which must be a record boundary.
+        void seek(std::streamoff offset);
     };
 
     // Helper class that writes new elements to a file and returns a bucket
@@ -78,16 +92,34 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
         BucketEntryIdCmp mCmp;
         std::unique_ptr<BucketEntry> mBuf;
         std::unique_ptr<SHA256> mHasher;
+        std::shared_ptr<BucketIndex> mIndex;
         size_t mBytesPut{0};
         size_t mObjectsPut{0};
         bool mKeepDeadEntries{true};
 
+        void writeBuffered();
+
+        // Close the file, throwing if any of it failed to reach the disk.
+        void closeOutput();
+
       public:
-        OutputIterator(std::string const& tmpDir, bool keepDeadEntries);
+        // If `hashEntries` is false the output is not hashed and can only be
+        // finished with `finishPart`.
+        OutputIterator(std::string const& tmpDir, bool keepDeadEntries,
+                       bool hashEntries = true);
 
         void put(BucketEntry const& e);
 
         std::shared_ptr<Bucket> getBucket(BucketManager& bucketManager);
+
+        // Flush and close the output without adopting it as a bucket, for
+        // files that will be concatenated with others. Returns the filename
+        // and adds the number of objects and bytes written to `nObjects` and
+        // `nBytes`.
+        std::string finishPart(size_t& nObjects, size_t& nBytes);
+
+        // The index over the entries written so far.
+        std::shared_ptr<BucketIndex> getIndex() const;
     };
 
     // Create an empty bucket. The empty bucket has hash '000000...' and its
@@ -114,8 +146,19 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
     // be retained.
     void setRetain(bool r);
 
+    // Returns the bucket's index, loading it from its sidecar file or building
+    // it from the bucket file if this is the first use.
+    std::shared_ptr<BucketIndex const> getIndex() const;
+
+    // Sets the bucket's index if it has none yet.
+    void setIndex(std::shared_ptr<BucketIndex const> index) const;
+
+    // Looks up the entry (live or dead) with the given key, reading only the
+    // index page that can hold it. Returns false if there is none.
+    bool getEntry(LedgerKey const& key, BucketEntry& entry) const;
+
     // Returns true if a BucketEntry that is key-wise identical to the given
-    // BucketEntry exists in the bucket. For testing.
+    // BucketEntry exists in the bucket.
     bool containsBucketIdentity(BucketEntry const& id) const;
 
     // Return the count of live and dead BucketEntries in the bucket. For
@@ -147,6 +190,22 @@ class Bucket : public std::enable_shared_from_this<Bucket>,
           std::vector<std::shared_ptr<Bucket>> const& shadows =
               std::vector<std::shared_ptr<Bucket>>(),
           bool keepDeadEntries = true);
+
+    // Merge any number of buckets together in a single pass, producing a fresh
+    // one. `inputs` are ordered oldest-first: entries in each bucket override
+    // keywise-equal entries in all buckets before it. Shadows and dead entries
+    // are handled as in `merge`.
+    //
+    // Large merges are split into `nParts` disjoint key ranges that are merged
+    // concurrently into separate files, then concatenated and hashed in key
+    // order; the result is identical to a single-threaded merge. If `nParts`
+    // is 0 it is chosen from the size of the inputs and the number of cores.
+    static std::shared_ptr<Bucket>
+    mergeMany(BucketManager& bucketManager,
+              std::vector<std::shared_ptr<Bucket>> const& inputs,
+              std::vector<std::shared_ptr<Bucket>> const& shadows =
+                  std::vector<std::shared_ptr<Bucket>>(),
+              bool keepDeadEntries = true, size_t nParts = 0);
 };
 
 void checkDBAgainstBuckets(medida::MetricsRegistry& metrics,
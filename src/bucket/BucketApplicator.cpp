@@ -5,53 +5,100 @@
 #include "util/asio.h"
 #include "bucket/BucketApplicator.h"
 #include "bucket/Bucket.h"
-#include "ledger/LedgerDelta.h"
+#include "ledger/EntryFrame.h"
+#include "ledger/OrderBook.h"
 #include "util/Logging.h"
+#include <map>
 
 namespace stellar
 {
 
 BucketApplicator::BucketApplicator(Database& db,
-                                   std::shared_ptr<const Bucket> bucket)
-    : mDb(db), mBucketIter(bucket)
+                                   std::shared_ptr<const Bucket> bucket,
+                                   size_t batchSize)
+    : mDb(db)
+    , mSession(db.getSession())
+    , mBucketIter(bucket)
+    , mBatchSize(batchSize)
 {
+    assert(mBatchSize > 0);
+}
+
+BucketApplicator::BucketApplicator(Database& db, soci::session& sess,
+                                   std::shared_ptr<const Bucket> bucket,
+                                   size_t batchSize, std::streamoff begin,
+                                   std::streamoff end)
+    : mDb(db)
+    , mSession(sess)
+    , mBucketIter(bucket)
+    , mBatchSize(batchSize)
+    , mEnd(end)
+{
+    assert(mBatchSize > 0);
+    mBucketIter.seek(begin);
 }
 
 BucketApplicator::operator bool() const
 {
-    return (bool)mBucketIter;
+    return mBucketIter && (mEnd < 0 || mBucketIter.getOffset() < mEnd);
 }
 
 void
 BucketApplicator::advance()
 {
-    soci::transaction sqlTx(mDb.getSession());
-    for (; mBucketIter; ++mBucketIter)
+    // Entries of a bucket have distinct keys, so each batch can be split by
+    // type and written in any order.
+    bool mainSession = &mSession == &mDb.getSession();
+    std::map<LedgerEntryType, std::vector<LedgerEntry>> live;
+    std::map<LedgerEntryType, std::vector<LedgerKey>> dead;
+    size_t n = 0;
+    for (; *this && n < mBatchSize; ++mBucketIter, ++n)
     {
-        LedgerHeader lh;
-        LedgerDelta delta(lh, mDb, false);
-
         auto const& entry = *mBucketIter;
+        auto key = entry.type() == LIVEENTRY ? LedgerEntryKey(entry.liveEntry())
+                                             : entry.deadEntry();
+        if (mainSession)
+        {
+            EntryFrame::flushCachedEntry(key, mDb);
+        }
         if (entry.type() == LIVEENTRY)
         {
-            EntryFrame::pointer ep = EntryFrame::FromXDR(entry.liveEntry());
-            ep->storeAddOrChange(delta, mDb);
+            live[key.type()].emplace_back(entry.liveEntry());
         }
         else
         {
-            EntryFrame::storeDelete(delta, mDb, entry.deadEntry());
+            dead[key.type()].emplace_back(key);
         }
-        // No-op, just to avoid needless rollback.
-        delta.commit();
-        if ((++mSize & 0xff) == 0xff)
+    }
+
+    soci::transaction sqlTx(mSession);
+    if (!mainSession && !mDb.isSqlite())
+    {
+        // Concurrent appliers write disjoint rows, so they don't need (and
+        // would only suffer spurious serialization failures from) the
+        // serializable isolation pool sessions default to.
+        mSession << "SET TRANSACTION ISOLATION LEVEL READ COMMITTED";
+    }
+    for (auto type : {ACCOUNT, TRUSTLINE, OFFER, DATA})
+    {
+        if (live.count(type) != 0 || dead.count(type) != 0)
         {
-            break;
+            EntryFrame::storeBulk(mDb, mSession, type, live[type], dead[type]);
         }
     }
     sqlTx.commit();
-    mDb.clearPreparedStatementCache();
+    if (mainSession)
+    {
+        mDb.clearPreparedStatementCache();
+        if (live.count(OFFER) != 0 || dead.count(OFFER) != 0)
+        {
+            mDb.getOrderBook().clear();
+        }
+    }
 
-    if (!mBucketIter || (mSize & 0xfff) == 0xfff)
+    size_t before = mSize;
+    mSize += n;
+    if (!mBucketIter || (before >> 12) != (mSize >> 12))
     {
         CLOG(INFO, "Bucket")
             << "Bucket-apply: committed " << mSize << " entries";
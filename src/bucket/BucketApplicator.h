@@ -17,15 +17,36 @@ class Database;
 // Class that represents a single apply-bucket-to-database operation in
 // progress. Used during history catchup to split up the task of applying
 // bucket into scheduler-friendly, bite-sized pieces.
+//
+// Each piece is a batch of up to `batchSize` entries, written in one
+// transaction: entries are grouped by type and the rows of each type are
+// replaced with a few bulk statements, rather than queried and written one
+// entry at a time.
 
 class BucketApplicator
 {
     Database& mDb;
+    soci::session& mSession;
     Bucket::InputIterator mBucketIter;
+    size_t mBatchSize;
+    // Offset in the bucket file at which to stop, or -1 for the end.
+    std::streamoff mEnd{-1};
     size_t mSize{0};
 
   public:
-    BucketApplicator(Database& db, std::shared_ptr<const Bucket> bucket);
+    static const size_t kDefaultBatchSize = 1024;
+
+    BucketApplicator(Database& db, std::shared_ptr<const Bucket> bucket,
+                     size_t batchSize = kDefaultBatchSize);
+
+    // Apply only the entries of the bucket file in [begin, end), which must
+    // be record boundaries, through `sess`. `sess` may be a session borrowed
+    // from the connection pool by a worker thread, so that disjoint ranges of
+    // a bucket can be applied concurrently; the entry cache is then left
+    // alone and must be cleared by the caller.
+    BucketApplicator(Database& db, soci::session& sess,
+                     std::shared_ptr<const Bucket> bucket, size_t batchSize,
+                     std::streamoff begin, std::streamoff end);
     operator bool() const;
     void advance();
 };
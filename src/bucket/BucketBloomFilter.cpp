@@ -0,0 +1,64 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "bucket/BucketBloomFilter.h"
+#include "crypto/ShortHash.h"
+#include "xdrpp/marshal.h"
+
+namespace stellar
+{
+
+const size_t BucketBloomFilter::kBitsPerKey = 10;
+const uint32_t BucketBloomFilter::kNumHashes = 7;
+
+uint64_t
+BucketBloomFilter::hashKey(LedgerKey const& key)
+{
+    return shortHash(xdr::xdr_to_opaque(key));
+}
+
+BucketBloomFilter::BucketBloomFilter(std::vector<uint64_t> const& keyHashes)
+    : mBits((keyHashes.size() * kBitsPerKey + 63) / 64 + 1, 0)
+    , mNumHashes(kNumHashes)
+{
+    uint64_t nBits = mBits.size() * 64;
+    for (auto h : keyHashes)
+    {
+        uint64_t h1 = h & 0xffffffff;
+        uint64_t h2 = (h >> 32) | 1;
+        for (uint32_t i = 0; i < mNumHashes; ++i)
+        {
+            uint64_t bit = (h1 + i * h2) % nBits;
+            mBits[bit / 64] |= (uint64_t(1) << (bit % 64));
+        }
+    }
+}
+
+BucketBloomFilter::BucketBloomFilter(std::vector<uint64_t> bits,
+                                     uint32_t numHashes)
+    : mBits(std::move(bits)), mNumHashes(numHashes)
+{
+}
+
+bool
+BucketBloomFilter::mayContain(uint64_t keyHash) const
+{
+    if (mBits.empty())
+    {
+        return true;
+    }
+    uint64_t nBits = mBits.size() * 64;
+    uint64_t h1 = keyHash & 0xffffffff;
+    uint64_t h2 = (keyHash >> 32) | 1;
+    for (uint32_t i = 0; i < mNumHashes; ++i)
+    {
+        uint64_t bit = (h1 + i * h2) % nBits;
+        if ((mBits[bit / 64] & (uint64_t(1) << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
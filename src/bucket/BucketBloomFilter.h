@@ -0,0 +1,62 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/StellarXDR.h"
+#include <cstdint>
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * A Bloom filter over the keys of a bucket, so that lookups and shadow checks
+ * can skip buckets that certainly don't hold a key without reading them. Keys
+ * are hashed once, with `hashKey`, and the probe positions are derived from
+ * the two halves of that hash.
+ *
+ * A default-constructed filter holds no bits and may contain every key.
+ */
+class BucketBloomFilter
+{
+    std::vector<uint64_t> mBits;
+    uint32_t mNumHashes{0};
+
+  public:
+    // With 10 bits per key and 7 probes the false-positive rate is about 1%.
+    static const size_t kBitsPerKey;
+    static const uint32_t kNumHashes;
+
+    static uint64_t hashKey(LedgerKey const& key);
+
+    BucketBloomFilter() = default;
+
+    // Build a filter for the keys with the given hashes.
+    explicit BucketBloomFilter(std::vector<uint64_t> const& keyHashes);
+
+    // Reconstitute a filter saved with `getBits` and `getNumHashes`.
+    BucketBloomFilter(std::vector<uint64_t> bits, uint32_t numHashes);
+
+    bool mayContain(uint64_t keyHash) const;
+
+    bool
+    mayContain(LedgerKey const& key) const
+    {
+        return mayContain(hashKey(key));
+    }
+
+    std::vector<uint64_t> const&
+    getBits() const
+    {
+        return mBits;
+    }
+
+    uint32_t
+    getNumHashes() const
+    {
+        return mNumHashes;
+    }
+};
+}
@@ -0,0 +1,169 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "bucket/BucketIndex.h"
+#include "bucket/LedgerCmp.h"
+#include "ledger/EntryFrame.h"
+#include "util/Logging.h"
+#include "util/XDRStream.h"
+#include "util/types.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace stellar
+{
+
+std::streamoff const BucketIndex::kPageSize = 16 * 1024;
+
+std::string
+BucketIndex::filenameFor(std::string const& bucketFilename)
+{
+    return bucketFilename + ".index";
+}
+
+LedgerKey
+BucketIndex::getKey(BucketEntry const& entry)
+{
+    return entry.type() == LIVEENTRY ? LedgerEntryKey(entry.liveEntry())
+                                     : entry.deadEntry();
+}
+
+std::shared_ptr<BucketIndex>
+BucketIndex::build(std::string const& bucketFilename)
+{
+    CLOG(DEBUG, "Bucket") << "Building index for " << bucketFilename;
+    auto index = std::make_shared<BucketIndex>();
+    XDRInputFileStream in;
+    in.open(bucketFilename);
+    BucketEntry entry;
+    std::streamoff offset = in.pos();
+    while (in.readOne(entry))
+    {
+        index->noteEntry(entry, offset);
+        offset = in.pos();
+    }
+    index->noteEnd(offset);
+    return index;
+}
+
+// The sidecar file is a stream of XDR records: a format version, the size of
+// the bucket file, the number of hashes and the bits of the Bloom filter, then
+// the first key and the offset of each page.
+static const uint32 kIndexFormatVersion = 1;
+
+std::shared_ptr<BucketIndex>
+BucketIndex::load(std::string const& filename)
+{
+    auto index = std::make_shared<BucketIndex>();
+    XDRInputFileStream in;
+    in.open(filename);
+    uint32 version, numHashes;
+    uint64 end, offset;
+    xdr::xvector<uint64> bits;
+    LedgerKey key;
+    if (!in.readOne(version) || version != kIndexFormatVersion)
+    {
+        throw std::runtime_error("unknown bucket index format " + filename);
+    }
+    if (!in.readOne(end) || !in.readOne(numHashes) || !in.readOne(bits))
+    {
+        throw std::runtime_error("malformed bucket index " + filename);
+    }
+    index->mFilter = BucketBloomFilter(std::move(bits), numHashes);
+    while (in.readOne(key))
+    {
+        if (!in.readOne(offset))
+        {
+            throw std::runtime_error("malformed bucket index " + filename);
+        }
+        index->mKeys.emplace_back(key);
+        index->mOffsets.emplace_back(static_cast<std::streamoff>(offset));
+    }
+    index->mEnd = static_cast<std::streamoff>(end);
+    return index;
+}
+
+void
+BucketIndex::save(std::string const& filename) const
+{
+    // Write under a temporary name so a crash never leaves a truncated index
+    // that looks valid.
+    std::string tmp = filename + ".tmp";
+    {
+        XDROutputFileStream out;
+        out.open(tmp);
+        out.writeOne(kIndexFormatVersion);
+        out.writeOne(static_cast<uint64>(mEnd));
+        out.writeOne(mFilter.getNumHashes());
+        xdr::xvector<uint64> bits;
+        bits.assign(mFilter.getBits().begin(), mFilter.getBits().end());
+        out.writeOne(bits);
+        for (size_t i = 0; i < mKeys.size(); ++i)
+        {
+            out.writeOne(mKeys[i]);
+            out.writeOne(static_cast<uint64>(mOffsets[i]));
+        }
+        if (!out.close())
+        {
+            std::remove(tmp.c_str());
+            throw std::runtime_error("failed to write bucket index " + tmp);
+        }
+    }
+    if (rename(tmp.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("failed to rename bucket index " + tmp);
+    }
+}
+
+void
+BucketIndex::noteEntry(BucketEntry const& entry, std::streamoff offset)
+{
+    auto key = getKey(entry);
+    mKeyHashes.emplace_back(BucketBloomFilter::hashKey(key));
+    if (mOffsets.empty() || offset - mOffsets.back() >= kPageSize)
+    {
+        mKeys.emplace_back(std::move(key));
+        mOffsets.emplace_back(offset);
+    }
+}
+
+void
+BucketIndex::noteEnd(std::streamoff end)
+{
+    mEnd = end;
+    mFilter = BucketBloomFilter(mKeyHashes);
+    mKeyHashes.clear();
+    mKeyHashes.shrink_to_fit();
+}
+
+void
+BucketIndex::append(BucketIndex const& other, std::streamoff shift)
+{
+    mKeys.insert(mKeys.end(), other.mKeys.begin(), other.mKeys.end());
+    for (auto off : other.mOffsets)
+    {
+        mOffsets.emplace_back(off + shift);
+    }
+    mKeyHashes.insert(mKeyHashes.end(), other.mKeyHashes.begin(),
+                      other.mKeyHashes.end());
+}
+
+bool
+BucketIndex::findPage(LedgerKey const& key, std::streamoff& begin,
+                      std::streamoff& end) const
+{
+    // The key can only be on the last page starting at or before it.
+    auto i = std::upper_bound(mKeys.begin(), mKeys.end(), key,
+                              LedgerEntryIdCmp());
+    if (i == mKeys.begin())
+    {
+        return false;
+    }
+    size_t page = (i - mKeys.begin()) - 1;
+    begin = mOffsets[page];
+    end = page + 1 < mOffsets.size() ? mOffsets[page + 1] : mEnd;
+    return true;
+}
+}
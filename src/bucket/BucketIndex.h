@@ -0,0 +1,102 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "bucket/BucketBloomFilter.h"
+#include "overlay/StellarXDR.h"
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * BucketIndex is a sparse index over the (sorted) entries of a bucket file: the
+ * file is cut into pages of roughly kPageSize bytes and the index records the
+ * key and file offset of the first entry of each page. Finding an entry then
+ * takes a binary search in memory and a read of a single page.
+ *
+ * The index also holds a Bloom filter over all the bucket's keys, which lets
+ * most lookups of keys the bucket doesn't have return without any I/O.
+ *
+ * Indexes are built as buckets are written, or by scanning a bucket file that
+ * came without one (eg. from a history archive), and are persisted in a
+ * sidecar file next to the bucket, named by `filenameFor`.
+ */
+class BucketIndex
+{
+    std::vector<LedgerKey> mKeys;
+    std::vector<std::streamoff> mOffsets;
+    std::streamoff mEnd{0};
+    BucketBloomFilter mFilter;
+
+    // Hashes of the keys noted so far, until `noteEnd` builds the filter.
+    std::vector<uint64_t> mKeyHashes;
+
+  public:
+    // Number of bucket-file bytes covered by each page of the index.
+    static const std::streamoff kPageSize;
+
+    static std::string filenameFor(std::string const& bucketFilename);
+
+    static LedgerKey getKey(BucketEntry const& entry);
+
+    // Build an index by reading the given bucket file.
+    static std::shared_ptr<BucketIndex>
+    build(std::string const& bucketFilename);
+
+    // Load an index from a sidecar file written by `save`. Throws if the file
+    // is missing or malformed.
+    static std::shared_ptr<BucketIndex> load(std::string const& filename);
+
+    void save(std::string const& filename) const;
+
+    // Note that `entry` was written at `offset`, starting a new page if the
+    // current one is full. Entries must be noted in key order.
+    void noteEntry(BucketEntry const& entry, std::streamoff offset);
+
+    // Note the size of the bucket file once all entries are written, and
+    // build the Bloom filter.
+    void noteEnd(std::streamoff end);
+
+    // Append the pages and keys of an unfinished index over a file that was
+    // concatenated to this one at offset `shift`.
+    void append(BucketIndex const& other, std::streamoff shift);
+
+    // Returns false if the bucket certainly has no entry for the key.
+    bool
+    mayContain(uint64_t keyHash) const
+    {
+        return mFilter.mayContain(keyHash);
+    }
+
+    bool
+    mayContain(LedgerKey const& key) const
+    {
+        return mFilter.mayContain(key);
+    }
+
+    // Find the range [begin, end) of the bucket file that holds `key` if the
+    // bucket has it. Returns false if the bucket can't have it.
+    bool findPage(LedgerKey const& key, std::streamoff& begin,
+                  std::streamoff& end) const;
+
+    size_t
+    numPages() const
+    {
+        return mKeys.size();
+    }
+
+    // File offset of the first entry of `page`, or the size of the bucket
+    // file for `page == numPages()`.
+    std::streamoff
+    pageOffset(size_t page) const
+    {
+        return page < mOffsets.size() ? mOffsets[page] : mEnd;
+    }
+};
+}
@@ -310,6 +310,20 @@ BucketList::getHash() const
     return hsh->finish();
 }
 
+bool
+BucketList::getEntry(LedgerKey const& key, BucketEntry& entry) const
+{
+    for (auto const& lev : mLevels)
+    {
+        if (lev.getCurr()->getEntry(key, entry) ||
+            lev.getSnap()->getEntry(key, entry))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 bool
 BucketList::levelShouldSpill(uint32_t ledger, uint32_t level)
 {
@@ -333,6 +333,11 @@ class BucketList
     // of the concatenation of the hashes of the `curr` and `snap` buckets.
     Hash getHash() const;
 
+    // Look up the newest entry for `key` in the BucketList, consulting each
+    // bucket's Bloom filter before reading it. Returns false if no bucket has
+    // an entry for `key`; otherwise `entry` is either live or dead.
+    bool getEntry(LedgerKey const& key, BucketEntry& entry) const;
+
     // Restart any merges that might be running on background worker threads,
     // merging buckets between levels. This needs to be called after forcing a
     // BucketList to adopt a new state, either at application restart or when
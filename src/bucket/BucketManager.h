@@ -11,6 +11,11 @@
 
 #include "medida/timer_context.h"
 
+namespace asio
+{
+class io_service;
+}
+
 namespace stellar
 {
 
@@ -56,6 +61,9 @@ class BucketManager : NonMovableOrCopyable
 
     virtual medida::Timer& getMergeTimer() = 0;
 
+    // The worker io_service that merges may spread their work across.
+    virtual asio::io_service& getWorkerIOService() = 0;
+
     // Get a reference to a persistent bucket (in the BucketManager's bucket
     // directory), from the BucketManager's shared bucket-set.
     //
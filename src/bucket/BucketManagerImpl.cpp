@@ -3,6 +3,7 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "bucket/BucketManagerImpl.h"
+#include "bucket/BucketIndex.h"
 #include "bucket/BucketList.h"
 #include "crypto/Hex.h"
 #include "history/HistoryManager.h"
@@ -144,6 +145,12 @@ BucketManagerImpl::getMergeTimer()
     return mBucketSnapMerge;
 }
 
+asio::io_service&
+BucketManagerImpl::getWorkerIOService()
+{
+    return mApp.getWorkerIOService();
+}
+
 std::shared_ptr<Bucket>
 BucketManagerImpl::adoptFileAsBucket(std::string const& filename,
                                      uint256 const& hash, size_t nObjects,
@@ -157,6 +164,7 @@ BucketManagerImpl::adoptFileAsBucket(std::string const& filename,
         CLOG(DEBUG, "Bucket") << "Deleting bucket file " << filename
                               << " that is redundant with existing bucket";
         std::remove(filename.c_str());
+        std::remove(BucketIndex::filenameFor(filename).c_str());
     }
     else
     {
@@ -172,6 +180,18 @@ BucketManagerImpl::adoptFileAsBucket(std::string const& filename,
             throw std::runtime_error(err);
         }
 
+        // The index is only an accelerator: if it can't be moved along with
+        // the bucket it will be rebuilt on first use.
+        std::string indexName = BucketIndex::filenameFor(filename);
+        if (fs::exists(indexName) &&
+            rename(indexName.c_str(),
+                   BucketIndex::filenameFor(canonicalName).c_str()) != 0)
+        {
+            CLOG(WARNING, "Bucket") << "Failed to rename bucket index "
+                                    << indexName << ": " << strerror(errno);
+            std::remove(indexName.c_str());
+        }
+
         b = std::make_shared<Bucket>(canonicalName, hash);
         {
             mSharedBuckets.insert(std::make_pair(hash, b));
@@ -8,6 +8,8 @@
 #include "util/asio.h"
 
 #include "bucket/Bucket.h"
+#include "bucket/BucketApplicator.h"
+#include "bucket/BucketIndex.h"
 #include "bucket/BucketList.h"
 #include "bucket/BucketManager.h"
 #include "bucket/BucketManagerImpl.h"
@@ -15,6 +17,7 @@
 #include "crypto/Hex.h"
 #include "database/Database.h"
 #include "herder/LedgerCloseData.h"
+#include "ledger/EntryFrame.h"
 #include "ledger/LedgerManager.h"
 #include "ledger/LedgerTestUtils.h"
 #include "lib/catch.hpp"
@@ -596,6 +599,187 @@ TEST_CASE("merging bucket entries", "[bucket]")
     }
 }
 
+TEST_CASE("merging buckets in parts", "[bucket]")
+{
+    VirtualClock clock;
+    Config const& cfg = getTestConfig();
+    Application::pointer app = createTestApplication(clock, cfg);
+    auto& bm = app->getBucketManager();
+
+    autocheck::generator<bool> flip;
+    std::vector<std::shared_ptr<Bucket>> inputs, shadows;
+    std::vector<LedgerEntry> live(500);
+    for (size_t i = 0; i < 4; ++i)
+    {
+        std::vector<LedgerKey> dead;
+        for (auto& e : live)
+        {
+            // Keep some keys around from one bucket to the next, so that
+            // newer buckets override older ones.
+            if (i == 0 || flip())
+            {
+                e = LedgerTestUtils::generateValidLedgerEntry(10);
+            }
+            if (flip() && flip())
+            {
+                dead.push_back(LedgerEntryKey(e));
+            }
+        }
+        inputs.push_back(Bucket::fresh(bm, live, dead));
+    }
+    std::vector<LedgerKey> noDead;
+    std::vector<LedgerEntry> shadowed(live.begin(), live.begin() + 50);
+    shadows.push_back(Bucket::fresh(bm, shadowed, noDead));
+    // Merges are split at pages of the largest input's index.
+    REQUIRE(inputs[0]->getIndex()->numPages() > 1);
+
+    SECTION("two buckets")
+    {
+        auto serial = Bucket::merge(bm, inputs[0], inputs[1]);
+        for (size_t n : {2, 3, 7, 1000})
+        {
+            auto parallel = Bucket::mergeMany(bm, {inputs[0], inputs[1]}, {},
+                                              true, n);
+            REQUIRE(parallel->getHash() == serial->getHash());
+        }
+    }
+
+    SECTION("many buckets with shadows")
+    {
+        auto serial = Bucket::merge(bm, inputs[0], inputs[1], shadows, false);
+        for (size_t i = 2; i < inputs.size(); ++i)
+        {
+            serial = Bucket::merge(bm, serial, inputs[i], shadows, false);
+        }
+        for (size_t n : {1, 4})
+        {
+            auto parallel = Bucket::mergeMany(bm, inputs, shadows, false, n);
+            REQUIRE(parallel->getHash() == serial->getHash());
+        }
+    }
+}
+
+TEST_CASE("bucket index lookups", "[bucket][bucketindex]")
+{
+    VirtualClock clock;
+    Config const& cfg = getTestConfig();
+    Application::pointer app = createTestApplication(clock, cfg);
+    auto& bm = app->getBucketManager();
+
+    autocheck::generator<std::vector<LedgerKey>> deadGen;
+    auto b = Bucket::fresh(
+        bm, LedgerTestUtils::generateValidLedgerEntries(2000), deadGen(100));
+    auto indexFile = BucketIndex::filenameFor(b->getFilename());
+    REQUIRE(fs::exists(indexFile));
+    REQUIRE(b->getIndex()->numPages() > 1);
+
+    auto keyOf = [](BucketEntry const& e) {
+        return e.type() == LIVEENTRY ? LedgerEntryKey(e.liveEntry())
+                                     : e.deadEntry();
+    };
+
+    SECTION("finds every entry")
+    {
+        BucketEntry found;
+        for (Bucket::InputIterator iter(b); iter; ++iter)
+        {
+            REQUIRE(b->getEntry(keyOf(*iter), found));
+            REQUIRE(xdr::xdr_to_opaque(found) == xdr::xdr_to_opaque(*iter));
+            REQUIRE(b->containsBucketIdentity(*iter));
+        }
+    }
+
+    SECTION("finds no missing entries")
+    {
+        BucketEntry found;
+        for (auto const& e : LedgerTestUtils::generateValidLedgerEntries(100))
+        {
+            REQUIRE(!b->getEntry(LedgerEntryKey(e), found));
+        }
+    }
+
+    SECTION("Bloom filter rules out most missing entries")
+    {
+        size_t falsePositives = 0;
+        auto missing = LedgerTestUtils::generateValidLedgerEntries(1000);
+        for (auto const& e : missing)
+        {
+            if (b->getIndex()->mayContain(LedgerEntryKey(e)))
+            {
+                ++falsePositives;
+            }
+        }
+        REQUIRE(falsePositives < missing.size() / 20);
+    }
+
+    SECTION("persisted and rebuilt indexes agree")
+    {
+        auto loaded = BucketIndex::load(indexFile);
+        auto built = BucketIndex::build(b->getFilename());
+        REQUIRE(loaded->numPages() == b->getIndex()->numPages());
+        REQUIRE(built->numPages() == b->getIndex()->numPages());
+        for (Bucket::InputIterator iter(b); iter; ++iter)
+        {
+            std::streamoff b1, e1, b2, e2, b3, e3;
+            REQUIRE(b->getIndex()->findPage(keyOf(*iter), b1, e1));
+            REQUIRE(loaded->findPage(keyOf(*iter), b2, e2));
+            REQUIRE(built->findPage(keyOf(*iter), b3, e3));
+            REQUIRE(b1 == b2);
+            REQUIRE(b1 == b3);
+            REQUIRE(e1 == e2);
+            REQUIRE(e1 == e3);
+        }
+    }
+}
+
+TEST_CASE("bucket list lookups", "[bucket][bucketindex]")
+{
+    VirtualClock clock;
+    Config const& cfg = getTestConfig();
+    Application::pointer app = createTestApplication(clock, cfg);
+    BucketList bl;
+
+    std::map<LedgerKey, LedgerEntry, LedgerEntryIdCmp> newest;
+    std::vector<LedgerKey> deleted;
+    for (uint32_t i = 1; i < 130; ++i)
+    {
+        auto live = LedgerTestUtils::generateValidLedgerEntries(8);
+        std::vector<LedgerKey> dead;
+        if (i % 10 == 0)
+        {
+            // Delete an entry added earlier, and update another.
+            dead.push_back(newest.begin()->first);
+            deleted.push_back(newest.begin()->first);
+            newest.erase(newest.begin());
+            live.back() = newest.rbegin()->second;
+            live.back().lastModifiedLedgerSeq = i;
+        }
+        bl.addBatch(*app, i, live, dead);
+        for (auto const& e : live)
+        {
+            newest[LedgerEntryKey(e)] = e;
+        }
+    }
+
+    BucketEntry found;
+    for (auto const& kv : newest)
+    {
+        REQUIRE(bl.getEntry(kv.first, found));
+        REQUIRE(found.type() == LIVEENTRY);
+        REQUIRE(xdr::xdr_to_opaque(found.liveEntry()) ==
+                xdr::xdr_to_opaque(kv.second));
+    }
+    for (auto const& k : deleted)
+    {
+        REQUIRE(bl.getEntry(k, found));
+        REQUIRE(found.type() == DEADENTRY);
+    }
+    for (auto const& e : LedgerTestUtils::generateValidLedgerEntries(100))
+    {
+        REQUIRE(!bl.getEntry(LedgerEntryKey(e), found));
+    }
+}
+
 static void
 clearFutures(Application::pointer app, BucketList& bl)
 {
@@ -1109,6 +1293,69 @@ TEST_CASE("bucket apply", "[bucket]")
     REQUIRE(count == 1);
 }
 
+TEST_CASE("bucket apply in batches", "[bucket]")
+{
+    VirtualClock clock;
+    Config cfg(getTestConfig());
+    Application::pointer app = createTestApplication(clock, cfg);
+    app->start();
+    auto& db = app->getDatabase();
+
+    auto apply = [&](std::shared_ptr<Bucket> b) {
+        BucketApplicator applicator(db, b, 7);
+        while (applicator)
+        {
+            applicator.advance();
+        }
+    };
+    auto check = [&](LedgerEntry const& e) {
+        REQUIRE(EntryFrame::checkAgainstDatabase(e, db) == "");
+    };
+
+    auto entries = LedgerTestUtils::generateValidLedgerEntries(200);
+    std::vector<LedgerKey> noDead;
+    apply(Bucket::fresh(app->getBucketManager(), entries, noDead));
+    for (auto const& e : entries)
+    {
+        check(e);
+    }
+
+    // Rewrite some entries over existing rows, delete some and leave the
+    // rest alone.
+    std::vector<LedgerEntry> changed;
+    std::vector<LedgerKey> dead;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        auto& e = entries[i];
+        if (i % 4 == 0)
+        {
+            dead.emplace_back(LedgerEntryKey(e));
+        }
+        else if (i % 4 == 1)
+        {
+            e.lastModifiedLedgerSeq = 42;
+            if (e.data.type() == ACCOUNT &&
+                !e.data.account().signers.empty())
+            {
+                e.data.account().signers.pop_back();
+            }
+            changed.emplace_back(e);
+        }
+    }
+    apply(Bucket::fresh(app->getBucketManager(), changed, dead));
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i % 4 == 0)
+        {
+            REQUIRE(!EntryFrame::storeLoad(dead[i / 4], db));
+        }
+        else
+        {
+            check(entries[i]);
+        }
+    }
+}
+
 #ifdef USE_POSTGRES
 TEST_CASE("bucket apply bench", "[bucketbench][hide]")
 {
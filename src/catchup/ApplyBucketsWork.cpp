@@ -31,10 +31,10 @@ ApplyBucketsWork::ApplyBucketsWork(
     std::map<std::string, std::shared_ptr<Bucket>> const& buckets,
     HistoryArchiveState const& applyState)
     : Work(app, parent, std::string("apply-buckets"))
-    , mBuckets(buckets)
-    , mApplyState(applyState)
     , mApplying(false)
     , mLevel(BucketList::kNumLevels - 1)
+    , mBuckets(buckets)
+    , mApplyState(applyState)
     , mBucketApplyStart(app.getMetrics().NewMeter(
           {"history", "bucket-apply", "start"}, "event"))
     , mBucketApplySuccess(app.getMetrics().NewMeter(
@@ -55,10 +55,10 @@ ApplyBucketsWork::getBucketLevel(uint32_t level)
     return mApp.getBucketManager().getBucketList().getLevel(level);
 }
 
-std::shared_ptr<Bucket const>
+std::shared_ptr<Bucket>
 ApplyBucketsWork::getBucket(std::string const& hash)
 {
-    std::shared_ptr<Bucket const> b;
+    std::shared_ptr<Bucket> b;
     if (isZero(hexToBin256(hash)))
     {
         b = std::make_shared<Bucket>();
@@ -79,6 +79,16 @@ ApplyBucketsWork::getBucket(std::string const& hash)
     return b;
 }
 
+void
+ApplyBucketsWork::deleteEntriesModifiedOnOrAfter(uint32_t oldestLedger)
+{
+    auto& db = mApp.getDatabase();
+    AccountFrame::deleteAccountsModifiedOnOrAfterLedger(db, oldestLedger);
+    TrustFrame::deleteTrustLinesModifiedOnOrAfterLedger(db, oldestLedger);
+    OfferFrame::deleteOffersModifiedOnOrAfterLedger(db, oldestLedger);
+    DataFrame::deleteDataModifiedOnOrAfterLedger(db, oldestLedger);
+}
+
 void
 ApplyBucketsWork::onReset()
 {
@@ -105,21 +115,15 @@ ApplyBucketsWork::onStart()
                                           mApplyState.currentLedger, mLevel)
                                     : BucketList::oldestLedgerInCurr(
                                           mApplyState.currentLedger, mLevel);
-        AccountFrame::deleteAccountsModifiedOnOrAfterLedger(mApp.getDatabase(),
-                                                            oldestLedger);
-        TrustFrame::deleteTrustLinesModifiedOnOrAfterLedger(mApp.getDatabase(),
-                                                            oldestLedger);
-        OfferFrame::deleteOffersModifiedOnOrAfterLedger(mApp.getDatabase(),
-                                                        oldestLedger);
-        DataFrame::deleteDataModifiedOnOrAfterLedger(mApp.getDatabase(),
-                                                     oldestLedger);
+        deleteEntriesModifiedOnOrAfter(oldestLedger);
     }
 
     if (mApplying || applySnap)
     {
         mSnapBucket = getBucket(i.snap);
-        mSnapApplicator =
-            make_unique<BucketApplicator>(mApp.getDatabase(), mSnapBucket);
+        mSnapApplicator = make_unique<BucketApplicator>(
+            mApp.getDatabase(), mSnapBucket,
+            mApp.getConfig().BUCKET_APPLY_BATCH_SIZE);
         CLOG(DEBUG, "History") << "ApplyBuckets : starting level[" << mLevel
                                << "].snap = " << i.snap;
         mApplying = true;
@@ -128,8 +132,9 @@ ApplyBucketsWork::onStart()
     if (mApplying || applyCurr)
     {
         mCurrBucket = getBucket(i.curr);
-        mCurrApplicator =
-            make_unique<BucketApplicator>(mApp.getDatabase(), mCurrBucket);
+        mCurrApplicator = make_unique<BucketApplicator>(
+            mApp.getDatabase(), mCurrBucket,
+            mApp.getConfig().BUCKET_APPLY_BATCH_SIZE);
         CLOG(DEBUG, "History") << "ApplyBuckets : starting level[" << mLevel
                                << "].curr = " << i.curr;
         mApplying = true;
@@ -23,9 +23,6 @@ struct LedgerHeaderHistoryEntry;
 
 class ApplyBucketsWork : public Work
 {
-    std::map<std::string, std::shared_ptr<Bucket>> const& mBuckets;
-    const HistoryArchiveState& mApplyState;
-
     bool mApplying;
     uint32_t mLevel;
     std::shared_ptr<Bucket const> mSnapBucket;
@@ -33,13 +30,21 @@ class ApplyBucketsWork : public Work
     std::unique_ptr<BucketApplicator> mSnapApplicator;
     std::unique_ptr<BucketApplicator> mCurrApplicator;
 
+  protected:
+    std::map<std::string, std::shared_ptr<Bucket>> const& mBuckets;
+    const HistoryArchiveState& mApplyState;
+
     medida::Meter& mBucketApplyStart;
     medida::Meter& mBucketApplySuccess;
     medida::Meter& mBucketApplyFailure;
 
-    std::shared_ptr<Bucket const> getBucket(std::string const& bucketHash);
+    std::shared_ptr<Bucket> getBucket(std::string const& bucketHash);
     BucketLevel& getBucketLevel(uint32_t level);
 
+    // Remove the entries that buckets covering ledgers from `oldestLedger`
+    // on are about to replace.
+    void deleteEntriesModifiedOnOrAfter(uint32_t oldestLedger);
+
   public:
     ApplyBucketsWork(
         Application& app, WorkParent& parent,
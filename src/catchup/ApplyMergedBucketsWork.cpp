@@ -0,0 +1,261 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "catchup/ApplyMergedBucketsWork.h"
+#include "bucket/Bucket.h"
+#include "bucket/BucketApplicator.h"
+#include "bucket/BucketIndex.h"
+#include "bucket/BucketList.h"
+#include "bucket/BucketManager.h"
+#include "catchup/CatchupManager.h"
+#include "crypto/Hex.h"
+#include "database/Database.h"
+#include "history/HistoryArchive.h"
+#include "invariant/InvariantManager.h"
+#include "ledger/OrderBook.h"
+#include "main/Application.h"
+#include "util/Logging.h"
+#include "util/make_unique.h"
+#include <algorithm>
+#include <atomic>
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
+#include <medida/timer.h>
+#include <thread>
+
+namespace stellar
+{
+
+ApplyMergedBucketsWork::ApplyMergedBucketsWork(
+    Application& app, WorkParent& parent,
+    std::map<std::string, std::shared_ptr<Bucket>> const& buckets,
+    HistoryArchiveState const& applyState)
+    : ApplyBucketsWork(app, parent, buckets, applyState)
+    , mMergeTime(app.getMetrics().NewTimer(
+          {"history", "bucket-apply", "merge-time"}))
+    , mApplyTime(app.getMetrics().NewTimer(
+          {"history", "bucket-apply", "apply-time"}))
+{
+}
+
+ApplyMergedBucketsWork::~ApplyMergedBucketsWork()
+{
+    clearChildren();
+}
+
+void
+ApplyMergedBucketsWork::onReset()
+{
+    ApplyBucketsWork::onReset();
+    mPhase = MERGING;
+    mNumInputs = 0;
+    mOldestLedger = 0;
+    // A fresh result each attempt, so a merge from an abandoned attempt can't
+    // be mistaken for this one's.
+    mMergeResult = std::make_shared<MergeResult>();
+    mMerged.reset();
+    mApplicator.reset();
+}
+
+void
+ApplyMergedBucketsWork::onStart()
+{
+    // Collect every bucket from the oldest one that differs from the local
+    // bucket list onwards, as ApplyBucketsWork would apply them.
+    std::vector<std::shared_ptr<Bucket>> inputs;
+    for (uint32_t i = BucketList::kNumLevels; i-- > 0;)
+    {
+        auto& level = getBucketLevel(i);
+        HistoryStateBucket const& hsb = mApplyState.currentBuckets.at(i);
+        if (!inputs.empty() || hsb.snap != binToHex(level.getSnap()->getHash()))
+        {
+            if (inputs.empty())
+            {
+                mOldestLedger = BucketList::oldestLedgerInSnap(
+                    mApplyState.currentLedger, i);
+            }
+            inputs.emplace_back(getBucket(hsb.snap));
+        }
+        if (!inputs.empty() || hsb.curr != binToHex(level.getCurr()->getHash()))
+        {
+            if (inputs.empty())
+            {
+                mOldestLedger = BucketList::oldestLedgerInCurr(
+                    mApplyState.currentLedger, i);
+            }
+            inputs.emplace_back(getBucket(hsb.curr));
+        }
+    }
+
+    mNumInputs = inputs.size();
+    if (inputs.empty())
+    {
+        mMerged = std::make_shared<Bucket>();
+        mPhase = APPLYING;
+        return;
+    }
+
+    CLOG(INFO, "History") << "ApplyBuckets : merging " << inputs.size()
+                          << " buckets from ledger " << mOldestLedger;
+    deleteEntriesModifiedOnOrAfter(mOldestLedger);
+    mBucketApplyStart.Mark(inputs.size());
+
+    mPhase = MERGING;
+    mPhaseStart = std::chrono::steady_clock::now();
+    Application& app = mApp;
+    auto result = mMergeResult;
+    auto handler = callComplete();
+    app.getWorkerIOService().post([&app, inputs, result, handler]() {
+        asio::error_code ec;
+        try
+        {
+            result->mBucket =
+                Bucket::mergeMany(app.getBucketManager(), inputs);
+        }
+        catch (std::exception const& e)
+        {
+            CLOG(ERROR, "History")
+                << "ApplyBuckets : failed to merge buckets: " << e.what();
+            ec = std::make_error_code(std::errc::io_error);
+        }
+        app.getClock().getIOService().post([ec, handler]() { handler(ec); });
+    });
+}
+
+void
+ApplyMergedBucketsWork::onRun()
+{
+    // While merging or applying in parallel, completion is reported by the
+    // worker threads.
+    if (mPhase == APPLYING)
+    {
+        if (mApplicator && *mApplicator)
+        {
+            mApplicator->advance();
+        }
+        scheduleSuccess();
+    }
+}
+
+void
+ApplyMergedBucketsWork::startApplying()
+{
+    auto& db = mApp.getDatabase();
+    mPhaseStart = std::chrono::steady_clock::now();
+    if (mMerged->getFilename().empty())
+    {
+        mPhase = APPLYING;
+    }
+    else if (!db.isSqlite() && db.canUsePool())
+    {
+        mPhase = APPLYING_IN_PARALLEL;
+        applyInParallel();
+    }
+    else
+    {
+        mPhase = APPLYING;
+        mApplicator = make_unique<BucketApplicator>(
+            db, mMerged, mApp.getConfig().BUCKET_APPLY_BATCH_SIZE);
+    }
+}
+
+void
+ApplyMergedBucketsWork::applyInParallel()
+{
+    auto& db = mApp.getDatabase();
+    // Create the pool here, on the main thread, before workers lease from it.
+    db.getPool();
+
+    auto index = mMerged->getIndex();
+    size_t nPages = std::max<size_t>(index->numPages(), 1);
+    size_t nRanges = std::min<size_t>(
+        std::max(std::thread::hardware_concurrency(), 1u), nPages);
+    CLOG(INFO, "History") << "ApplyBuckets : applying merged bucket in "
+                          << nRanges << " ranges";
+
+    Application& app = mApp;
+    auto bucket = mMerged;
+    auto batchSize = mApp.getConfig().BUCKET_APPLY_BATCH_SIZE;
+    auto remaining = std::make_shared<std::atomic<size_t>>(nRanges);
+    auto failed = std::make_shared<std::atomic<bool>>(false);
+    auto handler = callComplete();
+    for (size_t i = 0; i < nRanges; ++i)
+    {
+        auto begin = index->pageOffset(i * nPages / nRanges);
+        auto end = index->pageOffset((i + 1) * nPages / nRanges);
+        app.getWorkerIOService().post([&app, bucket, batchSize, begin, end,
+                                       remaining, failed, handler]() {
+            auto& db = app.getDatabase();
+            try
+            {
+                soci::session sess(db.getPool());
+                BucketApplicator applicator(db, sess, bucket, batchSize, begin,
+                                            end);
+                while (applicator)
+                {
+                    applicator.advance();
+                }
+            }
+            catch (std::exception const& e)
+            {
+                CLOG(ERROR, "History")
+                    << "ApplyBuckets : failed to apply range [" << begin
+                    << ", " << end << "): " << e.what();
+                *failed = true;
+            }
+            if (--*remaining == 0)
+            {
+                asio::error_code ec;
+                if (*failed)
+                {
+                    ec = std::make_error_code(std::errc::io_error);
+                }
+                app.getClock().getIOService().post(
+                    [ec, handler]() { handler(ec); });
+            }
+        });
+    }
+}
+
+Work::State
+ApplyMergedBucketsWork::onSuccess()
+{
+    mApp.getCatchupManager().logAndUpdateCatchupStatus(true);
+
+    switch (mPhase)
+    {
+    case MERGING:
+        mMergeTime.Update(std::chrono::steady_clock::now() - mPhaseStart);
+        mMerged = mMergeResult->mBucket;
+        startApplying();
+        return WORK_RUNNING;
+    case APPLYING:
+        if (mApplicator && *mApplicator)
+        {
+            return WORK_RUNNING;
+        }
+        break;
+    case APPLYING_IN_PARALLEL:
+        break;
+    }
+
+    if (mNumInputs != 0)
+    {
+        mApplyTime.Update(std::chrono::steady_clock::now() - mPhaseStart);
+        // Entries were replaced wholesale, some by worker threads that can't
+        // flush the entry cache as they go.
+        mApp.getDatabase().getEntryCache().clear();
+        mApp.getDatabase().getOrderBook().clear();
+        mApp.getInvariantManager().checkOnMergedBucketApply(
+            mMerged, mOldestLedger, mApplyState.currentLedger);
+        mBucketApplySuccess.Mark(mNumInputs);
+    }
+    mApplicator.reset();
+    mMerged.reset();
+
+    CLOG(DEBUG, "History") << "ApplyBuckets : done, restarting merges";
+    mApp.getBucketManager().assumeState(mApplyState);
+    return WORK_SUCCESS;
+}
+}
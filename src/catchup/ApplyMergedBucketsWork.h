@@ -0,0 +1,72 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "catchup/ApplyBucketsWork.h"
+#include <chrono>
+
+namespace medida
+{
+class Timer;
+}
+
+namespace stellar
+{
+
+/**
+ * Variant of ApplyBucketsWork used when PARALLEL_BUCKET_APPLY is set.
+ *
+ * Rather than applying each bucket that needs applying in turn, oldest first,
+ * so that newer entries overwrite older ones in the database, it first merges
+ * all those buckets into one (on worker threads) so that only the newest
+ * version of each entry is left, then applies that merged bucket once.
+ *
+ * The merged bucket's entries have distinct keys, so disjoint ranges of it can
+ * be written concurrently: on Postgres they are applied by worker threads over
+ * the database connection pool. On SQLite, which does not support concurrent
+ * writers, the merged bucket is applied on the main thread in batches.
+ */
+class ApplyMergedBucketsWork : public ApplyBucketsWork
+{
+    enum Phase
+    {
+        MERGING,
+        APPLYING,
+        APPLYING_IN_PARALLEL
+    };
+
+    // Written by the merging worker thread before it reports completion.
+    struct MergeResult
+    {
+        std::shared_ptr<Bucket> mBucket;
+    };
+
+    Phase mPhase{MERGING};
+    size_t mNumInputs{0};
+    uint32_t mOldestLedger{0};
+    std::shared_ptr<MergeResult> mMergeResult;
+    std::shared_ptr<Bucket const> mMerged;
+    std::unique_ptr<BucketApplicator> mApplicator;
+    std::chrono::steady_clock::time_point mPhaseStart;
+
+    medida::Timer& mMergeTime;
+    medida::Timer& mApplyTime;
+
+    void startApplying();
+    void applyInParallel();
+
+  public:
+    ApplyMergedBucketsWork(
+        Application& app, WorkParent& parent,
+        std::map<std::string, std::shared_ptr<Bucket>> const& buckets,
+        HistoryArchiveState const& applyState);
+    ~ApplyMergedBucketsWork();
+
+    void onReset() override;
+    void onStart() override;
+    void onRun() override;
+    Work::State onSuccess() override;
+};
+}
@@ -5,7 +5,9 @@
 #include "catchup/CatchupWork.h"
 #include "catchup/ApplyBucketsWork.h"
 #include "catchup/ApplyLedgerChainWork.h"
+#include "catchup/ApplyMergedBucketsWork.h"
 #include "catchup/CatchupConfiguration.h"
+#include "catchup/DownloadApplyTransactionsWork.h"
 #include "catchup/DownloadBucketsWork.h"
 #include "catchup/VerifyLedgerChainWork.h"
 #include "history/FileTransferInfo.h"
@@ -16,6 +18,7 @@
 #include "historywork/VerifyBucketWork.h"
 #include "ledger/LedgerManager.h"
 #include "main/Application.h"
+#include "main/Config.h"
 #include "test/TestPrinter.h"
 #include "util/Logging.h"
 #include <lib/util/format.h>
@@ -258,8 +261,16 @@ CatchupWork::applyBuckets()
 
     CLOG(INFO, "History") << "Catchup applying buckets for state "
                           << LedgerManager::ledgerAbbrev(mFirstVerified);
-    mApplyBucketsWork =
-        addWork<ApplyBucketsWork>(mBuckets, mApplyBucketsRemoteState);
+    if (mApp.getConfig().PARALLEL_BUCKET_APPLY)
+    {
+        mApplyBucketsWork = addWork<ApplyMergedBucketsWork>(
+            mBuckets, mApplyBucketsRemoteState);
+    }
+    else
+    {
+        mApplyBucketsWork =
+            addWork<ApplyBucketsWork>(mBuckets, mApplyBucketsRemoteState);
+    }
 
     return true;
 }
@@ -291,6 +302,18 @@ CatchupWork::applyTransactions(LedgerRange const& range)
         return false;
     }
 
+    auto depth = mApp.getConfig().CATCHUP_PIPELINE_DEPTH;
+    if (depth > 0)
+    {
+        CLOG(INFO, "History")
+            << "Catchup downloading and applying transactions for range ["
+            << range.first() << ".." << range.last() << "], " << depth
+            << " checkpoints ahead";
+        mApplyTransactionsWork = addWork<DownloadApplyTransactionsWork>(
+            *mDownloadDir, range, depth, mLastApplied);
+        return true;
+    }
+
     CLOG(INFO, "History") << "Catchup applying transactions for range ["
                           << range.first() << ".." << range.last() << "]";
 
@@ -369,7 +392,9 @@ CatchupWork::onSuccess()
                               << checkpointRange.first() << " not needed";
     }
 
-    if (downloadTransactions(checkpointRange))
+    // Pipelined catchup downloads transactions as it applies them.
+    if (mApp.getConfig().CATCHUP_PIPELINE_DEPTH == 0 &&
+        downloadTransactions(checkpointRange))
     {
         return WORK_PENDING;
     }
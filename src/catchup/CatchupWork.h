@@ -46,11 +46,15 @@ using CatchupRange = std::pair<LedgerRange, bool>;
 //
 // Next step is downloading and verifying ledgers (if verifyMode is set to
 // VERIFY_BUFFERED_LEDGERS it can also verify against ledgers currently
-// buffered in LedgerManager).
+// buffered in LedgerManager). The whole chain is verified, up to the ledger
+// checked against the network, before anything is applied: a chain that only
+// links up with our last closed ledger could still be made up by the archive.
 //
 // Then, depending on configuration, it can download, verify and apply buckets
 // (as in MINIMAL and RECENT catchups), and then download and apply
-// transactions (as in COMPLETE and RECENT catchups).
+// transactions (as in COMPLETE and RECENT catchups). If CATCHUP_PIPELINE_DEPTH
+// is set, transactions are applied checkpoint by checkpoint as they are
+// downloaded, see DownloadApplyTransactionsWork.
 //
 // After that, catchup is done and node can replay buffered ledgers and take
 // part in consensus protocol.
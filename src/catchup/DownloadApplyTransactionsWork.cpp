@@ -0,0 +1,234 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "catchup/DownloadApplyTransactionsWork.h"
+#include "catchup/ApplyLedgerChainWork.h"
+#include "catchup/CatchupManager.h"
+#include "history/FileTransferInfo.h"
+#include "history/HistoryManager.h"
+#include "historywork/GetAndUnzipRemoteFileWork.h"
+#include "historywork/Progress.h"
+#include "ledger/LedgerManager.h"
+#include "lib/util/format.h"
+#include "main/Application.h"
+#include "main/Config.h"
+#include "util/Fs.h"
+#include "util/Logging.h"
+#include <medida/histogram.h>
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
+
+namespace stellar
+{
+
+DownloadApplyTransactionsWork::DownloadApplyTransactionsWork(
+    Application& app, WorkParent& parent, TmpDir const& downloadDir,
+    LedgerRange range, uint32_t depth, LedgerHeaderHistoryEntry& lastApplied)
+    : Work(app, parent,
+           fmt::format("download-apply-transactions-{:08x}-{:08x}",
+                       range.first(), range.last()))
+    , mDownloadDir(downloadDir)
+    , mRange(range)
+    , mDepth(std::max(depth, 1u))
+    , mLastApplied(lastApplied)
+    , mNextDownload(0)
+    , mNextApply(0)
+    , mDownloadCached(app.getMetrics().NewMeter(
+          {"history", "download-transactions", "cached"}, "event"))
+    , mDownloadStart(app.getMetrics().NewMeter(
+          {"history", "download-transactions", "start"}, "event"))
+    , mDownloadSuccess(app.getMetrics().NewMeter(
+          {"history", "download-transactions", "success"}, "event"))
+    , mDownloadFailure(app.getMetrics().NewMeter(
+          {"history", "download-transactions", "failure"}, "event"))
+    , mCheckpointsApplied(app.getMetrics().NewMeter(
+          {"history", "pipeline", "applied"}, "checkpoint"))
+    , mApplyStall(app.getMetrics().NewMeter(
+          {"history", "pipeline", "apply-stall"}, "event"))
+    , mBuffered(
+          app.getMetrics().NewHistogram({"history", "pipeline", "buffered"}))
+{
+}
+
+DownloadApplyTransactionsWork::~DownloadApplyTransactionsWork()
+{
+    clearChildren();
+}
+
+std::string
+DownloadApplyTransactionsWork::getStatus() const
+{
+    if (mApplyWork)
+    {
+        return mApplyWork->getStatus();
+    }
+    if (mState == WORK_RUNNING || mState == WORK_PENDING)
+    {
+        std::string task = "downloading transactions files";
+        return fmtProgress(mApp, task, mRange.first(), mRange.last(),
+                           mNextApply);
+    }
+    return Work::getStatus();
+}
+
+uint32_t
+DownloadApplyTransactionsWork::lastCheckpoint() const
+{
+    return mApp.getHistoryManager().checkpointContainingLedger(mRange.last());
+}
+
+void
+DownloadApplyTransactionsWork::onReset()
+{
+    clearChildren();
+    mDownloaded.clear();
+    mDownloading.clear();
+    mApplyWork.reset();
+
+    // Start over from the first checkpoint not fully applied.
+    auto& hm = mApp.getHistoryManager();
+    auto lcl = mApp.getLedgerManager().getLastClosedLedgerNum();
+    if (lcl >= mRange.last())
+    {
+        mNextApply = lastCheckpoint() + hm.getCheckpointFrequency();
+    }
+    else
+    {
+        mNextApply =
+            hm.checkpointContainingLedger(std::max(mRange.first(), lcl + 1));
+    }
+    mNextDownload = mNextApply;
+
+    addDownloads();
+    addApply();
+}
+
+void
+DownloadApplyTransactionsWork::addDownloads()
+{
+    auto freq = mApp.getHistoryManager().getCheckpointFrequency();
+    size_t nChildren = mApp.getConfig().MAX_CONCURRENT_SUBPROCESSES;
+    while (mNextDownload <= lastCheckpoint() &&
+           (mNextDownload - mNextApply) / freq < mDepth &&
+           mDownloading.size() < nChildren)
+    {
+        FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_TRANSACTIONS,
+                            mNextDownload);
+        if (fs::exists(ft.localPath_nogz()))
+        {
+            CLOG(DEBUG, "History")
+                << "already have transactions for checkpoint "
+                << mNextDownload;
+            mDownloadCached.Mark();
+            mDownloaded.insert(mNextDownload);
+        }
+        else
+        {
+            CLOG(DEBUG, "History")
+                << "Downloading and unzipping transactions for checkpoint "
+                << mNextDownload;
+            auto getAndUnzip = addWork<GetAndUnzipRemoteFileWork>(ft);
+            mDownloading.insert(
+                std::make_pair(getAndUnzip->getUniqueName(), mNextDownload));
+            mDownloadStart.Mark();
+        }
+        mNextDownload += freq;
+    }
+}
+
+void
+DownloadApplyTransactionsWork::addApply()
+{
+    if (mApplyWork || mNextApply > lastCheckpoint() ||
+        mDownloaded.find(mNextApply) == mDownloaded.end())
+    {
+        return;
+    }
+
+    mBuffered.Update(mDownloaded.size());
+    auto freq = mApp.getHistoryManager().getCheckpointFrequency();
+    LedgerRange range{std::max(mRange.first(), mNextApply + 1 - freq),
+                      std::min(mRange.last(), mNextApply)};
+    CLOG(DEBUG, "History") << "Applying transactions for checkpoint "
+                           << mNextApply;
+    mApplyWork =
+        addWork<ApplyLedgerChainWork>(mDownloadDir, range, mLastApplied);
+}
+
+void
+DownloadApplyTransactionsWork::removeFiles(uint32_t checkpoint)
+{
+    for (auto const& type :
+         {HISTORY_FILE_TYPE_LEDGER, HISTORY_FILE_TYPE_TRANSACTIONS})
+    {
+        FileTransferInfo ft(mDownloadDir, type, checkpoint);
+        std::remove(ft.localPath_nogz().c_str());
+    }
+}
+
+void
+DownloadApplyTransactionsWork::notify(std::string const& child)
+{
+    auto i = mChildren.find(child);
+    if (i == mChildren.end())
+    {
+        CLOG(WARNING, "Work")
+            << "DownloadApplyTransactionsWork notified by unknown child "
+            << child;
+        return;
+    }
+
+    auto state = i->second->getState();
+    if (i->second == mApplyWork)
+    {
+        if (state == WORK_SUCCESS)
+        {
+            CLOG(DEBUG, "History") << "Applied transactions for checkpoint "
+                                   << mNextApply;
+            mCheckpointsApplied.Mark();
+            mDownloaded.erase(mNextApply);
+            removeFiles(mNextApply);
+            mChildren.erase(i);
+            mApplyWork.reset();
+            mNextApply += mApp.getHistoryManager().getCheckpointFrequency();
+            if (mNextApply <= lastCheckpoint() &&
+                mDownloaded.find(mNextApply) == mDownloaded.end())
+            {
+                mApplyStall.Mark();
+            }
+        }
+    }
+    else
+    {
+        switch (state)
+        {
+        case WORK_SUCCESS:
+        {
+            mDownloadSuccess.Mark();
+            auto checkpoint = mDownloading.find(child);
+            assert(checkpoint != mDownloading.end());
+            CLOG(DEBUG, "History")
+                << "Finished download of transactions for checkpoint "
+                << checkpoint->second;
+            mDownloaded.insert(checkpoint->second);
+            mDownloading.erase(checkpoint);
+            mChildren.erase(i);
+            break;
+        }
+        case WORK_FAILURE_RETRY:
+        case WORK_FAILURE_FATAL:
+        case WORK_FAILURE_RAISE:
+            mDownloadFailure.Mark();
+            break;
+        default:
+            break;
+        }
+    }
+
+    addDownloads();
+    addApply();
+    mApp.getCatchupManager().logAndUpdateCatchupStatus(true);
+    advance();
+}
+}
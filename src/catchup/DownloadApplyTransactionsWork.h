@@ -0,0 +1,74 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "ledger/LedgerRange.h"
+#include "work/Work.h"
+#include "xdr/Stellar-ledger.h"
+#include <map>
+#include <set>
+
+namespace medida
+{
+class Meter;
+class Histogram;
+}
+
+namespace stellar
+{
+
+class TmpDir;
+
+/**
+ * Downloads and applies the transactions of a range of ledgers one checkpoint
+ * at a time, so that downloading and decompressing the next checkpoints
+ * overlaps with applying the current one, instead of waiting for every file
+ * to be on disk before applying any.
+ *
+ * At most `depth` checkpoints are downloading, downloaded or being applied at
+ * any time, which bounds the disk used; the files of a checkpoint are deleted
+ * once it is applied. The ledger files must already be downloaded and
+ * verified, as for ApplyLedgerChainWork.
+ */
+class DownloadApplyTransactionsWork : public Work
+{
+    TmpDir const& mDownloadDir;
+    LedgerRange mRange;
+    uint32_t mDepth;
+    LedgerHeaderHistoryEntry& mLastApplied;
+
+    // next checkpoint to start downloading, and to apply
+    uint32_t mNextDownload;
+    uint32_t mNextApply;
+    // checkpoints downloaded but not applied yet
+    std::set<uint32_t> mDownloaded;
+    // checkpoint of each running download, by name of the work
+    std::map<std::string, uint32_t> mDownloading;
+    std::shared_ptr<Work> mApplyWork;
+
+    medida::Meter& mDownloadCached;
+    medida::Meter& mDownloadStart;
+    medida::Meter& mDownloadSuccess;
+    medida::Meter& mDownloadFailure;
+    medida::Meter& mCheckpointsApplied;
+    medida::Meter& mApplyStall;
+    medida::Histogram& mBuffered;
+
+    uint32_t lastCheckpoint() const;
+    void addDownloads();
+    void addApply();
+    void removeFiles(uint32_t checkpoint);
+
+  public:
+    DownloadApplyTransactionsWork(Application& app, WorkParent& parent,
+                                  TmpDir const& downloadDir, LedgerRange range,
+                                  uint32_t depth,
+                                  LedgerHeaderHistoryEntry& lastApplied);
+    ~DownloadApplyTransactionsWork();
+    std::string getStatus() const override;
+    void onReset() override;
+    void notify(std::string const& child) override;
+};
+}
@@ -11,6 +11,7 @@
 #include "util/XDRStream.h"
 #include <medida/meter.h>
 #include <medida/metrics_registry.h>
+#include <thread>
 
 namespace stellar
 {
@@ -76,6 +77,7 @@ VerifyLedgerChainWork::VerifyLedgerChainWork(
           {"history", "verify-ledger-chain", "failure"}, "event"))
     , mVerifyLedgerChainFailureEnd(app.getMetrics().NewMeter(
           {"history", "verify-ledger-chain", "failure-end"}, "event"))
+    , mNextCheckpoint(mCurrCheckpoint)
 {
 }
 
@@ -114,80 +116,251 @@ VerifyLedgerChainWork::onReset()
     }
     mCurrCheckpoint =
         mApp.getHistoryManager().checkpointContainingLedger(mRange.first());
+    mNextCheckpoint = mCurrCheckpoint;
+    mVerifications.clear();
 }
 
-HistoryManager::VerifyHashStatus
-VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
+void
+VerifyLedgerChainWork::verifyCheckpointFile(std::string const& path,
+                                            uint32_t firstSeq,
+                                            uint32_t lastSeq,
+                                            uint32_t checkpoint,
+                                            CheckpointVerification& result)
 {
-    FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_LEDGER,
-                        mCurrCheckpoint);
+    // Runs on a worker thread: only touches the file and `result`.
     XDRInputFileStream hdrIn;
-    hdrIn.open(ft.localPath_nogz());
-
-    LedgerHeaderHistoryEntry prev = mLastVerified;
-    LedgerHeaderHistoryEntry curr;
+    try
+    {
+        hdrIn.open(path);
+    }
+    catch (std::runtime_error& e)
+    {
+        CLOG(ERROR, "History") << "Failed to open " << path << ": "
+                               << e.what();
+        result.mFailure = CheckpointVerification::READ;
+        return;
+    }
 
-    CLOG(DEBUG, "History") << "Verifying ledger headers from "
-                           << ft.localPath_nogz() << " starting from ledger "
-                           << LedgerManager::ledgerAbbrev(prev);
+    CLOG(DEBUG, "History") << "Verifying ledger headers from " << path
+                           << " starting from ledger " << firstSeq;
 
-    while (hdrIn && hdrIn.readOne(curr))
+    LedgerHeaderHistoryEntry prev;
+    LedgerHeaderHistoryEntry curr;
+    try
     {
-        if (prev.header.ledgerSeq == 0)
+        while (hdrIn && hdrIn.readOne(curr))
         {
-            // When we have no previous state to connect up with
-            // (eg. starting somewhere mid-chain like in CATCHUP_MINIMAL)
-            // we just accept the first chain entry we see. We will
-            // verify the chain continuously from here, and against the
-            // live network.
+            if (prev.header.ledgerSeq == 0)
+            {
+                // First ledger of the file we want: it is linked up with the
+                // previous checkpoint by the main thread. When there is none
+                // (firstSeq is 0, eg. starting somewhere mid-chain like in
+                // CATCHUP_MINIMAL) we just accept the first chain entry we
+                // see. We will verify the chain continuously from here, and
+                // against the live network.
+                if (curr.header.ledgerSeq < firstSeq)
+                {
+                    // Harmless prehistory
+                    result.mOld++;
+                    continue;
+                }
+                else if (firstSeq != 0 && curr.header.ledgerSeq > firstSeq)
+                {
+                    CLOG(ERROR, "History")
+                        << "History chain overshot expected ledger seq "
+                        << firstSeq << ", got " << curr.header.ledgerSeq
+                        << " instead";
+                    result.mFailure = CheckpointVerification::OVERSHOT;
+                    return;
+                }
+                if (verifyLedgerHistoryEntry(curr) !=
+                    HistoryManager::VERIFY_HASH_OK)
+                {
+                    result.mFailure = CheckpointVerification::LINK;
+                    return;
+                }
+                result.mFirst = curr;
+            }
+            else
+            {
+                uint32_t expectedSeq = prev.header.ledgerSeq + 1;
+                if (curr.header.ledgerSeq < expectedSeq)
+                {
+                    result.mOld++;
+                    continue;
+                }
+                else if (curr.header.ledgerSeq > expectedSeq)
+                {
+                    CLOG(ERROR, "History")
+                        << "History chain overshot expected ledger seq "
+                        << expectedSeq << ", got " << curr.header.ledgerSeq
+                        << " instead";
+                    result.mFailure = CheckpointVerification::OVERSHOT;
+                    return;
+                }
+                if (verifyLedgerHistoryLink(prev.hash, curr) !=
+                    HistoryManager::VERIFY_HASH_OK)
+                {
+                    result.mFailure = CheckpointVerification::LINK;
+                    return;
+                }
+            }
+            result.mVerified++;
             prev = curr;
-            mVerifyLedgerSuccess.Mark();
-            continue;
-        }
 
-        uint32_t expectedSeq = prev.header.ledgerSeq + 1;
-        if (curr.header.ledgerSeq < expectedSeq)
-        {
-            // Harmless prehistory
-            mVerifyLedgerSuccessOld.Mark();
-            continue;
-        }
-        else if (curr.header.ledgerSeq > expectedSeq)
-        {
-            CLOG(ERROR, "History")
-                << "History chain overshot expected ledger seq " << expectedSeq
-                << ", got " << curr.header.ledgerSeq << " instead";
-            mVerifyLedgerFailureOvershot.Mark();
-            return HistoryManager::VERIFY_HASH_BAD;
-        }
-        if (verifyLedgerHistoryLink(prev.hash, curr) !=
-            HistoryManager::VERIFY_HASH_OK)
-        {
-            mVerifyLedgerFailureLink.Mark();
-            return HistoryManager::VERIFY_HASH_BAD;
-        }
-        mVerifyLedgerSuccess.Mark();
-        prev = curr;
-
-        if (curr.header.ledgerSeq == mRange.last())
-        {
-            break;
+            if (curr.header.ledgerSeq == lastSeq)
+            {
+                break;
+            }
         }
     }
+    catch (std::exception& e)
+    {
+        CLOG(ERROR, "History") << "Failed to read " << path << ": "
+                               << e.what();
+        result.mFailure = CheckpointVerification::READ;
+        return;
+    }
 
-    if (curr.header.ledgerSeq != mCurrCheckpoint &&
-        curr.header.ledgerSeq != mRange.last())
+    if (prev.header.ledgerSeq != checkpoint &&
+        prev.header.ledgerSeq != lastSeq)
     {
-        // We can end at mCurrCheckpoint if history chain file was valid
-        // Or we can end at mRange.last() if history chain file was valid and we
+        // We can end at checkpoint if history chain file was valid
+        // Or we can end at lastSeq if history chain file was valid and we
         // reached last ledger that we should check.
         // Any other ledger here means that file is corrupted.
         CLOG(ERROR, "History") << "History chain did not end with "
-                               << mCurrCheckpoint << " or " << mRange.last();
+                               << checkpoint << " or " << lastSeq;
+        result.mFailure = CheckpointVerification::END;
+        return;
+    }
+
+    result.mLast = prev;
+    result.mFailure = CheckpointVerification::NONE;
+}
+
+void
+VerifyLedgerChainWork::startVerifications()
+{
+    auto& hm = mApp.getHistoryManager();
+    auto firstCheckpoint = hm.checkpointContainingLedger(mRange.first());
+    auto lastCheckpoint = hm.checkpointContainingLedger(mRange.last());
+    // Twice the worker threads, so they have more to do while the main thread
+    // links up what they finished.
+    size_t maxVerifying = 2 * std::max(std::thread::hardware_concurrency(), 1u);
+
+    while (mNextCheckpoint <= lastCheckpoint &&
+           mVerifications.size() < maxVerifying)
+    {
+        uint32_t checkpoint = mNextCheckpoint;
+        mNextCheckpoint += hm.getCheckpointFrequency();
+
+        // Each checkpoint after the first must pick up right after the one
+        // before it; the first, after what is already verified, if anything.
+        uint32_t firstSeq = checkpoint + 1 - hm.getCheckpointFrequency();
+        if (checkpoint == firstCheckpoint)
+        {
+            firstSeq = mLastVerified.header.ledgerSeq == 0
+                           ? 0
+                           : mLastVerified.header.ledgerSeq + 1;
+        }
+        uint32_t lastSeq = mRange.last();
+        FileTransferInfo ft(mDownloadDir, HISTORY_FILE_TYPE_LEDGER,
+                            checkpoint);
+        std::string path = ft.localPath_nogz();
+        auto verification = std::make_shared<CheckpointVerification>();
+        mVerifications[checkpoint] = verification;
+
+        Application& app = this->mApp;
+        std::weak_ptr<VerifyLedgerChainWork> weak(
+            std::static_pointer_cast<VerifyLedgerChainWork>(
+                shared_from_this()));
+        app.getWorkerIOService().post([&app, weak, path, firstSeq, lastSeq,
+                                       checkpoint, verification]() {
+            verifyCheckpointFile(path, firstSeq, lastSeq, checkpoint,
+                                 *verification);
+            app.getClock().getIOService().post(
+                [weak, checkpoint, verification]() {
+                    auto self = weak.lock();
+                    if (self)
+                    {
+                        self->checkpointVerified(checkpoint, verification);
+                    }
+                });
+        });
+    }
+}
+
+void
+VerifyLedgerChainWork::checkpointVerified(
+    uint32_t checkpoint,
+    std::shared_ptr<CheckpointVerification> const& verification)
+{
+    auto i = mVerifications.find(checkpoint);
+    if (i == mVerifications.end() || i->second != verification)
+    {
+        // Started before a reset.
+        return;
+    }
+    verification->mDone = true;
+    if (checkpoint == mCurrCheckpoint && getState() == WORK_RUNNING)
+    {
+        scheduleSuccess();
+    }
+}
+
+void
+VerifyLedgerChainWork::onRun()
+{
+    startVerifications();
+    auto i = mVerifications.find(mCurrCheckpoint);
+    assert(i != mVerifications.end());
+    if (i->second->mDone)
+    {
+        scheduleSuccess();
+    }
+    // Otherwise checkpointVerified() does once it is.
+}
+
+HistoryManager::VerifyHashStatus
+VerifyLedgerChainWork::verifyHistoryOfSingleCheckpoint()
+{
+    auto i = mVerifications.find(mCurrCheckpoint);
+    assert(i != mVerifications.end() && i->second->mDone);
+    auto verification = i->second;
+    mVerifications.erase(i);
+    auto const& result = *verification;
+    mVerifyLedgerSuccessOld.Mark(result.mOld);
+
+    switch (result.mFailure)
+    {
+    case CheckpointVerification::NONE:
+        break;
+    case CheckpointVerification::OVERSHOT:
+        mVerifyLedgerFailureOvershot.Mark();
+        return HistoryManager::VERIFY_HASH_BAD;
+    case CheckpointVerification::LINK:
+        mVerifyLedgerFailureLink.Mark();
+        return HistoryManager::VERIFY_HASH_BAD;
+    case CheckpointVerification::END:
         mVerifyLedgerChainFailureEnd.Mark();
         return HistoryManager::VERIFY_HASH_BAD;
+    default:
+        mVerifyLedgerChainFailure.Mark();
+        return HistoryManager::VERIFY_HASH_BAD;
+    }
+
+    // The file hangs together; link it to what was verified before it.
+    if (mLastVerified.header.ledgerSeq != 0 &&
+        verifyLedgerHistoryLink(mLastVerified.hash, result.mFirst) !=
+            HistoryManager::VERIFY_HASH_OK)
+    {
+        mVerifyLedgerFailureLink.Mark();
+        return HistoryManager::VERIFY_HASH_BAD;
     }
+    mVerifyLedgerSuccess.Mark(result.mVerified);
 
+    auto const& curr = result.mLast;
     auto status = HistoryManager::VERIFY_HASH_OK;
     if (curr.header.ledgerSeq == mRange.last())
     {
@@ -227,6 +400,7 @@ VerifyLedgerChainWork::onSuccess()
     }
 
     // This is in onSuccess rather than onRun, so we can force a FAILURE_RAISE.
+    // A worker thread has read and hashed the checkpoint file already.
     switch (verifyHistoryOfSingleCheckpoint())
     {
     case HistoryManager::VERIFY_HASH_OK:
@@ -7,6 +7,9 @@
 #include "history/HistoryManager.h"
 #include "ledger/LedgerRange.h"
 #include "work/Work.h"
+#include "xdr/Stellar-ledger.h"
+#include <map>
+#include <memory>
 
 namespace medida
 {
@@ -17,10 +20,39 @@ namespace stellar
 {
 
 class TmpDir;
-struct LedgerHeaderHistoryEntry;
 
+/**
+ * Verifies the hash chain of the ledger headers of a range. The checkpoint
+ * files are read and hashed on worker threads, several at a time, each on its
+ * own: only the links between checkpoints depend on each other. The main
+ * thread then takes the checkpoints in order, links each to the last ledger
+ * verified before it and, at the end of the range, checks the last ledger
+ * with the LedgerManager.
+ */
 class VerifyLedgerChainWork : public Work
 {
+    // Outcome of checking one checkpoint file on its own.
+    struct CheckpointVerification
+    {
+        enum Failure
+        {
+            NONE,
+            READ,
+            OVERSHOT,
+            LINK,
+            END
+        };
+
+        // set on the main thread once the worker thread is done
+        bool mDone{false};
+        Failure mFailure{READ};
+        // first and last ledgers of the range found in the file
+        LedgerHeaderHistoryEntry mFirst;
+        LedgerHeaderHistoryEntry mLast;
+        uint64_t mVerified{0};
+        uint64_t mOld{0};
+    };
+
     TmpDir const& mDownloadDir;
     LedgerRange mRange;
     uint32_t mCurrCheckpoint;
@@ -36,6 +68,20 @@ class VerifyLedgerChainWork : public Work
     medida::Meter& mVerifyLedgerChainFailure;
     medida::Meter& mVerifyLedgerChainFailureEnd;
 
+    // next checkpoint to hand to a worker thread
+    uint32_t mNextCheckpoint;
+    // checkpoints handed to worker threads and not linked up yet
+    std::map<uint32_t, std::shared_ptr<CheckpointVerification>>
+        mVerifications;
+
+    static void verifyCheckpointFile(std::string const& path,
+                                     uint32_t firstSeq, uint32_t lastSeq,
+                                     uint32_t checkpoint,
+                                     CheckpointVerification& result);
+    void startVerifications();
+    void checkpointVerified(
+        uint32_t checkpoint,
+        std::shared_ptr<CheckpointVerification> const& verification);
     HistoryManager::VerifyHashStatus verifyHistoryOfSingleCheckpoint();
 
   public:
@@ -47,6 +93,7 @@ class VerifyLedgerChainWork : public Work
     ~VerifyLedgerChainWork();
     std::string getStatus() const override;
     void onReset() override;
+    void onRun() override;
     Work::State onSuccess() override;
 };
 }
@@ -0,0 +1,147 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "catchup/VerifyLedgerChainWork.h"
+#include "history/FileTransferInfo.h"
+#include "history/HistoryManager.h"
+#include "ledger/LedgerHeaderFrame.h"
+#include "lib/catch.hpp"
+#include "main/Application.h"
+#include "test/TestUtils.h"
+#include "test/test.h"
+#include "util/TmpDir.h"
+#include "util/XDRStream.h"
+#include "work/WorkManager.h"
+#include <map>
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
+
+using namespace stellar;
+
+namespace
+{
+
+void
+rehash(LedgerHeaderHistoryEntry& entry)
+{
+    entry.hash = LedgerHeaderFrame(entry.header).getHash();
+}
+
+// Ledgers 1 to lastLedger, each linked to the one before it.
+std::vector<LedgerHeaderHistoryEntry>
+makeChain(uint32_t lastLedger)
+{
+    std::vector<LedgerHeaderHistoryEntry> chain;
+    for (uint32_t seq = 1; seq <= lastLedger; seq++)
+    {
+        LedgerHeaderHistoryEntry entry;
+        entry.header.ledgerSeq = seq;
+        entry.header.scpValue.closeTime = seq;
+        if (!chain.empty())
+        {
+            entry.header.previousLedgerHash = chain.back().hash;
+        }
+        rehash(entry);
+        chain.push_back(entry);
+    }
+    return chain;
+}
+
+void
+writeCheckpoints(Application& app, TmpDir const& dir,
+                 std::vector<LedgerHeaderHistoryEntry> const& chain)
+{
+    std::map<uint32_t, std::vector<LedgerHeaderHistoryEntry>> checkpoints;
+    for (auto const& entry : chain)
+    {
+        auto checkpoint = app.getHistoryManager().checkpointContainingLedger(
+            entry.header.ledgerSeq);
+        checkpoints[checkpoint].push_back(entry);
+    }
+    for (auto const& checkpoint : checkpoints)
+    {
+        FileTransferInfo ft(dir, HISTORY_FILE_TYPE_LEDGER, checkpoint.first);
+        XDROutputFileStream out;
+        out.open(ft.localPath_nogz());
+        for (auto const& entry : checkpoint.second)
+        {
+            out.writeOne(entry);
+        }
+    }
+}
+}
+
+TEST_CASE("verify ledger chain", "[history][catchup]")
+{
+    VirtualClock clock(VirtualClock::REAL_TIME);
+    auto app = createTestApplication(clock, getTestConfig());
+    TmpDir dir = app->getTmpDirManager().tmpDir("verify-ledger-chain");
+    auto& wm = app->getWorkManager();
+
+    // Enough checkpoints to keep every worker thread busy.
+    auto chain = makeChain(40 * 64 - 1);
+    LedgerHeaderHistoryEntry firstVerified;
+    LedgerHeaderHistoryEntry lastVerified;
+    auto verify = [&](LedgerRange range) {
+        writeCheckpoints(*app, dir, chain);
+        return wm.executeWork<VerifyLedgerChainWork>(
+            true, dir, range, true, firstVerified, lastVerified);
+    };
+    auto& linkFailures = app->getMetrics().NewMeter(
+        {"history", "verify-ledger", "failure-link"}, "event");
+
+    SECTION("whole chain")
+    {
+        auto w = verify(LedgerRange{1, chain.back().header.ledgerSeq});
+        REQUIRE(w->getState() == Work::WORK_SUCCESS);
+        CHECK(firstVerified == chain[62]);
+        CHECK(lastVerified == chain.back());
+        CHECK(app->getMetrics()
+                  .NewMeter({"history", "verify-ledger", "success"}, "event")
+                  .count() == chain.size());
+    }
+
+    SECTION("part of a checkpoint")
+    {
+        auto w = verify(LedgerRange{1000, 1100});
+        REQUIRE(w->getState() == Work::WORK_SUCCESS);
+        CHECK(lastVerified == chain[1099]);
+    }
+
+    SECTION("bad link between checkpoints")
+    {
+        // The checkpoint of ledgers 1024 to 1087 hangs together, but not with
+        // the one before.
+        for (size_t i = 1023; i < 1087; i++)
+        {
+            chain[i].header.scpValue.closeTime++;
+            if (i > 1023)
+            {
+                chain[i].header.previousLedgerHash = chain[i - 1].hash;
+            }
+            rehash(chain[i]);
+        }
+        auto w = verify(LedgerRange{1, chain.back().header.ledgerSeq});
+        REQUIRE(w->getState() == Work::WORK_FAILURE_FATAL);
+        CHECK(linkFailures.count() == 1);
+        CHECK(lastVerified == chain[1022]);
+    }
+
+    SECTION("bad ledger within a checkpoint")
+    {
+        chain[2000].header.scpValue.closeTime++;
+        auto w = verify(LedgerRange{1, chain.back().header.ledgerSeq});
+        REQUIRE(w->getState() == Work::WORK_FAILURE_FATAL);
+        CHECK(linkFailures.count() == 1);
+        CHECK(lastVerified.header.ledgerSeq < 2001);
+    }
+
+    SECTION("missing ledger")
+    {
+        chain.erase(chain.begin() + 500);
+        auto w = verify(LedgerRange{1, chain.back().header.ledgerSeq});
+        REQUIRE(w->getState() == Work::WORK_FAILURE_FATAL);
+        CHECK(lastVerified.header.ledgerSeq < 501);
+    }
+}
@@ -7,15 +7,19 @@
 #include "crypto/Random.h"
 #include "crypto/SHA.h"
 #include "crypto/SecretKey.h"
+#include "crypto/ShortHash.h"
 #include "crypto/StrKey.h"
 #include "lib/catch.hpp"
+#include "main/Config.h"
 #include "test/test.h"
 #include "util/Logging.h"
 #include "util/basen.h"
+#include <atomic>
 #include <autocheck/autocheck.hpp>
 #include <map>
 #include <regex>
 #include <sodium.h>
+#include <thread>
 
 using namespace stellar;
 
@@ -100,6 +104,18 @@ TEST_CASE("Stateful SHA256 tests", "[crypto]")
     }
 }
 
+TEST_CASE("short hashes", "[crypto]")
+{
+    std::string s = "The quick brown fox jumps over the lazy dog";
+    ByteSlice bin(s);
+
+    // The persisted hash has a fixed key; the in-memory one is keyed at random
+    // but stays the same within the process.
+    CHECK(shortHash(bin) == shortHash(ByteSlice(std::string(s))));
+    CHECK(randomShortHash(bin) == randomShortHash(ByteSlice(std::string(s))));
+    CHECK(randomShortHash(bin) != shortHash(bin));
+}
+
 TEST_CASE("HMAC test vector", "[crypto]")
 {
     HmacSha256Key k;
@@ -114,6 +130,20 @@ TEST_CASE("HMAC test vector", "[crypto]")
     REQUIRE(hmacSha256Verify(v, k, s));
 }
 
+TEST_CASE("Stateful HMAC test vector", "[crypto]")
+{
+    HmacSha256Key k;
+    k.key[0] = 'k';
+    k.key[1] = 'e';
+    k.key[2] = 'y';
+    auto h = hexToBin256(
+        "f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8");
+    auto hmac = HmacSha256::create(k);
+    hmac->add("The quick brown ");
+    hmac->add("fox jumps over the lazy dog");
+    REQUIRE(h == hmac->finish().mac);
+}
+
 TEST_CASE("HKDF test vector", "[crypto]")
 {
     auto ikm = hexToBin("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b");
@@ -153,6 +183,75 @@ TEST_CASE("sign tests", "[crypto]")
     CHECK(!PubKeyUtils::verifySig(pk, sig, msg));
 }
 
+TEST_CASE("signature verification cache", "[crypto]")
+{
+    std::vector<SecretKey> keys;
+    std::vector<Signature> sigs;
+    for (int i = 0; i < 64; i++)
+    {
+        keys.emplace_back(SecretKey::random());
+        sigs.emplace_back(keys.back().sign(std::to_string(i)));
+    }
+    // verifies good and bad signatures, counting wrong results
+    std::atomic<size_t> wrong{0};
+    auto verifyAll = [&]() {
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            auto const& pk = keys[i].getPublicKey();
+            wrong += PubKeyUtils::verifySig(pk, sigs[i], std::to_string(i))
+                         ? 0
+                         : 1;
+            wrong += PubKeyUtils::verifySig(pk, sigs[i], std::to_string(i + 1))
+                         ? 1
+                         : 0;
+        }
+    };
+    uint64_t hits0, misses0, hits1, misses1;
+    PubKeyUtils::clearVerifySigCache();
+
+    SECTION("results are cached")
+    {
+        verifyAll();
+        PubKeyUtils::getVerifySigCacheCounts(hits0, misses0);
+        verifyAll();
+        PubKeyUtils::getVerifySigCacheCounts(hits1, misses1);
+        REQUIRE(hits1 - hits0 == 128);
+        REQUIRE(misses1 - misses0 == 0);
+    }
+
+    SECTION("concurrent lookups")
+    {
+        PubKeyUtils::getVerifySigCacheCounts(hits0, misses0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+        {
+            threads.emplace_back(verifyAll);
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        PubKeyUtils::getVerifySigCacheCounts(hits1, misses1);
+        REQUIRE(hits1 - hits0 + misses1 - misses0 == 4 * 128);
+        REQUIRE(misses1 - misses0 >= 128);
+    }
+
+    SECTION("resizing drops results")
+    {
+        verifyAll();
+        PubKeyUtils::setVerifySigCacheSize(
+            Config::DEFAULT_VERIFY_SIG_CACHE_SIZE / 2);
+        PubKeyUtils::getVerifySigCacheCounts(hits0, misses0);
+        verifyAll();
+        PubKeyUtils::getVerifySigCacheCounts(hits1, misses1);
+        REQUIRE(misses1 - misses0 == 128);
+        PubKeyUtils::setVerifySigCacheSize(
+            Config::DEFAULT_VERIFY_SIG_CACHE_SIZE);
+    }
+
+    REQUIRE(wrong == 0);
+}
+
 struct SignVerifyTestcase
 {
     SecretKey key;
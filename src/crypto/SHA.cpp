@@ -98,6 +98,61 @@ hmacSha256(HmacSha256Key const& key, ByteSlice const& bin)
     return out;
 }
 
+class HmacSha256Impl : public HmacSha256, NonCopyable
+{
+    crypto_auth_hmacsha256_state mState;
+    bool mFinished;
+
+  public:
+    explicit HmacSha256Impl(HmacSha256Key const& key);
+    void add(ByteSlice const& bin) override;
+    HmacSha256Mac finish() override;
+};
+
+std::unique_ptr<HmacSha256>
+HmacSha256::create(HmacSha256Key const& key)
+{
+    return make_unique<HmacSha256Impl>(key);
+}
+
+HmacSha256Impl::HmacSha256Impl(HmacSha256Key const& key) : mFinished(false)
+{
+    if (crypto_auth_hmacsha256_init(&mState, key.key.data(),
+                                    key.key.size()) != 0)
+    {
+        throw std::runtime_error("error from crypto_auth_hmacsha256_init");
+    }
+}
+
+void
+HmacSha256Impl::add(ByteSlice const& bin)
+{
+    if (mFinished)
+    {
+        throw std::runtime_error("adding bytes to finished HMAC-SHA256");
+    }
+    if (crypto_auth_hmacsha256_update(&mState, bin.data(), bin.size()) != 0)
+    {
+        throw std::runtime_error("error from crypto_auth_hmacsha256_update");
+    }
+}
+
+HmacSha256Mac
+HmacSha256Impl::finish()
+{
+    HmacSha256Mac out;
+    if (mFinished)
+    {
+        throw std::runtime_error("finishing already-finished HMAC-SHA256");
+    }
+    if (crypto_auth_hmacsha256_final(&mState, out.mac.data()) != 0)
+    {
+        throw std::runtime_error("error from crypto_auth_hmacsha256_final");
+    }
+    mFinished = true;
+    return out;
+}
+
 bool
 hmacSha256Verify(HmacSha256Mac const& hmac, HmacSha256Key const& key,
                  ByteSlice const& bin)
@@ -12,6 +12,9 @@
 #include "util/HashOfHash.h"
 #include "util/lrucache.hpp"
 #include "util/make_unique.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sodium.h>
@@ -26,24 +29,41 @@ namespace stellar
 // to the state of the process; caching its results centrally
 // makes all signature-verification in the program faster and
 // has no effect on correctness.
+//
+// Signatures are verified from several threads at once, so the cache is split
+// in shards, picked by cache key, each with its own lock.
+
+static size_t const VERIFY_SIG_CACHE_SHARDS = 16;
+
+namespace
+{
+struct VerifySigCacheShard
+{
+    std::mutex mMutex;
+    cache::lru_cache<Hash, bool> mCache{
+        Config::DEFAULT_VERIFY_SIG_CACHE_SIZE / VERIFY_SIG_CACHE_SHARDS};
+};
+}
 
-static std::mutex gVerifySigCacheMutex;
-static cache::lru_cache<Hash, bool> gVerifySigCache(0xffff);
-static std::unique_ptr<SHA256> gHasher = SHA256::create();
-static uint64_t gVerifyCacheHit = 0;
-static uint64_t gVerifyCacheMiss = 0;
+static std::array<VerifySigCacheShard, VERIFY_SIG_CACHE_SHARDS>
+    gVerifySigCache;
+static std::atomic<size_t> gVerifySigCacheSize{
+    Config::DEFAULT_VERIFY_SIG_CACHE_SIZE};
+static std::atomic<uint64_t> gVerifyCacheHit{0};
+static std::atomic<uint64_t> gVerifyCacheMiss{0};
 
+// Each call hashes with its own hasher, as calls may run concurrently.
 static Hash
 verifySigCacheKey(PublicKey const& key, Signature const& signature,
                   ByteSlice const& bin)
 {
     assert(key.type() == PUBLIC_KEY_TYPE_ED25519);
 
-    gHasher->reset();
-    gHasher->add(key.ed25519());
-    gHasher->add(signature);
-    gHasher->add(bin);
-    return gHasher->finish();
+    auto hasher = SHA256::create();
+    hasher->add(key.ed25519());
+    hasher->add(signature);
+    hasher->add(bin);
+    return hasher->finish();
 }
 
 SecretKey::SecretKey() : mKeyType(PUBLIC_KEY_TYPE_ED25519)
@@ -195,21 +215,42 @@ SecretKey::fromStrKeySeed(std::string const& strKeySeed)
     return sk;
 }
 
+static VerifySigCacheShard&
+verifySigCacheShard(Hash const& cacheKey)
+{
+    return gVerifySigCache[cacheKey[0] % VERIFY_SIG_CACHE_SHARDS];
+}
+
 void
 PubKeyUtils::clearVerifySigCache()
 {
-    std::lock_guard<std::mutex> guard(gVerifySigCacheMutex);
-    gVerifySigCache.clear();
+    for (auto& shard : gVerifySigCache)
+    {
+        std::lock_guard<std::mutex> guard(shard.mMutex);
+        shard.mCache.clear();
+    }
+}
+
+void
+PubKeyUtils::setVerifySigCacheSize(size_t size)
+{
+    if (gVerifySigCacheSize.exchange(size) == size)
+    {
+        return;
+    }
+    auto shardSize = std::max<size_t>(size / VERIFY_SIG_CACHE_SHARDS, 1);
+    for (auto& shard : gVerifySigCache)
+    {
+        std::lock_guard<std::mutex> guard(shard.mMutex);
+        shard.mCache = cache::lru_cache<Hash, bool>(shardSize);
+    }
 }
 
 void
-PubKeyUtils::flushVerifySigCacheCounts(uint64_t& hits, uint64_t& misses)
+PubKeyUtils::getVerifySigCacheCounts(uint64_t& hits, uint64_t& misses)
 {
-    std::lock_guard<std::mutex> guard(gVerifySigCacheMutex);
     hits = gVerifyCacheHit;
     misses = gVerifyCacheMiss;
-    gVerifyCacheHit = 0;
-    gVerifyCacheMiss = 0;
 }
 
 std::string
@@ -290,13 +331,14 @@ PubKeyUtils::verifySig(PublicKey const& key, Signature const& signature,
     }
 
     auto cacheKey = verifySigCacheKey(key, signature, bin);
+    auto& shard = verifySigCacheShard(cacheKey);
 
     {
-        std::lock_guard<std::mutex> guard(gVerifySigCacheMutex);
-        if (gVerifySigCache.exists(cacheKey))
+        std::lock_guard<std::mutex> guard(shard.mMutex);
+        if (shard.mCache.exists(cacheKey))
         {
             ++gVerifyCacheHit;
-            return gVerifySigCache.get(cacheKey);
+            return shard.mCache.get(cacheKey);
         }
     }
 
@@ -304,8 +346,8 @@ PubKeyUtils::verifySig(PublicKey const& key, Signature const& signature,
     bool ok =
         (crypto_sign_verify_detached(signature.data(), bin.data(), bin.size(),
                                      key.ed25519().data()) == 0);
-    std::lock_guard<std::mutex> guard(gVerifySigCacheMutex);
-    gVerifySigCache.put(cacheKey, ok);
+    std::lock_guard<std::mutex> guard(shard.mMutex);
+    shard.mCache.put(cacheKey, ok);
     return ok;
 }
 
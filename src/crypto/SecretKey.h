@@ -102,7 +102,11 @@ bool verifySig(PublicKey const& key, Signature const& signature,
                ByteSlice const& bin);
 
 void clearVerifySigCache();
-void flushVerifySigCacheCounts(uint64_t& hits, uint64_t& misses);
+// Sets the number of results the process-wide verification cache keeps,
+// dropping them if it changes.
+void setVerifySigCacheSize(size_t size);
+// Number of lookups in the verification cache since the process started.
+void getVerifySigCacheCounts(uint64_t& hits, uint64_t& misses);
 
 PublicKey random();
 }
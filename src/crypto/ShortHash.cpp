@@ -0,0 +1,55 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/ShortHash.h"
+#include <sodium.h>
+#include <stdexcept>
+
+namespace stellar
+{
+
+namespace
+{
+
+struct RandomKey
+{
+    unsigned char mKey[crypto_shorthash_KEYBYTES];
+
+    RandomKey()
+    {
+        randombytes_buf(mKey, sizeof(mKey));
+    }
+};
+
+uint64_t
+keyedShortHash(ByteSlice const& bin, unsigned char const* key)
+{
+    unsigned char out[crypto_shorthash_BYTES];
+    if (crypto_shorthash(out, bin.data(), bin.size(), key) != 0)
+    {
+        throw std::runtime_error("error from crypto_shorthash");
+    }
+    uint64_t res = 0;
+    for (size_t i = 0; i < sizeof(out); ++i)
+    {
+        res = (res << 8) | out[i];
+    }
+    return res;
+}
+}
+
+uint64_t
+shortHash(ByteSlice const& bin)
+{
+    static unsigned char const key[crypto_shorthash_KEYBYTES] = {0};
+    return keyedShortHash(bin, key);
+}
+
+uint64_t
+randomShortHash(ByteSlice const& bin)
+{
+    static RandomKey const key;
+    return keyedShortHash(bin, key.mKey);
+}
+}
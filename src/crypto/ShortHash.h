@@ -0,0 +1,22 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/ByteSlice.h"
+#include <cstdint>
+
+namespace stellar
+{
+
+// SipHash-2-4 under a fixed, public key: a fast, well-distributed 64-bit hash
+// that is stable across processes and platforms, so it is safe to persist.
+// Not a MAC, and not collision-resistant against adversarial inputs.
+uint64_t shortHash(ByteSlice const& bin);
+
+// SipHash-2-4 under a key drawn at random once per process. For in-memory
+// hash tables keyed by data users choose, where a public key would let them
+// pick colliding keys; never persist or send its values.
+uint64_t randomShortHash(ByteSlice const& bin);
+}
@@ -0,0 +1,226 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "database/BulkRows.h"
+#include "database/Database.h"
+#include <cassert>
+
+namespace stellar
+{
+
+BulkRows::BulkRows(std::string table, std::vector<Column> columns)
+    : mTable(std::move(table))
+    , mColumns(std::move(columns))
+    , mValues(mColumns.size())
+    , mIndicators(mColumns.size())
+{
+}
+
+void
+BulkRows::add(std::string value)
+{
+    mValues[mNextColumn].emplace_back(std::move(value));
+    mIndicators[mNextColumn].emplace_back(soci::i_ok);
+    mNextColumn = (mNextColumn + 1) % mColumns.size();
+}
+
+void
+BulkRows::addNull()
+{
+    mValues[mNextColumn].emplace_back();
+    mIndicators[mNextColumn].emplace_back(soci::i_null);
+    mNextColumn = (mNextColumn + 1) % mColumns.size();
+}
+
+size_t
+BulkRows::size() const
+{
+    assert(mNextColumn == 0);
+    return mValues.front().size();
+}
+
+void
+BulkRows::clear()
+{
+    for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+        mValues[i].clear();
+        mIndicators[i].clear();
+    }
+    mNextColumn = 0;
+}
+
+std::string
+BulkRows::columnNames() const
+{
+    std::string names;
+    for (auto const& c : mColumns)
+    {
+        names += names.empty() ? "" : ", ";
+        names += c.mName;
+    }
+    return names;
+}
+
+// The rows as a Postgres table expression, with each column bound as an array
+// parameter.
+std::string
+BulkRows::unnestColumns() const
+{
+    std::string res = "unnest(";
+    for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+        res += (i == 0 ? "CAST(:v" : ", CAST(:v") + std::to_string(i) + " AS " +
+               mColumns[i].mType + "[])";
+    }
+    res += ")";
+    return res;
+}
+
+std::string
+BulkRows::toPostgresArray(std::vector<std::string> const& values,
+                          std::vector<soci::indicator> const& indicators)
+{
+    std::string res = "{";
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i != 0)
+        {
+            res += ',';
+        }
+        if (indicators[i] == soci::i_null)
+        {
+            res += "NULL";
+            continue;
+        }
+        res += '"';
+        for (char c : values[i])
+        {
+            if (c == '"' || c == '\\')
+            {
+                res += '\\';
+            }
+            res += c;
+        }
+        res += '"';
+    }
+    res += '}';
+    return res;
+}
+
+void
+BulkRows::execute(Database& db, soci::session& sess, std::string const& sql,
+                  bool insert, std::string const& entityName)
+{
+    bool sqlite = db.isSqlite();
+    bool mainSession = &sess == &db.getSession();
+
+    // On Postgres the columns are bound as array literals, which must stay in
+    // place until the statement has run.
+    std::vector<std::string> arrays;
+    if (!sqlite)
+    {
+        arrays.reserve(mColumns.size());
+        for (size_t i = 0; i < mColumns.size(); ++i)
+        {
+            arrays.emplace_back(toPostgresArray(mValues[i], mIndicators[i]));
+        }
+    }
+
+    long long affected = 0;
+    auto run = [&](soci::statement& st) {
+        for (size_t i = 0; i < mColumns.size(); ++i)
+        {
+            if (sqlite)
+            {
+                st.exchange(soci::use(mValues[i], mIndicators[i]));
+            }
+            else
+            {
+                st.exchange(soci::use(arrays[i]));
+            }
+        }
+        st.define_and_bind();
+        if (mainSession)
+        {
+            auto timer = insert ? db.getInsertTimer(entityName)
+                                : db.getDeleteTimer(entityName);
+            st.execute(true);
+        }
+        else
+        {
+            st.execute(true);
+        }
+        affected = st.get_affected_rows();
+    };
+
+    if (mainSession)
+    {
+        auto prep = db.getPreparedStatement(sql);
+        run(prep.statement());
+    }
+    else
+    {
+        soci::statement st = (sess.prepare << sql);
+        run(st);
+    }
+
+    if (insert && static_cast<size_t>(affected) != size())
+    {
+        throw std::runtime_error("Could not update data in SQL");
+    }
+}
+
+void
+BulkRows::insert(Database& db, soci::session& sess,
+                 std::string const& entityName)
+{
+    if (size() == 0)
+    {
+        return;
+    }
+
+    std::string sql = "INSERT INTO " + mTable + " (" + columnNames() + ") ";
+    if (db.isSqlite())
+    {
+        sql += "VALUES (";
+        for (size_t i = 0; i < mColumns.size(); ++i)
+        {
+            sql += (i == 0 ? ":v" : ", :v") + std::to_string(i);
+        }
+        sql += ")";
+    }
+    else
+    {
+        sql += "SELECT * FROM " + unnestColumns();
+    }
+    execute(db, sess, sql, true, entityName);
+}
+
+void
+BulkRows::erase(Database& db, soci::session& sess,
+                std::string const& entityName)
+{
+    if (size() == 0)
+    {
+        return;
+    }
+
+    std::string sql = "DELETE FROM " + mTable + " WHERE ";
+    if (db.isSqlite())
+    {
+        for (size_t i = 0; i < mColumns.size(); ++i)
+        {
+            sql += (i == 0 ? "" : " AND ") + mColumns[i].mName + " = :v" +
+                   std::to_string(i);
+        }
+    }
+    else
+    {
+        sql += "(" + columnNames() + ") IN (SELECT * FROM " + unnestColumns() +
+               ")";
+    }
+    execute(db, sess, sql, false, entityName);
+}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/SociNoWarnings.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stellar
+{
+
+class Database;
+
+/**
+ * Helper for writing, or deleting, many rows of one table with a single
+ * statement, for bulk loads such as applying buckets during catchup.
+ *
+ * Values are collected column by column, as strings. On Postgres each column
+ * is then sent as one array parameter and unpacked with `unnest`, so a whole
+ * batch costs a single round trip to the server. On SQLite the columns are
+ * bound as soci vectors to a single prepared statement, which steps through
+ * the rows in-process.
+ */
+class BulkRows
+{
+  public:
+    struct Column
+    {
+        std::string mName;
+        // Type of the column's values on Postgres, eg. "BIGINT".
+        std::string mType;
+    };
+
+  private:
+    std::string mTable;
+    std::vector<Column> mColumns;
+    std::vector<std::vector<std::string>> mValues;
+    std::vector<std::vector<soci::indicator>> mIndicators;
+    size_t mNextColumn{0};
+
+    std::string columnNames() const;
+    std::string unnestColumns() const;
+    void execute(Database& db, soci::session& sess, std::string const& sql,
+                 bool insert, std::string const& entityName);
+
+  public:
+    BulkRows(std::string table, std::vector<Column> columns);
+
+    // Append the next value of the row being built; a row is complete once
+    // every column, in order, has a value.
+    void add(std::string value);
+    void addNull();
+
+    template <typename T>
+    void
+    addNumber(T value)
+    {
+        std::ostringstream os;
+        os.precision(17);
+        os << value;
+        add(os.str());
+    }
+
+    // Number of complete rows.
+    size_t size() const;
+
+    void clear();
+
+    // Insert all the rows, which must not exist yet.
+    //
+    // Statements on the main session of `db` are prepared once and timed as
+    // usual. `sess` may also be a session borrowed from the connection pool by
+    // a worker thread, in which case statements are prepared on it directly
+    // and nothing else of `db` is touched.
+    void insert(Database& db, soci::session& sess,
+                std::string const& entityName);
+
+    // Delete all rows of the table matching one of the rows on every column.
+    // `sess` is as for `insert`.
+    void erase(Database& db, soci::session& sess,
+               std::string const& entityName);
+
+    // Encode a column as a Postgres array literal.
+    static std::string
+    toPostgresArray(std::vector<std::string> const& values,
+                    std::vector<soci::indicator> const& indicators);
+};
+}
@@ -20,6 +20,7 @@
 #include "ledger/DataFrame.h"
 #include "ledger/LedgerHeaderFrame.h"
 #include "ledger/OfferFrame.h"
+#include "ledger/OrderBook.h"
 #include "ledger/TrustFrame.h"
 #include "main/ExternalQueue.h"
 #include "main/PersistentState.h"
@@ -82,6 +83,8 @@ Database::Database(Application& app)
     , mStatementsSize(
           app.getMetrics().NewCounter({"database", "memory", "statements"}))
     , mEntryCache(4096)
+    , mOrderBook(
+          make_unique<OrderBook>(app.getConfig().ORDER_BOOK_CACHE_SIZE))
     , mExcludedQueryTime(0)
     , mExcludedTotalTime(0)
     , mLastIdleQueryTime(0)
@@ -106,6 +109,10 @@ Database::Database(Application& app)
     }
 }
 
+Database::~Database()
+{
+}
+
 void
 Database::applySchemaUpgrade(unsigned long vers)
 {
@@ -341,12 +348,18 @@ Database::getPool()
     return *mPool;
 }
 
-cache::lru_cache<std::string, std::shared_ptr<LedgerEntry const>>&
+Database::EntryCache&
 Database::getEntryCache()
 {
     return mEntryCache;
 }
 
+OrderBook&
+Database::getOrderBook()
+{
+    return *mOrderBook;
+}
+
 class SQLLogContext : NonCopyable
 {
     std::string mName;
@@ -4,12 +4,13 @@
 // under the Apache License, Version 2.0. See the COPYING file at the root
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
+#include "ledger/LedgerHashUtils.h"
 #include "medida/timer_context.h"
 #include "overlay/StellarXDR.h"
+#include "util/ClockCache.h"
 #include "util/NonCopyable.h"
 #include "util/SociNoWarnings.h"
 #include "util/Timer.h"
-#include "util/lrucache.hpp"
 #include <set>
 #include <string>
 
@@ -23,6 +24,7 @@ class Counter;
 namespace stellar
 {
 class Application;
+class OrderBook;
 class SQLLogContext;
 
 /**
@@ -92,8 +94,8 @@ class Database : NonMovableOrCopyable
     std::map<std::string, std::shared_ptr<soci::statement>> mStatements;
     medida::Counter& mStatementsSize;
 
-    cache::lru_cache<std::string, std::shared_ptr<LedgerEntry const>>
-        mEntryCache;
+    ClockCache<LedgerKey, std::shared_ptr<LedgerEntry const>> mEntryCache;
+    std::unique_ptr<OrderBook> mOrderBook;
 
     // Helpers for maintaining the total query time and calculating
     // idle percentage.
@@ -111,6 +113,7 @@ class Database : NonMovableOrCopyable
     // Instantiate object and connect to app.getConfig().DATABASE;
     // if there is a connection error, this will throw.
     Database(Application& app);
+    ~Database();
 
     // Return a crude meter of total queries to the db, for use in
     // overlay/LoadManager.
@@ -192,9 +195,13 @@ class Database : NonMovableOrCopyable
     // Access the LedgerEntry cache. Note: clients are responsible for
     // invalidating entries in this cache as they perform statements
     // against the database. It's kept here only for ease of access.
-    typedef cache::lru_cache<std::string, std::shared_ptr<LedgerEntry const>>
+    typedef ClockCache<LedgerKey, std::shared_ptr<LedgerEntry const>>
         EntryCache;
     EntryCache& getEntryCache();
+
+    // Access the in-memory order book. As with the entry cache, clients
+    // writing offers keep it up to date.
+    OrderBook& getOrderBook();
 };
 
 class DBTimeExcluder : NonCopyable
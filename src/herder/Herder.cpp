@@ -14,4 +14,6 @@ std::chrono::seconds const Herder::NODE_EXPIRATION_SECONDS(240);
 uint32 const Herder::LEDGER_VALIDITY_BRACKET = 100;
 // 12 slots give us about a minute to reconnect
 uint32 const Herder::MAX_SLOTS_TO_REMEMBER = 12;
+size_t const Herder::MAX_TRANSACTIONS_TO_CHECK = 5000;
+size_t const Herder::MAX_VALID_TRANSACTIONS_TO_REMEMBER = 10000;
 }
@@ -54,6 +54,14 @@ class Herder
     // How many ledgers in the past we keep track of
     static uint32 const MAX_SLOTS_TO_REMEMBER;
 
+    // How many received transactions may wait to be checked before more are
+    // dropped.
+    static size_t const MAX_TRANSACTIONS_TO_CHECK;
+
+    // How many transactions found valid against the last closed ledger are
+    // remembered.
+    static size_t const MAX_VALID_TRANSACTIONS_TO_REMEMBER;
+
     static std::unique_ptr<Herder> create(Application& app);
 
     enum State
@@ -102,6 +110,21 @@ class Herder
     virtual bool recvTxSet(Hash const& hash, TxSetFrame const& txset) = 0;
     // We are learning about a new transaction.
     virtual TransactionSubmitStatus recvTransaction(TransactionFramePtr tx) = 0;
+    // Same, for transactions flooded to us: `tx` is first hashed, and those
+    // of its signatures that can be without loading accounts are verified,
+    // on a worker thread; the rest of the checks are then done on the main
+    // thread, which is passed the status through `handler`. The main thread
+    // takes transactions in the order they were received, so that one isn't
+    // checked before the transaction of the same account it follows. Returns
+    // false, without calling `handler`, if too many transactions are waiting
+    // already: the caller should drop `tx`.
+    virtual bool recvTransaction(
+        TransactionFramePtr tx,
+        std::function<void(TransactionSubmitStatus)> handler) = 0;
+    // TransactionFrame::checkValid, skipping most of the checks for
+    // transactions found valid against the same last closed ledger before.
+    virtual bool checkTransactionValid(TransactionFramePtr tx,
+                                       SequenceNumber current) = 0;
     virtual void peerDoesntHave(stellar::MessageType type,
                                 uint256 const& itemID, PeerPtr peer) = 0;
     virtual TxSetFramePtr getTxSet(Hash const& hash) = 0;
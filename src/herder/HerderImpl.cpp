@@ -24,6 +24,7 @@
 #include "util/make_unique.h"
 
 #include "medida/counter.h"
+#include "medida/histogram.h"
 #include "medida/meter.h"
 #include "medida/metrics_registry.h"
 #include "util/XDRStream.h"
@@ -66,11 +67,24 @@ HerderImpl::SCPMetrics::SCPMetrics(Application& app)
           app.getMetrics().NewCounter({"herder", "pending-txs", "age2"}))
     , mHerderPendingTxs3(
           app.getMetrics().NewCounter({"herder", "pending-txs", "age3"}))
+    , mHerderPendingTxsSize(
+          app.getMetrics().NewCounter({"herder", "pending-txs", "size"}))
+    , mHerderPendingTxsAppliedAge(app.getMetrics().NewHistogram(
+          {"herder", "pending-txs", "applied-age"}))
+    , mHerderTxsToCheck(
+          app.getMetrics().NewCounter({"herder", "pending-txs", "to-check"}))
+    , mHerderTxsToCheckDrop(app.getMetrics().NewMeter(
+          {"herder", "pending-txs", "to-check-drop"}, "transaction"))
+    , mValidTxsHit(app.getMetrics().NewMeter(
+          {"herder", "valid-txs-cache", "hit"}, "transaction"))
+    , mValidTxsMiss(app.getMetrics().NewMeter(
+          {"herder", "valid-txs-cache", "miss"}, "transaction"))
 {
 }
 
 HerderImpl::HerderImpl(Application& app)
     : mPendingTransactions(4)
+    , mValidTxs(MAX_VALID_TRANSACTIONS_TO_REMEMBER)
     , mPendingEnvelopes(app, *this)
     , mUpgrades(app.getConfig())
     , mHerderSCPDriver(app, *this, mUpgrades, mPendingEnvelopes)
@@ -140,34 +154,6 @@ HerderImpl::updateSCPCounters()
         getSCP().getCumulativeStatemtCount());
 }
 
-static uint64_t
-countTxs(HerderImpl::AccountTxMap const& acc)
-{
-    uint64_t sz = 0;
-    for (auto const& a : acc)
-    {
-        sz += a.second->mTransactions.size();
-    }
-    return sz;
-}
-
-static std::shared_ptr<HerderImpl::TxMap>
-findOrAdd(HerderImpl::AccountTxMap& acc, AccountID const& aid)
-{
-    std::shared_ptr<HerderImpl::TxMap> txmap = nullptr;
-    auto i = acc.find(aid);
-    if (i == acc.end())
-    {
-        txmap = std::make_shared<HerderImpl::TxMap>();
-        acc.insert(std::make_pair(aid, txmap));
-    }
-    else
-    {
-        txmap = i->second;
-    }
-    return txmap;
-}
-
 void
 HerderImpl::valueExternalized(uint64 slotIndex, StellarValue const& value)
 {
@@ -266,31 +252,6 @@ HerderImpl::emitEnvelope(SCPEnvelope const& envelope)
     startRebroadcastTimer();
 }
 
-void
-HerderImpl::TxMap::addTx(TransactionFramePtr tx)
-{
-    auto const& h = tx->getFullHash();
-    if (mTransactions.find(h) != mTransactions.end())
-    {
-        return;
-    }
-    mTransactions.insert(std::make_pair(h, tx));
-    mMaxSeq = std::max(tx->getSeqNum(), mMaxSeq);
-    mTotalFees += tx->getFee();
-}
-
-void
-HerderImpl::TxMap::recalculate()
-{
-    mMaxSeq = 0;
-    mTotalFees = 0;
-    for (auto const& pair : mTransactions)
-    {
-        mMaxSeq = std::max(pair.second->getSeqNum(), mMaxSeq);
-        mTotalFees += pair.second->getFee();
-    }
-}
-
 Herder::TransactionSubmitStatus
 HerderImpl::recvTransaction(TransactionFramePtr tx)
 {
@@ -302,26 +263,14 @@ HerderImpl::recvTransaction(TransactionFramePtr tx)
 
     // determine if we have seen this tx before and if not if it has the right
     // seq num
-    int64_t totFee = tx->getFee();
-    SequenceNumber highSeq = 0;
-
-    for (auto& map : mPendingTransactions)
+    if (mPendingTransactions.contains(txID))
     {
-        auto i = map.find(acc);
-        if (i != map.end())
-        {
-            auto& txmap = i->second;
-            auto j = txmap->mTransactions.find(txID);
-            if (j != txmap->mTransactions.end())
-            {
-                return TX_STATUS_DUPLICATE;
-            }
-            totFee += txmap->mTotalFees;
-            highSeq = std::max(highSeq, txmap->mMaxSeq);
-        }
+        return TX_STATUS_DUPLICATE;
     }
+    int64_t totFee = tx->getFee() + mPendingTransactions.getTotalFees(acc);
+    SequenceNumber highSeq = mPendingTransactions.getMaxSeq(acc);
 
-    if (!tx->checkValid(mApp, highSeq))
+    if (!checkTransactionValid(tx, highSeq))
     {
         return TX_STATUS_ERROR;
     }
@@ -336,12 +285,80 @@ HerderImpl::recvTransaction(TransactionFramePtr tx)
         CLOG(TRACE, "Herder") << "recv transaction " << hexAbbrev(txID)
                               << " for " << KeyUtils::toShortString(acc);
 
-    auto txmap = findOrAdd(mPendingTransactions[0], acc);
-    txmap->addTx(tx);
+    mPendingTransactions.add(tx);
 
     return TX_STATUS_PENDING;
 }
 
+bool
+HerderImpl::checkTransactionValid(TransactionFramePtr tx,
+                                  SequenceNumber current)
+{
+    // Whether a transaction is valid only depends on the ledger it's checked
+    // against, besides the sequence number checkValidAgain checks.
+    auto const& lcl = mLedgerManager.getLastClosedLedgerHeader().hash;
+    if (lcl != mValidTxsLedger)
+    {
+        mValidTxs.clear();
+        mValidTxsLedger = lcl;
+    }
+
+    auto const& txID = tx->getFullHash();
+    if (mValidTxs.exists(txID) && tx->checkValidAgain(mApp, current))
+    {
+        mSCPMetrics.mValidTxsHit.Mark();
+        return true;
+    }
+    mSCPMetrics.mValidTxsMiss.Mark();
+
+    if (!tx->checkValid(mApp, current))
+    {
+        return false;
+    }
+    mValidTxs.put(txID, true);
+    return true;
+}
+
+bool
+HerderImpl::recvTransaction(
+    TransactionFramePtr tx,
+    std::function<void(TransactionSubmitStatus)> handler)
+{
+    if (mTxsToCheck.size() >= MAX_TRANSACTIONS_TO_CHECK)
+    {
+        mSCPMetrics.mHerderTxsToCheckDrop.Mark();
+        return false;
+    }
+    uint64 ticket = mTxsToCheckPopped + mTxsToCheck.size();
+    mTxsToCheck.push_back(TxToCheck{tx, handler, false});
+    mSCPMetrics.mHerderTxsToCheck.inc();
+
+    // The transaction is only used by this thread until it's handed back to
+    // the main thread.
+    mApp.getWorkerIOService().post([this, tx, ticket]() {
+        tx->getFullHash();
+        tx->verifySourceKeySignatures();
+        mApp.getClock().getIOService().post([this, ticket]() {
+            mTxsToCheck[ticket - mTxsToCheckPopped].mChecked = true;
+            recvCheckedTransactions();
+        });
+    });
+    return true;
+}
+
+void
+HerderImpl::recvCheckedTransactions()
+{
+    while (!mTxsToCheck.empty() && mTxsToCheck.front().mChecked)
+    {
+        auto checked = std::move(mTxsToCheck.front());
+        mTxsToCheck.pop_front();
+        ++mTxsToCheckPopped;
+        mSCPMetrics.mHerderTxsToCheck.dec();
+        checked.mHandler(recvTransaction(checked.mTx));
+    }
+}
+
 Herder::EnvelopeStatus
 HerderImpl::recvSCPEnvelope(SCPEnvelope const& envelope)
 {
@@ -563,49 +580,6 @@ HerderImpl::ledgerClosed()
                                  &VirtualTimer::onFailureNoop);
 }
 
-void
-HerderImpl::removeReceivedTxs(std::vector<TransactionFramePtr> const& dropTxs)
-{
-    for (auto& m : mPendingTransactions)
-    {
-        if (m.empty())
-        {
-            continue;
-        }
-
-        std::set<std::shared_ptr<TxMap>> toRecalculate;
-
-        for (auto const& tx : dropTxs)
-        {
-            auto const& acc = tx->getSourceID();
-            auto const& txID = tx->getFullHash();
-            auto i = m.find(acc);
-            if (i != m.end())
-            {
-                auto& txs = i->second->mTransactions;
-                auto j = txs.find(txID);
-                if (j != txs.end())
-                {
-                    txs.erase(j);
-                    if (txs.empty())
-                    {
-                        m.erase(i);
-                    }
-                    else
-                    {
-                        toRecalculate.insert(i->second);
-                    }
-                }
-            }
-        }
-
-        for (auto txm : toRecalculate)
-        {
-            txm->recalculate();
-        }
-    }
-}
-
 bool
 HerderImpl::recvSCPQuorumSet(Hash const& hash, const SCPQuorumSet& qset)
 {
@@ -661,17 +635,7 @@ HerderImpl::getCurrentLedgerSeq() const
 SequenceNumber
 HerderImpl::getMaxSeqInPendingTxs(AccountID const& acc)
 {
-    SequenceNumber highSeq = 0;
-    for (auto const& m : mPendingTransactions)
-    {
-        auto i = m.find(acc);
-        if (i == m.end())
-        {
-            continue;
-        }
-        highSeq = std::max(i->second->mMaxSeq, highSeq);
-    }
-    return highSeq;
+    return mPendingTransactions.getMaxSeq(acc);
 }
 
 // called to take a position during the next round
@@ -692,20 +656,14 @@ HerderImpl::triggerNextLedger(uint32_t ledgerSeqToTrigger)
     auto const& lcl = mLedgerManager.getLastClosedLedgerHeader();
     auto proposedSet = std::make_shared<TxSetFrame>(lcl.hash);
 
-    for (auto const& m : mPendingTransactions)
+    for (auto const& tx : mPendingTransactions.getTransactions())
     {
-        for (auto const& pair : m)
-        {
-            for (auto const& tx : pair.second->mTransactions)
-            {
-                proposedSet->add(tx.second);
-            }
-        }
+        proposedSet->add(tx);
     }
 
     std::vector<TransactionFramePtr> removed;
     proposedSet->trimInvalid(mApp, removed);
-    removeReceivedTxs(removed);
+    mPendingTransactions.remove(removed);
 
     proposedSet->surgePricingFilter(mLedgerManager);
 
@@ -976,28 +934,27 @@ HerderImpl::updatePendingTransactions(
     std::vector<TransactionFramePtr> const& applied)
 {
     // remove all these tx from mPendingTransactions
-    removeReceivedTxs(applied);
-
-    // drop the highest level
-    mPendingTransactions.erase(--mPendingTransactions.end());
+    for (auto const& tx : applied)
+    {
+        uint32_t age;
+        if (mPendingTransactions.getAge(tx->getFullHash(), age))
+        {
+            mSCPMetrics.mHerderPendingTxsAppliedAge.Update(age);
+        }
+    }
+    mPendingTransactions.remove(applied);
 
-    // shift entries up
-    mPendingTransactions.emplace_front();
+    // age entries, dropping the oldest
+    mPendingTransactions.shift();
 
     // rebroadcast entries, sorted in apply-order to maximize chances of
     // propagation
     {
         Hash h;
         TxSetFrame toBroadcast(h);
-        for (auto const& l : mPendingTransactions)
+        for (auto const& tx : mPendingTransactions.getTransactions())
         {
-            for (auto const& pair : l)
-            {
-                for (auto const& tx : pair.second->mTransactions)
-                {
-                    toBroadcast.add(tx.second);
-                }
-            }
+            toBroadcast.add(tx);
         }
         for (auto tx : toBroadcast.sortForApply())
         {
@@ -1006,10 +963,15 @@ HerderImpl::updatePendingTransactions(
         }
     }
 
-    mSCPMetrics.mHerderPendingTxs0.set_count(countTxs(mPendingTransactions[0]));
-    mSCPMetrics.mHerderPendingTxs1.set_count(countTxs(mPendingTransactions[1]));
-    mSCPMetrics.mHerderPendingTxs2.set_count(countTxs(mPendingTransactions[2]));
-    mSCPMetrics.mHerderPendingTxs3.set_count(countTxs(mPendingTransactions[3]));
+    mSCPMetrics.mHerderPendingTxs0.set_count(
+        mPendingTransactions.sizeOfAge(0));
+    mSCPMetrics.mHerderPendingTxs1.set_count(
+        mPendingTransactions.sizeOfAge(1));
+    mSCPMetrics.mHerderPendingTxs2.set_count(
+        mPendingTransactions.sizeOfAge(2));
+    mSCPMetrics.mHerderPendingTxs3.set_count(
+        mPendingTransactions.sizeOfAge(3));
+    mSCPMetrics.mHerderPendingTxsSize.set_count(mPendingTransactions.size());
 }
 
 void
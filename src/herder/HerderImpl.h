@@ -5,11 +5,15 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "PendingEnvelopes.h"
+#include "herder/PendingTransactions.h"
 #include "herder/Herder.h"
 #include "herder/HerderSCPDriver.h"
 #include "herder/Upgrades.h"
+#include "lib/util/lrucache.hpp"
+#include "util/HashOfHash.h"
 #include "util/Timer.h"
 #include <deque>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +22,7 @@ namespace medida
 {
 class Meter;
 class Counter;
+class Histogram;
 class Timer;
 }
 
@@ -61,6 +66,11 @@ class HerderImpl : public Herder
     void emitEnvelope(SCPEnvelope const& envelope);
 
     TransactionSubmitStatus recvTransaction(TransactionFramePtr tx) override;
+    bool recvTransaction(
+        TransactionFramePtr tx,
+        std::function<void(TransactionSubmitStatus)> handler) override;
+    bool checkTransactionValid(TransactionFramePtr tx,
+                               SequenceNumber current) override;
 
     EnvelopeStatus recvSCPEnvelope(SCPEnvelope const& envelope) override;
 
@@ -87,20 +97,8 @@ class HerderImpl : public Herder
     void dumpQuorumInfo(Json::Value& ret, NodeID const& id, bool summary,
                         uint64 index) override;
 
-    struct TxMap
-    {
-        SequenceNumber mMaxSeq{0};
-        int64_t mTotalFees{0};
-        std::unordered_map<Hash, TransactionFramePtr> mTransactions;
-        void addTx(TransactionFramePtr);
-        void recalculate();
-    };
-    typedef std::unordered_map<AccountID, std::shared_ptr<TxMap>> AccountTxMap;
-
   private:
     void ledgerClosed();
-    void removeReceivedTxs(std::vector<TransactionFramePtr> const& txs);
-
     void startRebroadcastTimer();
     void rebroadcast();
     void broadcast(SCPEnvelope const& e);
@@ -109,11 +107,34 @@ class HerderImpl : public Herder
 
     void processSCPQueueUpToIndex(uint64 slotIndex);
 
-    // 0- tx we got during ledger close
-    // 1- one ledger ago. rebroadcast
-    // 2- two ledgers ago. rebroadcast
+    // age 0- tx we got during ledger close
+    // age 1- one ledger ago. rebroadcast
+    // age 2- two ledgers ago. rebroadcast
     // ...
-    std::deque<AccountTxMap> mPendingTransactions;
+    PendingTransactions mPendingTransactions;
+
+    // hashes of the transactions found valid against mValidTxsLedger
+    cache::lru_cache<Hash, bool> mValidTxs;
+    Hash mValidTxsLedger;
+
+    // Flooded transactions being hashed and verified on worker threads, in
+    // the order they were received. Workers may finish them in any order, but
+    // they are passed on to recvTransaction in this one, so that a
+    // transaction isn't checked before the ones of the same account it
+    // follows.
+    struct TxToCheck
+    {
+        TransactionFramePtr mTx;
+        std::function<void(TransactionSubmitStatus)> mHandler;
+        bool mChecked;
+    };
+    std::deque<TxToCheck> mTxsToCheck;
+    // number of transactions ever taken off the front of mTxsToCheck
+    uint64 mTxsToCheckPopped{0};
+
+    // passes on the transactions at the front of mTxsToCheck that are
+    // checked already
+    void recvCheckedTransactions();
 
     void
     updatePendingTransactions(std::vector<TransactionFramePtr> const& applied);
@@ -170,6 +191,17 @@ class HerderImpl : public Herder
         medida::Counter& mHerderPendingTxs1;
         medida::Counter& mHerderPendingTxs2;
         medida::Counter& mHerderPendingTxs3;
+        medida::Counter& mHerderPendingTxsSize;
+        // ledgers transactions were pending before being applied
+        medida::Histogram& mHerderPendingTxsAppliedAge;
+
+        // Received transactions waiting to be checked, and those dropped
+        // as too many were
+        medida::Counter& mHerderTxsToCheck;
+        medida::Meter& mHerderTxsToCheckDrop;
+
+        medida::Meter& mValidTxsHit;
+        medida::Meter& mValidTxsMiss;
 
         SCPMetrics(Application& app);
     };
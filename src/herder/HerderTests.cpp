@@ -17,6 +17,8 @@
 #include "ledger/LedgerManager.h"
 #include "lib/catch.hpp"
 #include "main/CommandHandler.h"
+#include "medida/meter.h"
+#include "medida/metrics_registry.h"
 #include "overlay/OverlayManager.h"
 #include "simulation/Simulation.h"
 #include "test/TxTests.h"
@@ -52,6 +54,56 @@ TEST_CASE("standalone", "[herder]")
 
     const int64_t paymentAmount = app->getLedgerManager().getMinBalance(0);
 
+    SECTION("flooded transactions are checked on worker threads")
+    {
+        auto tx = root.tx({createAccount(a1, paymentAmount)});
+        bool done = false;
+        REQUIRE(app->getHerder().recvTransaction(
+            tx, [&](Herder::TransactionSubmitStatus status) {
+                REQUIRE(status == Herder::TX_STATUS_PENDING);
+                done = true;
+            }));
+        while (!done)
+        {
+            app->getClock().crank(true);
+        }
+        REQUIRE(app->getHerder().recvTransaction(tx) ==
+                Herder::TX_STATUS_DUPLICATE);
+    }
+
+    SECTION("flooded transactions of an account are checked in sequence")
+    {
+        // workers may finish them in any order, but each transaction is only
+        // valid once the one before it is pending
+        std::vector<TransactionFramePtr> txs;
+        for (int i = 0; i < 50; i++)
+        {
+            auto dest = getAccount(("chain" + std::to_string(i)).c_str());
+            txs.push_back(
+                root.tx({createAccount(dest.getPublicKey(), paymentAmount)}));
+        }
+
+        std::vector<Herder::TransactionSubmitStatus> statuses;
+        for (auto const& tx : txs)
+        {
+            REQUIRE(app->getHerder().recvTransaction(
+                tx, [&statuses](Herder::TransactionSubmitStatus status) {
+                    statuses.push_back(status);
+                }));
+        }
+        while (statuses.size() < txs.size())
+        {
+            app->getClock().crank(true);
+        }
+        REQUIRE(statuses == std::vector<Herder::TransactionSubmitStatus>(
+                                txs.size(), Herder::TX_STATUS_PENDING));
+        for (auto const& tx : txs)
+        {
+            REQUIRE(app->getHerder().recvTransaction(tx) ==
+                    Herder::TX_STATUS_DUPLICATE);
+        }
+    }
+
     SECTION("basic ledger close on valid txs")
     {
         bool stop = false;
@@ -223,6 +275,20 @@ TEST_CASE("txset", "[herder]")
             txSet->trimInvalid(*app, removed);
             REQUIRE(txSet->checkValid(*app));
         }
+        SECTION("transactions found valid are remembered")
+        {
+            auto& hits = app->getMetrics().NewMeter(
+                {"herder", "valid-txs-cache", "hit"}, "transaction");
+            REQUIRE(txSet->checkValid(*app));
+            auto before = hits.count();
+
+            // same transactions, as received from a peer
+            TransactionSet xdrSet;
+            txSet->toXDR(xdrSet);
+            TxSetFrame received(app->getNetworkID(), xdrSet);
+            REQUIRE(received.checkValid(*app));
+            REQUIRE(hits.count() == before + txSet->size());
+        }
         SECTION("out of order")
         {
             std::swap(txSet->mTransactions[0], txSet->mTransactions[1]);
@@ -574,6 +640,34 @@ TEST_CASE("SCP Driver", "[herder]")
                     Herder::ENVELOPE_STATUS_PROCESSED);
         }
 
+        SECTION("processed envelope is not fetched again when re-received")
+        {
+            PendingEnvelopes pendingEnvelopes{*app, herder};
+            auto slotIndex = saneEnvelopeQ1T1.statement.slotIndex;
+            auto txSetHash = p1.second->getContentsHash();
+
+            pendingEnvelopes.addSCPQuorumSet(saneQSet1Hash, 0, saneQSet1);
+            pendingEnvelopes.addTxSet(txSetHash, 0, p1.second);
+            REQUIRE(pendingEnvelopes.recvSCPEnvelope(saneEnvelopeQ1T1) ==
+                    Herder::ENVELOPE_STATUS_READY);
+
+            // added again with no known slot, as when restoring SCP state;
+            // re-receiving the processed envelope must not mark them with its
+            // slot, nor fetch them again
+            pendingEnvelopes.addSCPQuorumSet(saneQSet1Hash, 0, saneQSet1);
+            pendingEnvelopes.addTxSet(txSetHash, 0, p1.second);
+
+            REQUIRE(pendingEnvelopes.recvSCPEnvelope(saneEnvelopeQ1T1) ==
+                    Herder::ENVELOPE_STATUS_PROCESSED);
+            REQUIRE(!pendingEnvelopes.recvSCPQuorumSet(saneQSet1Hash,
+                                                       saneQSet1));
+            REQUIRE(!pendingEnvelopes.recvTxSet(txSetHash, p1.second));
+
+            pendingEnvelopes.eraseBelow(slotIndex + 1);
+            REQUIRE(pendingEnvelopes.getQSet(saneQSet1Hash));
+            REQUIRE(pendingEnvelopes.getTxSet(txSetHash));
+        }
+
         SECTION("only accepts qset once")
         {
             REQUIRE(herder.recvSCPEnvelope(saneEnvelopeQ1T1) ==
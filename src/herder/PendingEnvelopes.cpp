@@ -186,33 +186,26 @@ PendingEnvelopes::recvSCPEnvelope(SCPEnvelope const& envelope)
 
     try
     {
-        if (isDiscarded(envelope))
+        auto slotIndex = envelope.statement.slotIndex;
+        auto hash = envelopeHash(envelope);
+        if (isDiscarded(slotIndex, hash))
         {
             return Herder::ENVELOPE_STATUS_DISCARDED;
         }
 
-        touchFetchCache(envelope);
-
-        auto& set = mEnvelopes[envelope.statement.slotIndex].mFetchingEnvelopes;
-        auto& processedList =
-            mEnvelopes[envelope.statement.slotIndex].mProcessedEnvelopes;
+        auto& slot = mEnvelopes[slotIndex];
+        if (slot.mProcessedEnvelopes.count(hash) != 0)
+        {
+            // we already have this one
+            return Herder::ENVELOPE_STATUS_PROCESSED;
+        }
 
-        auto fetching = find(set.begin(), set.end(), envelope);
+        touchFetchCache(envelope);
 
-        if (fetching == set.end())
-        { // we aren't fetching this envelope
-            if (find(processedList.begin(), processedList.end(), envelope) ==
-                processedList.end())
-            { // we haven't seen this envelope before
-                // insert it into the fetching set
-                fetching = set.insert(envelope).first;
-                startFetch(envelope);
-            }
-            else
-            {
-                // we already have this one
-                return Herder::ENVELOPE_STATUS_PROCESSED;
-            }
+        if (slot.mFetchingEnvelopes.emplace(hash, envelope).second)
+        {
+            // we haven't seen this envelope before
+            startFetch(envelope);
         }
 
         // we are fetching this envelope
@@ -220,8 +213,8 @@ PendingEnvelopes::recvSCPEnvelope(SCPEnvelope const& envelope)
         if (isFullyFetched(envelope))
         {
             // move the item from fetching to processed
-            processedList.emplace_back(*fetching);
-            set.erase(fetching);
+            slot.mFetchingEnvelopes.erase(hash);
+            slot.mProcessedEnvelopes.insert(hash);
             envelopeReady(envelope);
             return Herder::ENVELOPE_STATUS_READY;
         } // else just keep waiting for it to come in
@@ -242,18 +235,14 @@ PendingEnvelopes::discardSCPEnvelope(SCPEnvelope const& envelope)
 {
     try
     {
-        if (isDiscarded(envelope))
+        auto& slot = mEnvelopes[envelope.statement.slotIndex];
+        auto hash = envelopeHash(envelope);
+        if (!slot.mDiscardedEnvelopes.insert(hash).second)
         {
             return;
         }
 
-        auto& discardedSet =
-            mEnvelopes[envelope.statement.slotIndex].mDiscardedEnvelopes;
-        discardedSet.insert(envelope);
-
-        auto& fetchingSet =
-            mEnvelopes[envelope.statement.slotIndex].mFetchingEnvelopes;
-        fetchingSet.erase(envelope);
+        slot.mFetchingEnvelopes.erase(hash);
 
         stopFetch(envelope);
     }
@@ -265,19 +254,28 @@ PendingEnvelopes::discardSCPEnvelope(SCPEnvelope const& envelope)
     }
 }
 
+Hash
+PendingEnvelopes::envelopeHash(SCPEnvelope const& envelope)
+{
+    return sha256(xdr::xdr_to_opaque(envelope));
+}
+
 bool
 PendingEnvelopes::isDiscarded(SCPEnvelope const& envelope) const
 {
-    auto envelopes = mEnvelopes.find(envelope.statement.slotIndex);
+    return isDiscarded(envelope.statement.slotIndex, envelopeHash(envelope));
+}
+
+bool
+PendingEnvelopes::isDiscarded(uint64 slotIndex, Hash const& envelopeHash) const
+{
+    auto envelopes = mEnvelopes.find(slotIndex);
     if (envelopes == mEnvelopes.end())
     {
         return false;
     }
 
-    auto& discardedSet = envelopes->second.mDiscardedEnvelopes;
-    auto discarded =
-        std::find(std::begin(discardedSet), std::end(discardedSet), envelope);
-    return discarded != discardedSet.end();
+    return envelopes->second.mDiscardedEnvelopes.count(envelopeHash) != 0;
 }
 
 void
@@ -480,7 +478,7 @@ PendingEnvelopes::dumpInfo(Json::Value& ret, size_t limit)
                 Json::Value& slot = q[std::to_string(it->first)]["fetching"];
                 for (auto const& e : it->second.mFetchingEnvelopes)
                 {
-                    slot.append(mHerder.getSCP().envToStr(e));
+                    slot.append(mHerder.getSCP().envToStr(e.second));
                 }
             }
             if (it->second.mReadyEnvelopes.size() != 0)
@@ -4,11 +4,14 @@
 #include "lib/json/json.h"
 #include "lib/util/lrucache.hpp"
 #include "overlay/ItemFetcher.h"
+#include "util/HashOfHash.h"
 #include <autocheck/function.hpp>
 #include <map>
 #include <medida/medida.h>
 #include <queue>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <util/optional.h>
 
 /*
@@ -21,14 +24,16 @@ namespace stellar
 
 class HerderImpl;
 
+// Envelopes are known by the hash of their XDR, so that telling whether one
+// was seen before doesn't compare it with every envelope of the slot.
 struct SlotEnvelopes
 {
-    // list of envelopes we have processed already
-    std::vector<SCPEnvelope> mProcessedEnvelopes;
-    // list of envelopes we have discarded already
-    std::set<SCPEnvelope> mDiscardedEnvelopes;
-    // list of envelopes we are fetching right now
-    std::set<SCPEnvelope> mFetchingEnvelopes;
+    // envelopes we have processed already
+    std::unordered_set<Hash> mProcessedEnvelopes;
+    // envelopes we have discarded already
+    std::unordered_set<Hash> mDiscardedEnvelopes;
+    // envelopes we are fetching right now
+    std::unordered_map<Hash, SCPEnvelope> mFetchingEnvelopes;
     // list of ready envelopes that haven't been sent to SCP yet
     std::vector<SCPEnvelope> mReadyEnvelopes;
 };
@@ -60,6 +65,9 @@ class PendingEnvelopes
     // returns true if we think that the node is in quorum
     bool isNodeInQuorum(NodeID const& node);
 
+    static Hash envelopeHash(SCPEnvelope const& envelope);
+    bool isDiscarded(uint64 slotIndex, Hash const& envelopeHash) const;
+
     // discards all SCP envelopes thats use QSet with given hash,
     // as it is not sane QSet
     void discardSCPEnvelopesWithQSet(Hash hash);
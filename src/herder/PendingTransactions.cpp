@@ -0,0 +1,149 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "herder/PendingTransactions.h"
+#include <algorithm>
+#include <cassert>
+
+namespace stellar
+{
+
+void
+PendingTransactions::AccountTxs::recalculate()
+{
+    mMaxSeq = 0;
+    mTotalFees = 0;
+    for (auto const& tx : mTransactions)
+    {
+        mMaxSeq = std::max(tx->getSeqNum(), mMaxSeq);
+        mTotalFees += tx->getFee();
+    }
+}
+
+PendingTransactions::PendingTransactions(uint32_t maxAge)
+    : mMaxAge(maxAge), mSizeByAge(maxAge, 0)
+{
+    assert(maxAge > 0);
+}
+
+bool
+PendingTransactions::contains(Hash const& txID) const
+{
+    return mTransactions.find(txID) != mTransactions.end();
+}
+
+bool
+PendingTransactions::add(TransactionFramePtr tx)
+{
+    if (!mTransactions.emplace(tx->getFullHash(), Entry{tx, 0}).second)
+    {
+        return false;
+    }
+    ++mSizeByAge[0];
+
+    auto& acc = mAccounts[tx->getSourceID()];
+    acc.mTransactions.emplace_back(tx);
+    acc.mMaxSeq = std::max(tx->getSeqNum(), acc.mMaxSeq);
+    acc.mTotalFees += tx->getFee();
+    return true;
+}
+
+void
+PendingTransactions::remove(std::vector<TransactionFramePtr> const& txs)
+{
+    for (auto const& tx : txs)
+    {
+        auto it = mTransactions.find(tx->getFullHash());
+        if (it == mTransactions.end())
+        {
+            continue;
+        }
+        --mSizeByAge[it->second.mAge];
+        // Remove the pending frame: it may be a different object than `tx`.
+        auto pending = it->second.mTx;
+        mTransactions.erase(it);
+
+        auto accIt = mAccounts.find(pending->getSourceID());
+        assert(accIt != mAccounts.end());
+        auto& accTxs = accIt->second.mTransactions;
+        accTxs.erase(std::find(accTxs.begin(), accTxs.end(), pending));
+        if (accTxs.empty())
+        {
+            mAccounts.erase(accIt);
+        }
+        else
+        {
+            accIt->second.recalculate();
+        }
+    }
+}
+
+void
+PendingTransactions::shift()
+{
+    std::vector<TransactionFramePtr> expired;
+    for (auto& tx : mTransactions)
+    {
+        if (++tx.second.mAge == mMaxAge)
+        {
+            expired.emplace_back(tx.second.mTx);
+        }
+    }
+    // Expired transactions are briefly counted with age mMaxAge, while they
+    // are removed.
+    mSizeByAge.insert(mSizeByAge.begin(), 0);
+    remove(expired);
+    mSizeByAge.pop_back();
+}
+
+SequenceNumber
+PendingTransactions::getMaxSeq(AccountID const& acc) const
+{
+    auto it = mAccounts.find(acc);
+    return it == mAccounts.end() ? 0 : it->second.mMaxSeq;
+}
+
+int64_t
+PendingTransactions::getTotalFees(AccountID const& acc) const
+{
+    auto it = mAccounts.find(acc);
+    return it == mAccounts.end() ? 0 : it->second.mTotalFees;
+}
+
+bool
+PendingTransactions::getAge(Hash const& txID, uint32_t& age) const
+{
+    auto it = mTransactions.find(txID);
+    if (it == mTransactions.end())
+    {
+        return false;
+    }
+    age = it->second.mAge;
+    return true;
+}
+
+std::vector<TransactionFramePtr>
+PendingTransactions::getTransactions() const
+{
+    std::vector<TransactionFramePtr> res;
+    res.reserve(mTransactions.size());
+    for (auto const& tx : mTransactions)
+    {
+        res.emplace_back(tx.second.mTx);
+    }
+    return res;
+}
+
+size_t
+PendingTransactions::size() const
+{
+    return mTransactions.size();
+}
+
+size_t
+PendingTransactions::sizeOfAge(uint32_t age) const
+{
+    return age < mMaxAge ? mSizeByAge[age] : 0;
+}
+}
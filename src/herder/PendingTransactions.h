@@ -0,0 +1,74 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "transactions/TransactionFrame.h"
+#include "util/HashOfHash.h"
+#include <unordered_map>
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * Transactions received by the herder that haven't made it into a ledger
+ * yet, with the number of ledgers closed since each was received (its age).
+ *
+ * Transactions are indexed by hash, for duplicate checks, and grouped by
+ * source account, which keeps the highest sequence number and the total fees
+ * of its pending transactions at hand.
+ */
+class PendingTransactions
+{
+    struct Entry
+    {
+        TransactionFramePtr mTx;
+        uint32_t mAge;
+    };
+
+    struct AccountTxs
+    {
+        SequenceNumber mMaxSeq{0};
+        int64_t mTotalFees{0};
+        std::vector<TransactionFramePtr> mTransactions;
+
+        void recalculate();
+    };
+
+    uint32_t const mMaxAge;
+    std::unordered_map<Hash, Entry> mTransactions;
+    std::unordered_map<AccountID, AccountTxs> mAccounts;
+    // number of transactions of each age
+    std::vector<size_t> mSizeByAge;
+
+  public:
+    // Transactions are dropped once they reach `maxAge`.
+    explicit PendingTransactions(uint32_t maxAge);
+
+    bool contains(Hash const& txID) const;
+
+    // Adds `tx` with age 0, unless it is already pending.
+    bool add(TransactionFramePtr tx);
+
+    // Removes those of `txs` that are pending.
+    void remove(std::vector<TransactionFramePtr> const& txs);
+
+    // Ages every transaction by one ledger, dropping those reaching the
+    // maximum age.
+    void shift();
+
+    // 0 if the account has no pending transaction.
+    SequenceNumber getMaxSeq(AccountID const& acc) const;
+    int64_t getTotalFees(AccountID const& acc) const;
+
+    // Age of the pending transaction `txID`, if there is one.
+    bool getAge(Hash const& txID, uint32_t& age) const;
+
+    std::vector<TransactionFramePtr> getTransactions() const;
+
+    size_t size() const;
+    size_t sizeOfAge(uint32_t age) const;
+};
+}
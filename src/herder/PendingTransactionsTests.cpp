@@ -0,0 +1,78 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "herder/PendingTransactions.h"
+#include "lib/catch.hpp"
+#include "main/Application.h"
+#include "test/TestAccount.h"
+#include "test/TestUtils.h"
+#include "test/TxTests.h"
+#include "test/test.h"
+
+using namespace stellar;
+using namespace stellar::txtest;
+
+TEST_CASE("pending transactions", "[herder]")
+{
+    VirtualClock clock;
+    Application::pointer app = createTestApplication(clock, getTestConfig());
+    app->start();
+
+    auto root = TestAccount::createRoot(*app);
+    auto a1 = getAccount("A");
+    auto b1 = getAccount("B");
+    auto rootSeq = root.getLastSequenceNumber();
+    auto tx1 = createPaymentTx(*app, root, a1.getPublicKey(), rootSeq + 1, 10);
+    auto tx2 = createPaymentTx(*app, root, b1.getPublicKey(), rootSeq + 2, 10);
+    auto tx3 = createPaymentTx(*app, a1, b1.getPublicKey(), 5, 10);
+
+    PendingTransactions pending(3);
+    REQUIRE(pending.add(tx1));
+    REQUIRE(!pending.add(tx1));
+    REQUIRE(pending.contains(tx1->getFullHash()));
+    REQUIRE(!pending.contains(tx2->getFullHash()));
+    REQUIRE(pending.getMaxSeq(root.getPublicKey()) == rootSeq + 1);
+
+    pending.shift();
+    REQUIRE(pending.add(tx2));
+    REQUIRE(pending.add(tx3));
+    REQUIRE(pending.size() == 3);
+    REQUIRE(pending.sizeOfAge(0) == 2);
+    REQUIRE(pending.sizeOfAge(1) == 1);
+    REQUIRE(pending.getMaxSeq(root.getPublicKey()) == rootSeq + 2);
+    REQUIRE(pending.getTotalFees(root.getPublicKey()) ==
+            tx1->getFee() + tx2->getFee());
+    REQUIRE(pending.getMaxSeq(a1.getPublicKey()) == 5);
+
+    uint32_t age;
+    REQUIRE(pending.getAge(tx1->getFullHash(), age));
+    REQUIRE(age == 1);
+
+    SECTION("remove")
+    {
+        pending.remove({tx2, tx3});
+        REQUIRE(pending.size() == 1);
+        REQUIRE(pending.getMaxSeq(root.getPublicKey()) == rootSeq + 1);
+        REQUIRE(pending.getTotalFees(root.getPublicKey()) == tx1->getFee());
+        REQUIRE(pending.getMaxSeq(a1.getPublicKey()) == 0);
+        REQUIRE(pending.getTotalFees(a1.getPublicKey()) == 0);
+        REQUIRE(pending.sizeOfAge(0) == 0);
+    }
+
+    SECTION("oldest transactions are dropped")
+    {
+        pending.shift();
+        REQUIRE(pending.size() == 3);
+        REQUIRE(pending.sizeOfAge(2) == 1);
+        pending.shift();
+        REQUIRE(pending.size() == 2);
+        REQUIRE(!pending.contains(tx1->getFullHash()));
+        REQUIRE(pending.getMaxSeq(root.getPublicKey()) == rootSeq + 2);
+        REQUIRE(pending.sizeOfAge(0) == 0);
+        REQUIRE(pending.sizeOfAge(2) == 2);
+        pending.shift();
+        REQUIRE(pending.size() == 0);
+        REQUIRE(pending.getTransactions().empty());
+    }
+}
@@ -7,11 +7,17 @@
 #include "crypto/Hex.h"
 #include "crypto/SHA.h"
 #include "database/Database.h"
+#include "herder/Herder.h"
+#include "ledger/EntryFrame.h"
 #include "main/Application.h"
 #include "main/Config.h"
+#include "medida/metrics_registry.h"
+#include "medida/timer.h"
+#include "transactions/SignatureBatch.h"
 #include "util/Logging.h"
 #include "xdrpp/marshal.h"
 #include <algorithm>
+#include <thread>
 
 #include "xdrpp/printer.h"
 
@@ -186,6 +192,48 @@ TxSetFrame::surgePricingFilter(LedgerManager const& lm)
     }
 }
 
+void
+TxSetFrame::verifySignatures(Application& app) const
+{
+    auto timer = app.getMetrics()
+                     .NewTimer({"herder", "txset", "verify-signatures"})
+                     .TimeScope();
+    auto& db = app.getDatabase();
+
+    // The signers of the source accounts are needed to know which keys the
+    // signatures are by: load the accounts in batches first, as long as the
+    // cache holds them.
+    auto maxKeys = db.getEntryCache().getMaxSize() / 2;
+    std::unordered_set<LedgerKey> keys;
+    for (auto const& tx : mTransactions)
+    {
+        LedgerKey key;
+        key.type(ACCOUNT);
+        key.account().accountID = tx->getSourceID();
+        keys.insert(key);
+        for (auto const& op : tx->getEnvelope().tx.operations)
+        {
+            if (op.sourceAccount)
+            {
+                key.account().accountID = *op.sourceAccount;
+                keys.insert(key);
+            }
+        }
+    }
+    if (keys.size() <= maxKeys)
+    {
+        EntryFrame::prefetch(keys, db);
+    }
+
+    SignatureBatch batch;
+    for (auto const& tx : mTransactions)
+    {
+        tx->insertSignaturesToVerify(batch, db);
+    }
+    batch.verify(app.getWorkerIOService(),
+                 std::thread::hardware_concurrency());
+}
+
 // TODO.3 this and checkValid share a lot of code
 void
 TxSetFrame::trimInvalid(Application& app,
@@ -195,6 +243,7 @@ TxSetFrame::trimInvalid(Application& app,
     app.getDatabase().setCurrentTransactionReadOnly();
 
     sortForHash();
+    verifySignatures(app);
 
     map<AccountID, vector<TransactionFramePtr>> accountTxMap;
 
@@ -213,7 +262,7 @@ TxSetFrame::trimInvalid(Application& app,
         int64_t totFee = 0;
         for (auto& tx : item.second)
         {
-            if (!tx->checkValid(app, lastSeq))
+            if (!app.getHerder().checkTransactionValid(tx, lastSeq))
             {
                 trimmed.push_back(tx);
                 removeTx(tx);
@@ -289,6 +338,8 @@ TxSetFrame::checkValid(Application& app) const
         lastHash = tx->getFullHash();
     }
 
+    verifySignatures(app);
+
     for (auto& item : accountTxMap)
     {
         // order by sequence number
@@ -299,7 +350,7 @@ TxSetFrame::checkValid(Application& app) const
         int64_t totFee = 0;
         for (auto& tx : item.second)
         {
-            if (!tx->checkValid(app, lastSeq))
+            if (!app.getHerder().checkTransactionValid(tx, lastSeq))
             {
                 CLOG(DEBUG, "Herder")
                     << "bad txSet: " << hexAbbrev(mPreviousLedgerHash)
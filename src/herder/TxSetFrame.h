@@ -21,6 +21,10 @@ class TxSetFrame
 
     Hash mPreviousLedgerHash;
 
+    // Verify the signatures of the transactions on the worker threads, so
+    // that checking them finds the results in the verification cache.
+    void verifySignatures(Application& app) const;
+
   public:
     std::vector<TransactionFramePtr> mTransactions;
 
@@ -0,0 +1,669 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+// ASIO is somewhat particular about when it gets included -- it wants to be the
+// first to include <windows.h> -- so we try to include it before everything
+// else.
+#include "util/asio.h"
+#include "history/ArchiveFetcher.h"
+#include "main/Application.h"
+#include "util/Logging.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
+#include <vector>
+
+namespace stellar
+{
+
+namespace
+{
+// Connections kept open per server between fetches.
+size_t const MAX_IDLE_CONNECTIONS = 16;
+
+size_t const COPY_BUFFER_SIZE = 1024 * 1024;
+
+std::string
+toLower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+std::string
+trim(std::string const& s)
+{
+    auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+    {
+        return "";
+    }
+    auto last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+}
+
+struct ArchiveFetcher::Pool
+{
+    std::map<std::string, std::vector<std::shared_ptr<Connection>>> mIdle;
+
+    medida::Meter& mConnect;
+    medida::Meter& mReuse;
+    medida::Meter& mBytes;
+    medida::Meter& mFailure;
+
+    explicit Pool(Application& app)
+        : mConnect(app.getMetrics().NewMeter({"history", "fetch", "connect"},
+                                             "connection"))
+        , mReuse(app.getMetrics().NewMeter({"history", "fetch", "reuse"},
+                                           "connection"))
+        , mBytes(
+              app.getMetrics().NewMeter({"history", "fetch", "bytes"}, "byte"))
+        , mFailure(app.getMetrics().NewMeter({"history", "fetch", "failure"},
+                                             "event"))
+    {
+    }
+};
+
+// One HTTP/1.1 connection to a server, fetching one file at a time. Once a
+// file is fetched, it puts itself back in the pool if the server lets it stay
+// open.
+class ArchiveFetcher::Connection
+    : public std::enable_shared_from_this<ArchiveFetcher::Connection>
+{
+    enum BodyState
+    {
+        BODY_LENGTH,
+        BODY_UNTIL_CLOSE,
+        BODY_CHUNK_SIZE,
+        BODY_CHUNK_DATA,
+        BODY_CHUNK_END,
+        BODY_TRAILER
+    };
+
+    std::weak_ptr<Pool> mPool;
+    std::string mKey;
+    std::string mHost;
+    unsigned short mPort;
+    asio::ip::tcp::resolver mResolver;
+    asio::ip::tcp::socket mSocket;
+    asio::streambuf mBuffer;
+
+    std::string mRequest;
+    std::string mLocal;
+    std::ofstream mOut;
+    Handler mHandler;
+    // whether the request went over a connection used before, which the
+    // server may have closed since
+    bool mReused{false};
+    bool mGotResponse{false};
+    bool mKeepAlive{false};
+    BodyState mBodyState{BODY_LENGTH};
+    uint64_t mRemaining{0};
+    uint64_t mWritten{0};
+
+    void connect();
+    void send();
+    void onHeaders();
+    void readBody();
+    bool consumeBody();
+    bool readLine(std::string& line);
+    void write(char const* data, size_t size);
+    void fail(asio::error_code const& ec, std::string const& what);
+    void finish(asio::error_code const& ec);
+
+  public:
+    Connection(asio::io_service& io, std::weak_ptr<Pool> pool,
+               std::string const& key, Url const& url);
+
+    void get(std::string const& path, std::string const& local,
+             Handler handler);
+    void close();
+};
+
+ArchiveFetcher::Connection::Connection(asio::io_service& io,
+                                       std::weak_ptr<Pool> pool,
+                                       std::string const& key, Url const& url)
+    : mPool(pool)
+    , mKey(key)
+    , mHost(url.mHost)
+    , mPort(url.mPort)
+    , mResolver(io)
+    , mSocket(io)
+{
+}
+
+void
+ArchiveFetcher::Connection::get(std::string const& path,
+                                std::string const& local, Handler handler)
+{
+    mLocal = local;
+    mHandler = handler;
+    mGotResponse = false;
+    mWritten = 0;
+    mBuffer.consume(mBuffer.size());
+    mRequest = "GET " + path + " HTTP/1.1\r\n" + "Host: " + mHost + ":" +
+               std::to_string(mPort) + "\r\n" + "Accept: */*\r\n" +
+               "Connection: keep-alive\r\n\r\n";
+
+    if (mSocket.is_open())
+    {
+        mReused = true;
+        send();
+    }
+    else
+    {
+        mReused = false;
+        connect();
+    }
+}
+
+void
+ArchiveFetcher::Connection::close()
+{
+    asio::error_code ec;
+    mSocket.close(ec);
+}
+
+void
+ArchiveFetcher::Connection::connect()
+{
+    auto self = shared_from_this();
+    asio::ip::tcp::resolver::query query(mHost, std::to_string(mPort));
+    mResolver.async_resolve(query, [self](asio::error_code const& ec,
+                                          asio::ip::tcp::resolver::iterator i) {
+        if (ec)
+        {
+            self->fail(ec, "resolving " + self->mHost);
+            return;
+        }
+        asio::async_connect(
+            self->mSocket, i,
+            [self](asio::error_code const& ec,
+                   asio::ip::tcp::resolver::iterator) {
+                if (ec)
+                {
+                    self->fail(ec, "connecting to " + self->mKey);
+                    return;
+                }
+                auto pool = self->mPool.lock();
+                if (pool)
+                {
+                    pool->mConnect.Mark();
+                }
+                self->send();
+            });
+    });
+}
+
+void
+ArchiveFetcher::Connection::send()
+{
+    auto self = shared_from_this();
+    asio::async_write(
+        mSocket, asio::buffer(mRequest),
+        [self](asio::error_code const& ec, size_t) {
+            if (ec)
+            {
+                self->fail(ec, "sending request");
+                return;
+            }
+            asio::async_read_until(
+                self->mSocket, self->mBuffer, "\r\n\r\n",
+                [self](asio::error_code const& ec, size_t) {
+                    if (ec)
+                    {
+                        self->fail(ec, "reading response");
+                        return;
+                    }
+                    try
+                    {
+                        self->onHeaders();
+                    }
+                    catch (std::exception& e)
+                    {
+                        self->fail(std::make_error_code(std::errc::io_error),
+                                   e.what());
+                    }
+                });
+        });
+}
+
+void
+ArchiveFetcher::Connection::onHeaders()
+{
+    mGotResponse = true;
+
+    std::istream in(&mBuffer);
+    std::string version;
+    unsigned int status = 0;
+    std::string message;
+    in >> version >> status;
+    std::getline(in, message);
+    if (!in || version.substr(0, 5) != "HTTP/")
+    {
+        mKeepAlive = false;
+        throw std::runtime_error("invalid response");
+    }
+
+    mKeepAlive = version != "HTTP/1.0";
+    bool chunked = false;
+    bool hasLength = false;
+    uint64_t length = 0;
+    std::string line;
+    while (std::getline(in, line) && line != "\r")
+    {
+        auto colon = line.find(':');
+        if (colon == std::string::npos)
+        {
+            continue;
+        }
+        auto name = toLower(trim(line.substr(0, colon)));
+        auto value = toLower(trim(line.substr(colon + 1)));
+        if (name == "content-length")
+        {
+            length = std::stoull(value);
+            hasLength = true;
+        }
+        else if (name == "transfer-encoding")
+        {
+            chunked = value != "identity";
+        }
+        else if (name == "connection")
+        {
+            if (value == "close")
+            {
+                mKeepAlive = false;
+            }
+            else if (value == "keep-alive")
+            {
+                mKeepAlive = true;
+            }
+        }
+    }
+
+    if (status != 200)
+    {
+        mKeepAlive = false;
+        throw std::runtime_error("server returned status " +
+                                 std::to_string(status));
+    }
+
+    if (chunked)
+    {
+        mBodyState = BODY_CHUNK_SIZE;
+    }
+    else if (hasLength)
+    {
+        mBodyState = BODY_LENGTH;
+        mRemaining = length;
+    }
+    else
+    {
+        mBodyState = BODY_UNTIL_CLOSE;
+        mKeepAlive = false;
+    }
+
+    mOut.open(mLocal, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!mOut)
+    {
+        throw std::runtime_error("failed to open " + mLocal);
+    }
+    readBody();
+}
+
+void
+ArchiveFetcher::Connection::readBody()
+{
+    if (consumeBody())
+    {
+        finish(asio::error_code());
+        return;
+    }
+
+    auto self = shared_from_this();
+    asio::async_read(
+        mSocket, mBuffer, asio::transfer_at_least(1),
+        [self](asio::error_code const& ec, size_t) {
+            if (ec == asio::error::eof &&
+                self->mBodyState == BODY_UNTIL_CLOSE)
+            {
+                self->finish(asio::error_code());
+                return;
+            }
+            if (ec)
+            {
+                self->fail(ec, "reading response body");
+                return;
+            }
+            try
+            {
+                self->readBody();
+            }
+            catch (std::exception& e)
+            {
+                self->fail(std::make_error_code(std::errc::io_error),
+                           e.what());
+            }
+        });
+}
+
+bool
+ArchiveFetcher::Connection::readLine(std::string& line)
+{
+    auto data = asio::buffer_cast<char const*>(mBuffer.data());
+    std::string available(data, mBuffer.size());
+    auto end = available.find("\r\n");
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+    line = available.substr(0, end);
+    mBuffer.consume(end + 2);
+    return true;
+}
+
+// Writes out what has been received of the body; returns true once all of it
+// has been.
+bool
+ArchiveFetcher::Connection::consumeBody()
+{
+    while (true)
+    {
+        auto data = asio::buffer_cast<char const*>(mBuffer.data());
+        auto size = mBuffer.size();
+        std::string line;
+        switch (mBodyState)
+        {
+        case BODY_LENGTH:
+        case BODY_CHUNK_DATA:
+        {
+            auto n = static_cast<size_t>(std::min<uint64_t>(size, mRemaining));
+            write(data, n);
+            mBuffer.consume(n);
+            mRemaining -= n;
+            if (mRemaining > 0)
+            {
+                return false;
+            }
+            if (mBodyState == BODY_LENGTH)
+            {
+                return true;
+            }
+            mBodyState = BODY_CHUNK_END;
+            break;
+        }
+        case BODY_UNTIL_CLOSE:
+            write(data, size);
+            mBuffer.consume(size);
+            return false;
+        case BODY_CHUNK_SIZE:
+            if (!readLine(line))
+            {
+                return false;
+            }
+            mRemaining = std::stoull(line.substr(0, line.find(';')), nullptr,
+                                     16);
+            mBodyState = mRemaining == 0 ? BODY_TRAILER : BODY_CHUNK_DATA;
+            break;
+        case BODY_CHUNK_END:
+            if (!readLine(line))
+            {
+                return false;
+            }
+            if (!line.empty())
+            {
+                throw std::runtime_error("malformed chunk");
+            }
+            mBodyState = BODY_CHUNK_SIZE;
+            break;
+        case BODY_TRAILER:
+            if (!readLine(line))
+            {
+                return false;
+            }
+            if (line.empty())
+            {
+                return true;
+            }
+            break;
+        }
+    }
+}
+
+void
+ArchiveFetcher::Connection::write(char const* data, size_t size)
+{
+    mOut.write(data, size);
+    if (!mOut)
+    {
+        throw std::runtime_error("failed to write " + mLocal);
+    }
+    mWritten += size;
+}
+
+void
+ArchiveFetcher::Connection::fail(asio::error_code const& ec,
+                                 std::string const& what)
+{
+    // A connection kept open can have been closed by the server in the
+    // meantime: try again on a new one before giving up.
+    if (mReused && !mGotResponse)
+    {
+        CLOG(DEBUG, "History") << "Reconnecting to " << mKey << " after "
+                               << what << ": " << ec.message();
+        mReused = false;
+        close();
+        mBuffer.consume(mBuffer.size());
+        connect();
+        return;
+    }
+
+    CLOG(WARNING, "History") << "Failed fetching " << mLocal << " from "
+                             << mKey << ": " << what << ": " << ec.message();
+    finish(ec);
+}
+
+void
+ArchiveFetcher::Connection::finish(asio::error_code const& ec)
+{
+    mOut.close();
+    auto handler = mHandler;
+    mHandler = nullptr;
+
+    auto pool = mPool.lock();
+    if (pool)
+    {
+        pool->mBytes.Mark(mWritten);
+    }
+    if (ec)
+    {
+        close();
+        std::remove(mLocal.c_str());
+        if (pool)
+        {
+            pool->mFailure.Mark();
+        }
+    }
+    else if (mKeepAlive && pool &&
+             pool->mIdle[mKey].size() < MAX_IDLE_CONNECTIONS)
+    {
+        pool->mIdle[mKey].push_back(shared_from_this());
+    }
+    else
+    {
+        close();
+    }
+
+    handler(ec);
+}
+
+ArchiveFetcher::ArchiveFetcher(Application& app)
+    : mApp(app), mPool(std::make_shared<Pool>(app))
+{
+}
+
+ArchiveFetcher::~ArchiveFetcher()
+{
+    for (auto& server : mPool->mIdle)
+    {
+        for (auto& connection : server.second)
+        {
+            connection->close();
+        }
+    }
+}
+
+bool
+ArchiveFetcher::parseUrl(std::string const& url, Url& parsed)
+{
+    auto sep = url.find("://");
+    if (sep == std::string::npos)
+    {
+        return false;
+    }
+    parsed.mScheme = url.substr(0, sep);
+    auto rest = url.substr(sep + 3);
+
+    if (parsed.mScheme == "file")
+    {
+        parsed.mHost.clear();
+        parsed.mPort = 0;
+        parsed.mPath = rest;
+        return !rest.empty();
+    }
+    if (parsed.mScheme != "http")
+    {
+        return false;
+    }
+
+    auto slash = rest.find('/');
+    auto hostPort = rest.substr(0, slash);
+    parsed.mPath = slash == std::string::npos ? "/" : rest.substr(slash);
+    auto colon = hostPort.find(':');
+    parsed.mHost = hostPort.substr(0, colon);
+    parsed.mPort = 80;
+    if (colon != std::string::npos)
+    {
+        auto port = hostPort.substr(colon + 1);
+        if (port.empty() || port.size() > 5 ||
+            port.find_first_not_of("0123456789") != std::string::npos ||
+            std::stoul(port) > UINT16_MAX)
+        {
+            return false;
+        }
+        parsed.mPort = static_cast<unsigned short>(std::stoul(port));
+    }
+    return !parsed.mHost.empty();
+}
+
+bool
+ArchiveFetcher::supports(std::string const& url)
+{
+    Url parsed;
+    return parseUrl(url, parsed);
+}
+
+void
+ArchiveFetcher::fetch(std::string const& url, std::string const& local,
+                      Handler handler)
+{
+    Url parsed;
+    if (!parseUrl(url, parsed))
+    {
+        CLOG(WARNING, "History") << "Can't fetch unsupported URL " << url;
+        mApp.getClock().getIOService().post([handler]() {
+            handler(std::make_error_code(std::errc::invalid_argument));
+        });
+        return;
+    }
+
+    if (parsed.mScheme == "file")
+    {
+        fetchFile(parsed.mPath, local, handler);
+        return;
+    }
+
+    auto key = parsed.mHost + ":" + std::to_string(parsed.mPort);
+    std::shared_ptr<Connection> connection;
+    auto& idle = mPool->mIdle[key];
+    if (!idle.empty())
+    {
+        connection = idle.back();
+        idle.pop_back();
+        mPool->mReuse.Mark();
+    }
+    else
+    {
+        connection = std::make_shared<Connection>(
+            mApp.getClock().getIOService(), mPool, key, parsed);
+    }
+    connection->get(parsed.mPath, local, handler);
+}
+
+void
+ArchiveFetcher::fetchFile(std::string const& path, std::string const& local,
+                          Handler handler)
+{
+    Application& app = mApp;
+    std::weak_ptr<Pool> weakPool = mPool;
+    app.getWorkerIOService().post([&app, weakPool, path, local, handler]() {
+        asio::error_code ec;
+        uint64_t bytes = 0;
+        {
+            std::ifstream in(path, std::ios::in | std::ios::binary);
+            std::ofstream out(local,
+                              std::ios::out | std::ios::binary |
+                                  std::ios::trunc);
+            std::vector<char> buffer(COPY_BUFFER_SIZE);
+            while (in && out)
+            {
+                in.read(buffer.data(), buffer.size());
+                out.write(buffer.data(), in.gcount());
+                bytes += in.gcount();
+            }
+            if (!in.eof() || !out)
+            {
+                CLOG(WARNING, "History")
+                    << "Failed copying " << path << " to " << local;
+                ec = std::make_error_code(std::errc::io_error);
+            }
+        }
+        if (ec)
+        {
+            std::remove(local.c_str());
+        }
+        app.getClock().getIOService().post(
+            [weakPool, ec, bytes, handler]() {
+                auto pool = weakPool.lock();
+                if (pool)
+                {
+                    pool->mBytes.Mark(bytes);
+                    if (ec)
+                    {
+                        pool->mFailure.Mark();
+                    }
+                }
+                handler(ec);
+            });
+    });
+}
+
+size_t
+ArchiveFetcher::numIdleConnections() const
+{
+    size_t n = 0;
+    for (auto const& server : mPool->mIdle)
+    {
+        n += server.second.size();
+    }
+    return n;
+}
+}
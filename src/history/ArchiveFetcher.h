@@ -0,0 +1,76 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/NonCopyable.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace asio
+{
+typedef std::error_code error_code;
+};
+
+namespace stellar
+{
+
+class Application;
+
+/**
+ * Fetches files of history archives given by URL, without running a get
+ * command for each of them: file:// URLs are copied on a worker thread, and
+ * http:// URLs are fetched with HTTP/1.1 over connections that are kept open
+ * and reused for the next files from the same server. Each fetch in progress
+ * has a connection of its own, so several can run at once.
+ *
+ * Other schemes, https:// among them, are not supported: archives using them
+ * are read with their get command.
+ *
+ * Like the get commands, fetches don't time out by themselves.
+ */
+class ArchiveFetcher : NonMovableOrCopyable
+{
+  public:
+    typedef std::function<void(asio::error_code const&)> Handler;
+
+    struct Url
+    {
+        std::string mScheme;
+        std::string mHost;
+        unsigned short mPort{0};
+        std::string mPath;
+    };
+
+  private:
+    class Connection;
+    struct Pool;
+
+    Application& mApp;
+    std::shared_ptr<Pool> mPool;
+
+    void fetchFile(std::string const& path, std::string const& local,
+                   Handler handler);
+
+  public:
+    explicit ArchiveFetcher(Application& app);
+    ~ArchiveFetcher();
+
+    // Splits a file:// or http:// URL; returns false for anything else. What
+    // follows file:// is a path, relative to the working directory unless it
+    // starts with a slash.
+    static bool parseUrl(std::string const& url, Url& parsed);
+    static bool supports(std::string const& url);
+
+    // Fetches `url` into the file `local`, then calls `handler` on the main
+    // thread. On failure, `local` is removed.
+    void fetch(std::string const& url, std::string const& local,
+               Handler handler);
+
+    // Number of connections open and waiting for the next fetch.
+    size_t numIdleConnections() const;
+};
+}
@@ -0,0 +1,352 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/asio.h"
+#include "history/ArchiveFetcher.h"
+#include "lib/catch.hpp"
+#include "main/Application.h"
+#include "test/TestUtils.h"
+#include "test/test.h"
+#include "util/Fs.h"
+#include "util/Math.h"
+#include "util/TmpDir.h"
+#include <fstream>
+#include <map>
+#include <sstream>
+
+using namespace stellar;
+
+namespace
+{
+
+std::string
+readFile(std::string const& filename)
+{
+    std::ifstream in(filename, std::ifstream::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+}
+
+// Stand-in for an archive behind a web server: serves `files` over HTTP/1.1
+// on the loopback interface, keeping connections open between requests.
+class TestHttpServer
+{
+    class Session : public std::enable_shared_from_this<Session>
+    {
+        TestHttpServer& mServer;
+        asio::streambuf mBuffer;
+        std::string mResponse;
+        size_t mServed{0};
+
+      public:
+        asio::ip::tcp::socket mSocket;
+
+        Session(TestHttpServer& server, asio::io_service& io)
+            : mServer(server), mSocket(io)
+        {
+        }
+
+        void
+        read()
+        {
+            auto self = shared_from_this();
+            asio::async_read_until(
+                mSocket, mBuffer, "\r\n\r\n",
+                [self](asio::error_code const& ec, size_t size) {
+                    if (!ec)
+                    {
+                        self->respond(size);
+                    }
+                });
+        }
+
+        void
+        respond(size_t size)
+        {
+            std::string request(
+                asio::buffer_cast<char const*>(mBuffer.data()), size);
+            mBuffer.consume(size);
+            auto path = request.substr(4, request.find(' ', 4) - 4);
+            mServer.mRequests++;
+
+            auto file = mServer.mFiles.find(path);
+            if (file == mServer.mFiles.end())
+            {
+                mResponse = "HTTP/1.1 404 Not Found\r\n"
+                            "Content-Length: 0\r\n\r\n";
+            }
+            else if (mServer.mChunked)
+            {
+                // Sent in two chunks, the second with an extension.
+                auto const& body = file->second;
+                auto half = body.size() / 2;
+                std::ostringstream out;
+                out << "HTTP/1.1 200 OK\r\n"
+                    << "Transfer-Encoding: chunked\r\n\r\n"
+                    << std::hex;
+                if (half > 0)
+                {
+                    out << half << "\r\n" << body.substr(0, half) << "\r\n";
+                }
+                if (body.size() > half)
+                {
+                    out << body.size() - half << ";ext=1\r\n"
+                        << body.substr(half) << "\r\n";
+                }
+                out << "0\r\n\r\n";
+                mResponse = out.str();
+            }
+            else
+            {
+                mResponse = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                            std::to_string(file->second.size()) + "\r\n\r\n" +
+                            file->second;
+            }
+
+            auto self = shared_from_this();
+            asio::async_write(
+                mSocket, asio::buffer(mResponse),
+                [self](asio::error_code const& ec, size_t) {
+                    if (ec)
+                    {
+                        return;
+                    }
+                    self->mServed++;
+                    auto max = self->mServer.mRequestsPerConnection;
+                    if (max != 0 && self->mServed >= max)
+                    {
+                        // Close without telling the client, like a server
+                        // timing out idle connections.
+                        self->mSocket.close();
+                        return;
+                    }
+                    self->read();
+                });
+        }
+    };
+
+    asio::io_service& mIO;
+    asio::ip::tcp::acceptor mAcceptor;
+
+    void
+    accept()
+    {
+        auto session = std::make_shared<Session>(*this, mIO);
+        mAcceptor.async_accept(session->mSocket,
+                               [this, session](asio::error_code const& ec) {
+                                   if (ec)
+                                   {
+                                       return;
+                                   }
+                                   mConnections++;
+                                   session->read();
+                                   accept();
+                               });
+    }
+
+  public:
+    std::map<std::string, std::string> mFiles;
+    bool mChunked{false};
+    // 0 to keep connections open for any number of requests
+    size_t mRequestsPerConnection{0};
+    size_t mConnections{0};
+    size_t mRequests{0};
+
+    explicit TestHttpServer(asio::io_service& io)
+        : mIO(io)
+        , mAcceptor(io, asio::ip::tcp::endpoint(
+                            asio::ip::address_v4::loopback(), 0))
+    {
+        accept();
+    }
+
+    ~TestHttpServer()
+    {
+        asio::error_code ec;
+        mAcceptor.close(ec);
+    }
+
+    std::string
+    url() const
+    {
+        return "http://127.0.0.1:" +
+               std::to_string(mAcceptor.local_endpoint().port());
+    }
+};
+
+std::string
+randomContents(size_t size)
+{
+    std::string s(size, '\0');
+    for (auto& c : s)
+    {
+        c = static_cast<char>(rand_uniform<int>(0, 255));
+    }
+    return s;
+}
+
+// Fetches each of `names` from `base` into `dir`, `parallel` at a time, and
+// returns the results.
+std::vector<asio::error_code>
+fetchAll(VirtualClock& clock, ArchiveFetcher& fetcher, std::string const& base,
+         std::vector<std::string> const& names, TmpDir const& dir,
+         size_t parallel)
+{
+    std::vector<asio::error_code> results(names.size());
+    size_t next = 0;
+    size_t done = 0;
+    std::function<void()> start = [&]() {
+        auto i = next++;
+        fetcher.fetch(base + "/" + names[i], dir.getName() + "/" + names[i],
+                      [&, i](asio::error_code const& ec) {
+                          results[i] = ec;
+                          done++;
+                          if (next < names.size())
+                          {
+                              start();
+                          }
+                      });
+    };
+    while (next < std::min(parallel, names.size()))
+    {
+        start();
+    }
+    while (done < names.size())
+    {
+        clock.crank(false);
+    }
+    return results;
+}
+}
+
+TEST_CASE("archive URLs", "[history][fetcher]")
+{
+    ArchiveFetcher::Url url;
+
+    REQUIRE(ArchiveFetcher::parseUrl("http://example.com:8080/a/b", url));
+    CHECK(url.mScheme == "http");
+    CHECK(url.mHost == "example.com");
+    CHECK(url.mPort == 8080);
+    CHECK(url.mPath == "/a/b");
+
+    REQUIRE(ArchiveFetcher::parseUrl("http://example.com", url));
+    CHECK(url.mPort == 80);
+    CHECK(url.mPath == "/");
+
+    REQUIRE(ArchiveFetcher::parseUrl("file:///tmp/archive", url));
+    CHECK(url.mScheme == "file");
+    CHECK(url.mPath == "/tmp/archive");
+
+    REQUIRE(ArchiveFetcher::parseUrl("file://relative/path", url));
+    CHECK(url.mPath == "relative/path");
+
+    CHECK(!ArchiveFetcher::supports("https://example.com/"));
+    CHECK(!ArchiveFetcher::supports("s3://bucket/"));
+    CHECK(!ArchiveFetcher::supports("http://example.com:80000/"));
+    CHECK(!ArchiveFetcher::supports("http://:80/"));
+    CHECK(!ArchiveFetcher::supports("file://"));
+    CHECK(!ArchiveFetcher::supports("/tmp/archive"));
+}
+
+TEST_CASE("fetch files over http", "[history][fetcher]")
+{
+    VirtualClock clock(VirtualClock::REAL_TIME);
+    auto app = createTestApplication(clock, getTestConfig());
+    TmpDir dir = app->getTmpDirManager().tmpDir("fetcher");
+
+    TestHttpServer server(clock.getIOService());
+    std::vector<std::string> names;
+    for (int i = 0; i < 20; i++)
+    {
+        names.emplace_back("file-" + std::to_string(i));
+        server.mFiles["/archive/" + names.back()] =
+            randomContents(rand_uniform<size_t>(0, 300000));
+    }
+
+    ArchiveFetcher fetcher(*app);
+    auto check = [&](std::vector<asio::error_code> const& results) {
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            REQUIRE(!results[i]);
+            REQUIRE(readFile(dir.getName() + "/" + names[i]) ==
+                    server.mFiles["/archive/" + names[i]]);
+        }
+    };
+
+    SECTION("connections are reused")
+    {
+        check(fetchAll(clock, fetcher, server.url() + "/archive", names, dir,
+                       1));
+        CHECK(server.mConnections == 1);
+        CHECK(server.mRequests == names.size());
+        CHECK(fetcher.numIdleConnections() == 1);
+    }
+
+    SECTION("fetches run in parallel")
+    {
+        check(fetchAll(clock, fetcher, server.url() + "/archive", names, dir,
+                       4));
+        CHECK(server.mConnections <= 4);
+        CHECK(server.mRequests == names.size());
+    }
+
+    SECTION("chunked responses")
+    {
+        server.mChunked = true;
+        check(fetchAll(clock, fetcher, server.url() + "/archive", names, dir,
+                       2));
+    }
+
+    SECTION("connections closed by the server are replaced")
+    {
+        server.mRequestsPerConnection = 3;
+        check(fetchAll(clock, fetcher, server.url() + "/archive", names, dir,
+                       1));
+        CHECK(server.mConnections == (names.size() + 2) / 3);
+    }
+
+    SECTION("missing files fail")
+    {
+        auto results = fetchAll(clock, fetcher, server.url() + "/archive",
+                                {"missing", names[0]}, dir, 1);
+        CHECK(results[0]);
+        CHECK(!fs::exists(dir.getName() + "/missing"));
+        CHECK(!results[1]);
+    }
+}
+
+TEST_CASE("fetch files from the file system", "[history][fetcher]")
+{
+    VirtualClock clock(VirtualClock::REAL_TIME);
+    auto app = createTestApplication(clock, getTestConfig());
+    TmpDir archive = app->getTmpDirManager().tmpDir("archive");
+    TmpDir dir = app->getTmpDirManager().tmpDir("fetcher");
+
+    std::vector<std::string> names = {"empty", "small", "large"};
+    std::map<std::string, std::string> contents = {
+        {"empty", ""},
+        {"small", randomContents(100)},
+        {"large", randomContents(3000000)}};
+    for (auto const& c : contents)
+    {
+        std::ofstream out(archive.getName() + "/" + c.first,
+                          std::ofstream::binary);
+        out.write(c.second.data(), c.second.size());
+    }
+
+    ArchiveFetcher fetcher(*app);
+    auto results = fetchAll(clock, fetcher, "file://" + archive.getName(),
+                            names, dir, 2);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        REQUIRE(!results[i]);
+        REQUIRE(readFile(dir.getName() + "/" + names[i]) ==
+                contents[names[i]]);
+    }
+
+    results = fetchAll(clock, fetcher, "file://" + archive.getName(),
+                       {"missing"}, dir, 1);
+    CHECK(results[0]);
+    CHECK(!fs::exists(dir.getName() + "/missing"));
+}
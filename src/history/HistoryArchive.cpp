@@ -12,6 +12,7 @@
 #include "bucket/BucketList.h"
 #include "crypto/Hex.h"
 #include "crypto/SHA.h"
+#include "history/ArchiveFetcher.h"
 #include "history/HistoryManager.h"
 #include "lib/util/format.h"
 #include "main/Application.h"
@@ -281,8 +282,13 @@ HistoryArchiveState::HistoryArchiveState(uint32_t ledgerSeq,
 HistoryArchive::HistoryArchive(std::string const& name,
                                std::string const& getCmd,
                                std::string const& putCmd,
-                               std::string const& mkdirCmd)
-    : mName(name), mGetCmd(getCmd), mPutCmd(putCmd), mMkdirCmd(mkdirCmd)
+                               std::string const& mkdirCmd,
+                               std::string const& url)
+    : mName(name)
+    , mGetCmd(getCmd)
+    , mPutCmd(putCmd)
+    , mMkdirCmd(mkdirCmd)
+    , mUrl(url)
 {
 }
 
@@ -308,6 +314,18 @@ HistoryArchive::hasMkdirCmd() const
     return !mMkdirCmd.empty();
 }
 
+bool
+HistoryArchive::hasGetUrl() const
+{
+    return !mUrl.empty() && ArchiveFetcher::supports(mUrl);
+}
+
+bool
+HistoryArchive::canGet() const
+{
+    return hasGetCmd() || hasGetUrl();
+}
+
 std::string const&
 HistoryArchive::getName() const
 {
@@ -323,6 +341,14 @@ HistoryArchive::getFileCmd(std::string const& remote,
     return fmt::format(mGetCmd, remote, local);
 }
 
+std::string
+HistoryArchive::getFileUrl(std::string const& remote) const
+{
+    if (!mUrl.empty() && mUrl.back() == '/')
+        return mUrl + remote;
+    return mUrl + "/" + remote;
+}
+
 std::string
 HistoryArchive::putFileCmd(std::string const& local,
                            std::string const& remote) const
@@ -132,18 +132,26 @@ class HistoryArchive : public std::enable_shared_from_this<HistoryArchive>
     std::string mGetCmd;
     std::string mPutCmd;
     std::string mMkdirCmd;
+    std::string mUrl;
 
   public:
     HistoryArchive(std::string const& name, std::string const& getCmd,
-                   std::string const& putCmd, std::string const& mkdirCmd);
+                   std::string const& putCmd, std::string const& mkdirCmd,
+                   std::string const& url = "");
     ~HistoryArchive();
     bool hasGetCmd() const;
     bool hasPutCmd() const;
     bool hasMkdirCmd() const;
+    // Whether files can be fetched from the URL of the archive, without the
+    // get command; see ArchiveFetcher.
+    bool hasGetUrl() const;
+    // Whether files can be fetched from the archive, one way or the other.
+    bool canGet() const;
     std::string const& getName() const;
 
     std::string getFileCmd(std::string const& remote,
                            std::string const& local) const;
+    std::string getFileUrl(std::string const& remote) const;
     std::string putFileCmd(std::string const& local,
                            std::string const& remote) const;
     std::string mkdirCmd(std::string const& remoteDir) const;
@@ -174,6 +174,7 @@ typedef std::error_code error_code;
 namespace stellar
 {
 class Application;
+class ArchiveFetcher;
 class Bucket;
 class BucketList;
 class Config;
@@ -197,6 +198,10 @@ class HistoryManager
     virtual std::shared_ptr<HistoryArchive>
     selectRandomReadableHistoryArchive() = 0;
 
+    // Fetches files from the archives that have a URL it supports, instead of
+    // running their get command.
+    virtual ArchiveFetcher& getArchiveFetcher() = 0;
+
     // Initialize a named history archive by writing
     // .well-known/stellar-history.json to it.
     static bool initializeHistoryArchive(Application& app, std::string arch);
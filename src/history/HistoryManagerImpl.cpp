@@ -12,6 +12,7 @@
 #include "crypto/Hex.h"
 #include "crypto/SHA.h"
 #include "herder/HerderImpl.h"
+#include "history/ArchiveFetcher.h"
 #include "history/HistoryArchive.h"
 #include "history/HistoryManagerImpl.h"
 #include "history/StateSnapshot.h"
@@ -123,7 +124,7 @@ HistoryManager::checkSensibleConfig(Config const& cfg)
 
     for (auto const& pair : cfg.HISTORY)
     {
-        if (pair.second->hasGetCmd())
+        if (pair.second->canGet())
         {
             if (pair.second->hasPutCmd())
             {
@@ -203,6 +204,7 @@ HistoryManager::checkSensibleConfig(Config const& cfg)
 HistoryManagerImpl::HistoryManagerImpl(Application& app)
     : mApp(app)
     , mWorkDir(nullptr)
+    , mArchiveFetcher(make_unique<ArchiveFetcher>(app))
     , mPublishWork(nullptr)
 
     , mPublishSkip(
@@ -365,7 +367,7 @@ HistoryManagerImpl::hasAnyWritableHistoryArchive()
     auto const& hist = mApp.getConfig().HISTORY;
     for (auto const& pair : hist)
     {
-        if (pair.second->hasGetCmd() && pair.second->hasPutCmd())
+        if (pair.second->canGet() && pair.second->hasPutCmd())
             return true;
     }
     return false;
@@ -381,7 +383,7 @@ HistoryManagerImpl::selectRandomReadableHistoryArchive()
     // archives we're explicitly not publishing to, so likely ones we want.
     for (auto const& pair : mApp.getConfig().HISTORY)
     {
-        if (pair.second->hasGetCmd() && !pair.second->hasPutCmd())
+        if (pair.second->canGet() && !pair.second->hasPutCmd())
         {
             archives.push_back(pair);
         }
@@ -392,7 +394,7 @@ HistoryManagerImpl::selectRandomReadableHistoryArchive()
     {
         for (auto const& pair : mApp.getConfig().HISTORY)
         {
-            if (pair.second->hasGetCmd() && pair.second->hasPutCmd())
+            if (pair.second->canGet() && pair.second->hasPutCmd())
             {
                 archives.push_back(pair);
             }
@@ -420,6 +422,12 @@ HistoryManagerImpl::selectRandomReadableHistoryArchive()
     }
 }
 
+ArchiveFetcher&
+HistoryManagerImpl::getArchiveFetcher()
+{
+    return *mArchiveFetcher;
+}
+
 uint32_t
 HistoryManagerImpl::getMinLedgerQueuedToPublish()
 {
@@ -24,6 +24,7 @@ class HistoryManagerImpl : public HistoryManager
 {
     Application& mApp;
     std::unique_ptr<TmpDir> mWorkDir;
+    std::unique_ptr<ArchiveFetcher> mArchiveFetcher;
     std::shared_ptr<Work> mPublishWork;
     PublishQueueBuckets mPublishQueueBuckets;
     bool mPublishQueueBucketsFilled{false};
@@ -44,6 +45,8 @@ class HistoryManagerImpl : public HistoryManager
     std::shared_ptr<HistoryArchive>
     selectRandomReadableHistoryArchive() override;
 
+    ArchiveFetcher& getArchiveFetcher() override;
+
     uint32_t getCheckpointFrequency() const override;
     uint32_t checkpointContainingLedger(uint32_t ledger) const override;
     uint32_t prevCheckpointLedger(uint32_t ledger) const override;
@@ -4,6 +4,9 @@
 
 #include "bucket/BucketManager.h"
 #include "catchup/CatchupWorkTests.h"
+#include "crypto/SHA.h"
+#include "herder/LedgerCloseData.h"
+#include "herder/TxSetFrame.h"
 #include "history/HistoryManager.h"
 #include "history/HistoryTestsUtils.h"
 #include "historywork/GetHistoryArchiveStateWork.h"
@@ -21,6 +24,8 @@
 
 #include <lib/catch.hpp>
 #include <lib/util/format.h>
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
 
 using namespace stellar;
 using namespace historytestutils;
@@ -166,6 +171,117 @@ TEST_CASE("Full history catchup", "[history][historycatchup]")
     }
 }
 
+TEST_CASE("Full history catchup with pipelined transactions",
+          "[history][historycatchup]")
+{
+    CatchupSimulation catchupSimulation{};
+
+    catchupSimulation.generateAndPublishInitialHistory(3);
+
+    uint32_t initLedger =
+        catchupSimulation.getApp().getLedgerManager().getLastClosedLedgerNum();
+
+    for (uint32_t depth : {1, 4})
+    {
+        auto cfg = getTestConfig(static_cast<int>(depth));
+        cfg.CATCHUP_COMPLETE = true;
+        cfg.CATCHUP_PIPELINE_DEPTH = depth;
+        auto app = createTestApplication(
+            catchupSimulation.getClock(),
+            catchupSimulation.getHistoryConfigurator().configure(cfg, false));
+        app->start();
+        CHECK(catchupSimulation.catchupApplication(
+            initLedger, std::numeric_limits<uint32_t>::max(), false, app));
+
+        // Every checkpoint was applied by the pipeline.
+        auto& applied = app->getMetrics().NewMeter(
+            {"history", "pipeline", "applied"}, "checkpoint");
+        CHECK(applied.count() ==
+              app->getHistoryManager().checkpointContainingLedger(initLedger) /
+                  app->getHistoryManager().getCheckpointFrequency() +
+                  1);
+    }
+}
+
+TEST_CASE("Catchup applies nothing from a chain failing the network check",
+          "[history][historycatchup]")
+{
+    CatchupSimulation catchupSimulation{};
+
+    catchupSimulation.generateAndPublishInitialHistory(3);
+
+    auto& publisher = catchupSimulation.getApp().getLedgerManager();
+    uint32_t initLedger = publisher.getLastClosedLedgerNum();
+
+    for (uint32_t depth : {0, 4})
+    {
+        auto cfg = getTestConfig(static_cast<int>(depth) + 1);
+        cfg.CATCHUP_COMPLETE = true;
+        cfg.CATCHUP_PIPELINE_DEPTH = depth;
+        auto app = createTestApplication(
+            catchupSimulation.getClock(),
+            catchupSimulation.getHistoryConfigurator().configure(cfg, false));
+        app->start();
+
+        auto& lm = app->getLedgerManager();
+        auto lcl = lm.getLastClosedLedgerHeader();
+        lm.startCatchUp({initLedger, std::numeric_limits<uint32_t>::max()},
+                        false);
+
+        // The network's next ledger follows some other ledger than the
+        // archive's last one, though the archive's chain links up with ours.
+        auto txSet = std::make_shared<TxSetFrame>(sha256("another chain"));
+        StellarValue sv(
+            txSet->getContentsHash(),
+            publisher.getLastClosedLedgerHeader().header.scpValue.closeTime +
+                1,
+            emptyUpgradeSteps, 0);
+        lm.valueExternalized(LedgerCloseData(initLedger + 1, txSet, sv));
+
+        while (!app->getWorkManager().allChildrenDone())
+        {
+            app->getClock().crank(false);
+        }
+
+        CHECK(lm.getState() != LedgerManager::LM_SYNCED_STATE);
+        CHECK(app->getMetrics()
+                  .NewMeter({"history", "verify-ledger-chain", "failure"},
+                            "event")
+                  .count() == 1);
+        CHECK(app->getMetrics()
+                  .NewMeter({"history", "apply-ledger", "success"}, "event")
+                  .count() == 0);
+        CHECK(lm.getLastClosedLedgerHeader().hash == lcl.hash);
+    }
+}
+
+TEST_CASE("Full history catchup from archive URL",
+          "[history][historycatchup][fetcher]")
+{
+    CatchupSimulation catchupSimulation{};
+
+    catchupSimulation.generateAndPublishInitialHistory(3);
+
+    uint32_t initLedger =
+        catchupSimulation.getApp().getLedgerManager().getLastClosedLedgerNum();
+
+    // No get command: every file is fetched by the ArchiveFetcher.
+    auto cfg = getTestConfig(1);
+    cfg.CATCHUP_COMPLETE = true;
+    cfg.HISTORY["test"] = std::make_shared<HistoryArchive>(
+        "test", "", "", "",
+        "file://" +
+            catchupSimulation.getHistoryConfigurator().getArchiveDirName());
+    auto app = createTestApplication(catchupSimulation.getClock(), cfg);
+    app->start();
+    CHECK(catchupSimulation.catchupApplication(
+        initLedger, std::numeric_limits<uint32_t>::max(), false, app));
+
+    auto& fetched =
+        app->getMetrics().NewMeter({"history", "fetch", "bytes"}, "byte");
+    CHECK(fetched.count() > 0);
+}
+
 TEST_CASE("History publish queueing", "[history][historydelay][historycatchup]")
 {
     CatchupSimulation catchupSimulation{};
@@ -13,12 +13,14 @@ namespace stellar
 
 GetAndUnzipRemoteFileWork::GetAndUnzipRemoteFileWork(
     Application& app, WorkParent& parent, FileTransferInfo ft,
-    std::shared_ptr<HistoryArchive const> archive, size_t maxRetries)
+    std::shared_ptr<HistoryArchive const> archive, size_t maxRetries,
+    std::shared_ptr<UnzippedHash> unzippedHash)
     : Work(app, parent,
            std::string("get-and-unzip-remote-file ") + ft.remoteName(),
            maxRetries)
     , mFt(std::move(ft))
     , mArchive(archive)
+    , mUnzippedHash(unzippedHash)
 {
 }
 
@@ -111,8 +113,8 @@ GetAndUnzipRemoteFileWork::onSuccess()
 
     CLOG(DEBUG, "History") << "Downloading and unzipping " << mFt.remoteName()
                            << ": unzipping";
-    mGunzipFileWork =
-        addWork<GunzipFileWork>(mFt.localPath_gz(), false, RETRY_NEVER);
+    mGunzipFileWork = addWork<GunzipFileWork>(mFt.localPath_gz(), false,
+                                              RETRY_NEVER, mUnzippedHash);
     return WORK_PENDING;
 }
 
@@ -7,6 +7,7 @@
 #include "work/Work.h"
 
 #include "history/FileTransferInfo.h"
+#include "historywork/GunzipFileWork.h"
 
 namespace stellar
 {
@@ -20,15 +21,18 @@ class GetAndUnzipRemoteFileWork : public Work
 
     FileTransferInfo mFt;
     std::shared_ptr<HistoryArchive const> mArchive;
+    std::shared_ptr<UnzippedHash> mUnzippedHash;
 
   public:
     // Passing `nullptr` for the archive argument will cause the work to
     // select a new readable history archive at random each time it runs /
-    // retries.
+    // retries. If `unzippedHash` isn't null, it gets the hash of the
+    // unzipped file.
     GetAndUnzipRemoteFileWork(
         Application& app, WorkParent& parent, FileTransferInfo ft,
         std::shared_ptr<HistoryArchive const> archive = nullptr,
-        size_t maxRetries = Work::RETRY_A_LOT);
+        size_t maxRetries = Work::RETRY_A_LOT,
+        std::shared_ptr<UnzippedHash> unzippedHash = nullptr);
     ~GetAndUnzipRemoteFileWork();
     std::string getStatus() const override;
     void onReset() override;
@@ -3,6 +3,7 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "historywork/GetRemoteFileWork.h"
+#include "history/ArchiveFetcher.h"
 #include "history/HistoryArchive.h"
 #include "history/HistoryManager.h"
 #include "main/Application.h"
@@ -28,16 +29,32 @@ GetRemoteFileWork::~GetRemoteFileWork()
 }
 
 void
-GetRemoteFileWork::getCommand(std::string& cmdLine, std::string& outFile)
+GetRemoteFileWork::onStart()
 {
-    auto archive = mArchive;
-    if (!archive)
+    mCurrentArchive = mArchive;
+    if (!mCurrentArchive)
+    {
+        mCurrentArchive =
+            mApp.getHistoryManager().selectRandomReadableHistoryArchive();
+    }
+    assert(mCurrentArchive);
+    if (mCurrentArchive->hasGetUrl())
+    {
+        mApp.getHistoryManager().getArchiveFetcher().fetch(
+            mCurrentArchive->getFileUrl(mRemote), mLocal, callComplete());
+    }
+    else
     {
-        archive = mApp.getHistoryManager().selectRandomReadableHistoryArchive();
+        RunCommandWork::onStart();
     }
-    assert(archive);
-    assert(archive->hasGetCmd());
-    cmdLine = archive->getFileCmd(mRemote, mLocal);
+}
+
+void
+GetRemoteFileWork::getCommand(std::string& cmdLine, std::string& outFile)
+{
+    assert(mCurrentArchive);
+    assert(mCurrentArchive->hasGetCmd());
+    cmdLine = mCurrentArchive->getFileCmd(mRemote, mLocal);
 }
 
 void
@@ -16,17 +16,20 @@ class GetRemoteFileWork : public RunCommandWork
     std::string mRemote;
     std::string mLocal;
     std::shared_ptr<HistoryArchive const> mArchive;
+    std::shared_ptr<HistoryArchive const> mCurrentArchive;
     void getCommand(std::string& cmdLine, std::string& outFile) override;
 
   public:
     // Passing `nullptr` for the archive argument will cause the work to
     // select a new readable history archive at random each time it runs /
-    // retries.
+    // retries. Archives with a URL the ArchiveFetcher supports are read
+    // with it rather than with their get command.
     GetRemoteFileWork(Application& app, WorkParent& parent,
                       std::string const& remote, std::string const& local,
                       std::shared_ptr<HistoryArchive const> archive = nullptr,
                       size_t maxRetries = Work::RETRY_A_LOT);
     ~GetRemoteFileWork();
     void onReset() override;
+    void onStart() override;
 };
 }
@@ -3,18 +3,27 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "historywork/GunzipFileWork.h"
+#include "crypto/SHA.h"
+#include "main/Application.h"
 #include "util/Fs.h"
+#include "util/Gzip.h"
+#include "util/Logging.h"
+#include <medida/meter.h>
+#include <medida/metrics_registry.h>
 
 namespace stellar
 {
 
 GunzipFileWork::GunzipFileWork(Application& app, WorkParent& parent,
                                std::string const& filenameGz, bool keepExisting,
-                               size_t maxRetries)
-    : RunCommandWork(app, parent, std::string("gunzip-file ") + filenameGz,
-                     maxRetries)
+                               size_t maxRetries,
+                               std::shared_ptr<UnzippedHash> unzippedHash)
+    : Work(app, parent, std::string("gunzip-file ") + filenameGz, maxRetries)
     , mFilenameGz(filenameGz)
     , mKeepExisting(keepExisting)
+    , mUnzippedHash(unzippedHash)
+    , mUnzippedBytes(
+          app.getMetrics().NewMeter({"history", "gunzip", "bytes"}, "byte"))
 {
     fs::checkGzipSuffix(mFilenameGz);
 }
@@ -25,15 +34,62 @@ GunzipFileWork::~GunzipFileWork()
 }
 
 void
-GunzipFileWork::getCommand(std::string& cmdLine, std::string& outFile)
+GunzipFileWork::onStart()
 {
-    cmdLine = "gzip -d ";
-    if (mKeepExisting)
+    std::string filenameGz = mFilenameGz;
+    bool keepExisting = mKeepExisting;
+    auto unzippedHash = mUnzippedHash;
+    if (unzippedHash)
     {
-        cmdLine += "-c ";
-        outFile = mFilenameGz.substr(0, mFilenameGz.size() - 3);
+        unzippedHash->mValid = false;
     }
-    cmdLine += mFilenameGz;
+    Application& app = this->mApp;
+    medida::Meter& unzippedBytes = mUnzippedBytes;
+    auto handler = callComplete();
+    app.getWorkerIOService().post([&app, &unzippedBytes, filenameGz,
+                                   keepExisting, unzippedHash, handler]() {
+        asio::error_code ec;
+        std::string filenameNoGz =
+            filenameGz.substr(0, filenameGz.size() - 3);
+        // The hash is only handed back to the main thread with the result.
+        auto hasher = unzippedHash ? SHA256::create() : nullptr;
+        uint256 hash;
+        uint64_t bytes = 0;
+        try
+        {
+            bytes = gz::gunzipFile(filenameGz, filenameNoGz, hasher.get());
+            if (hasher)
+            {
+                hash = hasher->finish();
+            }
+            if (!keepExisting && std::remove(filenameGz.c_str()) != 0)
+            {
+                throw std::runtime_error("failed to remove " + filenameGz);
+            }
+        }
+        catch (std::runtime_error& e)
+        {
+            CLOG(WARNING, "History")
+                << "FAILED decompressing " << filenameGz << ": " << e.what();
+            ec = std::make_error_code(std::errc::io_error);
+        }
+        app.getClock().getIOService().post(
+            [ec, &unzippedBytes, bytes, unzippedHash, hash, handler]() {
+                unzippedBytes.Mark(bytes);
+                if (!ec && unzippedHash)
+                {
+                    unzippedHash->mHash = hash;
+                    unzippedHash->mValid = true;
+                }
+                handler(ec);
+            });
+    });
+}
+
+void
+GunzipFileWork::onRun()
+{
+    // Do nothing: we started decompressing in onStart().
 }
 
 void
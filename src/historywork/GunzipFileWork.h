@@ -4,22 +4,41 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "work/Work.h"
+#include "xdr/Stellar-types.h"
+
+namespace medida
+{
+class Meter;
+}
 
 namespace stellar
 {
 
-class GunzipFileWork : public RunCommandWork
+// Hash of the file a GunzipFileWork wrote, computed as it was written, for
+// the work verifying the file; see VerifyBucketWork.
+struct UnzippedHash
+{
+    bool mValid{false};
+    uint256 mHash;
+};
+
+// Decompresses a file on a worker thread, in the format of the gzip tool.
+class GunzipFileWork : public Work
 {
     std::string mFilenameGz;
     bool mKeepExisting;
-    void getCommand(std::string& cmdLine, std::string& outFile) override;
+    std::shared_ptr<UnzippedHash> mUnzippedHash;
+    medida::Meter& mUnzippedBytes;
 
   public:
     GunzipFileWork(Application& app, WorkParent& parent,
                    std::string const& filenameGz, bool keepExisting = false,
-                   size_t maxRetries = Work::RETRY_NEVER);
+                   size_t maxRetries = Work::RETRY_NEVER,
+                   std::shared_ptr<UnzippedHash> unzippedHash = nullptr);
     ~GunzipFileWork();
     void onReset() override;
+    void onStart() override;
+    void onRun() override;
 };
 }
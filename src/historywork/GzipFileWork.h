@@ -4,21 +4,23 @@
 
 #pragma once
 
-#include "historywork/RunCommandWork.h"
+#include "work/Work.h"
 
 namespace stellar
 {
 
-class GzipFileWork : public RunCommandWork
+// Compresses a file on a worker thread, in the format of the gzip tool.
+class GzipFileWork : public Work
 {
     std::string mFilenameNoGz;
     bool mKeepExisting;
-    void getCommand(std::string& cmdLine, std::string& outFile) override;
 
   public:
     GzipFileWork(Application& app, WorkParent& parent,
                  std::string const& filenameNoGz, bool keepExisting = false);
     ~GzipFileWork();
     void onReset() override;
+    void onStart() override;
+    void onRun() override;
 };
 }
@@ -26,6 +26,7 @@ VerifyBucketWork::VerifyBucketWork(
     , mBuckets(buckets)
     , mBucketFile(bucketFile)
     , mHash(hash)
+    , mUnzippedHash(std::make_shared<UnzippedHash>())
     , mVerifyBucketSuccess{app.getMetrics().NewMeter(
           {"history", "verify-bucket", "success"}, "event")}
     , mVerifyBucketFailure{app.getMetrics().NewMeter(
@@ -39,9 +40,39 @@ VerifyBucketWork::~VerifyBucketWork()
     clearChildren();
 }
 
+static bool
+checkHash(std::string const& filename, uint256 const& hash,
+          uint256 const& vHash)
+{
+    if (vHash == hash)
+    {
+        CLOG(DEBUG, "History")
+            << "Verified hash (" << hexAbbrev(hash) << ") for " << filename;
+        return true;
+    }
+    CLOG(WARNING, "History") << "FAILED verifying hash for " << filename;
+    CLOG(WARNING, "History") << "expected hash: " << binToHex(hash);
+    CLOG(WARNING, "History") << "computed hash: " << binToHex(vHash);
+    return false;
+}
+
 void
 VerifyBucketWork::onStart()
 {
+    if (mUnzippedHash->mValid)
+    {
+        // Hashed while unzipped.
+        if (checkHash(mBucketFile, mHash, mUnzippedHash->mHash))
+        {
+            scheduleSuccess();
+        }
+        else
+        {
+            scheduleFailure();
+        }
+        return;
+    }
+
     std::string filename = mBucketFile;
     uint256 hash = mHash;
     Application& app = this->mApp;
@@ -59,19 +90,8 @@ VerifyBucketWork::onStart()
                 in.read(buf, sizeof(buf));
                 hasher->add(ByteSlice(buf, in.gcount()));
             }
-            uint256 vHash = hasher->finish();
-            if (vHash == hash)
-            {
-                CLOG(DEBUG, "History") << "Verified hash (" << hexAbbrev(hash)
-                                       << ") for " << filename;
-            }
-            else
+            if (!checkHash(filename, hash, hasher->finish()))
             {
-                CLOG(WARNING, "History")
-                    << "FAILED verifying hash for " << filename;
-                CLOG(WARNING, "History") << "expected hash: " << binToHex(hash);
-                CLOG(WARNING, "History")
-                    << "computed hash: " << binToHex(vHash);
                 ec = std::make_error_code(std::errc::io_error);
             }
         }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "historywork/GunzipFileWork.h"
 #include "work/Work.h"
 #include "xdr/Stellar-types.h"
 
@@ -22,6 +23,7 @@ class VerifyBucketWork : public Work
     std::map<std::string, std::shared_ptr<Bucket>>& mBuckets;
     std::string mBucketFile;
     uint256 mHash;
+    std::shared_ptr<UnzippedHash> mUnzippedHash;
 
     medida::Meter& mVerifyBucketSuccess;
     medida::Meter& mVerifyBucketFailure;
@@ -31,6 +33,15 @@ class VerifyBucketWork : public Work
                      std::map<std::string, std::shared_ptr<Bucket>>& buckets,
                      std::string const& bucketFile, uint256 const& hash);
     ~VerifyBucketWork();
+
+    // For the child unzipping the bucket to store the hash of what it wrote:
+    // the bucket file then doesn't need reading again.
+    std::shared_ptr<UnzippedHash> const&
+    getUnzippedHash() const
+    {
+        return mUnzippedHash;
+    }
+
     void onRun() override;
     void onStart() override;
     Work::State onSuccess() override;
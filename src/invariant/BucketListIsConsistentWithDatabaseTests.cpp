@@ -8,6 +8,7 @@
 #include "bucket/BucketList.h"
 #include "bucket/BucketManager.h"
 #include "catchup/ApplyBucketsWork.h"
+#include "catchup/ApplyMergedBucketsWork.h"
 #include "database/Database.h"
 #include "invariant/Invariant.h"
 #include "invariant/InvariantDoesNotHold.h"
@@ -580,6 +581,39 @@ TEST_CASE("BucketListIsConsistentWithDatabase multiple applies",
         applyBucketsAndCrankUntilDone(appGenerate, appApply, ledgerSeq));
 }
 
+TEST_CASE("BucketListIsConsistentWithDatabase merged applies",
+          "[invariant][bucketlistconsistent]")
+{
+    auto test = [](Config::TestDbMode mode) {
+        std::default_random_engine gen;
+        VirtualClock clock;
+        Application::pointer appGenerate =
+            createTestApplication(clock, getTestConfig(0));
+        Application::pointer appApply =
+            createTestApplication(clock, getTestConfig(1, mode));
+        for (uint32_t i = 0, ledgerSeq = 1; i < 3; ++i)
+        {
+            ledgerSeq = generateLedgers(
+                appGenerate, ++ledgerSeq, 100, 5, generateValidEntryFrames, 2,
+                std::bind(deleteRandomLedgerEntries, _1, _2, std::ref(gen)));
+            REQUIRE_NOTHROW(
+                applyBucketsAndCrankUntilDone<ApplyMergedBucketsWork>(
+                    appGenerate, appApply, ledgerSeq));
+        }
+    };
+
+    SECTION("sqlite")
+    {
+        test(Config::TESTDB_IN_MEMORY_SQLITE);
+    }
+#ifdef USE_POSTGRES
+    SECTION("postgresql")
+    {
+        test(Config::TESTDB_POSTGRESQL);
+    }
+#endif
+}
+
 TEST_CASE("BucketListIsConsistentWithDatabase test non-root account",
           "[invariant][bucketlistconsistent]")
 {
@@ -37,6 +37,13 @@ class InvariantManager
                                     uint32_t ledger, uint32_t level,
                                     bool isCurr) = 0;
 
+    // Check invariants after applying a bucket that holds the merged contents
+    // of several levels of the bucket list, covering ledgers
+    // [oldestLedger, newestLedger].
+    virtual void
+    checkOnMergedBucketApply(std::shared_ptr<Bucket const> bucket,
+                             uint32_t oldestLedger, uint32_t newestLedger) = 0;
+
     virtual void registerInvariant(std::shared_ptr<Invariant> invariant) = 0;
 
     virtual void enableInvariant(std::string const& name) = 0;
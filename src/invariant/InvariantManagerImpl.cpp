@@ -64,6 +64,24 @@ InvariantManagerImpl::checkOnBucketApply(std::shared_ptr<Bucket const> bucket,
     uint32_t newestLedger = oldestLedger - 1 +
                             (isCurr ? BucketList::sizeOfCurr(ledger, level)
                                     : BucketList::sizeOfSnap(ledger, level));
+    checkOnBucketRange(bucket, oldestLedger, newestLedger,
+                       fmt::format("{}[{}]", isCurr ? "Curr" : "Snap", level));
+}
+
+void
+InvariantManagerImpl::checkOnMergedBucketApply(
+    std::shared_ptr<Bucket const> bucket, uint32_t oldestLedger,
+    uint32_t newestLedger)
+{
+    checkOnBucketRange(bucket, oldestLedger, newestLedger, "Merged");
+}
+
+void
+InvariantManagerImpl::checkOnBucketRange(std::shared_ptr<Bucket const> bucket,
+                                         uint32_t oldestLedger,
+                                         uint32_t newestLedger,
+                                         std::string const& bucketName)
+{
     for (auto invariant : mEnabled)
     {
         auto result =
@@ -74,9 +92,9 @@ InvariantManagerImpl::checkOnBucketApply(std::shared_ptr<Bucket const> bucket,
         }
 
         auto message = fmt::format(
-            R"(invariant "{}" does not hold on bucket {}[{}] = {}: {})",
-            invariant->getName(), isCurr ? "Curr" : "Snap", level,
-            binToHex(bucket->getHash()), result);
+            R"(invariant "{}" does not hold on bucket {} = {}: {})",
+            invariant->getName(), bucketName, binToHex(bucket->getHash()),
+            result);
         CLOG(FATAL, "Invariant") << message;
         throw InvariantDoesNotHold{message};
     }
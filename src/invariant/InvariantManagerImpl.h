@@ -17,6 +17,10 @@ class InvariantManagerImpl : public InvariantManager
     std::map<std::string, std::shared_ptr<Invariant>> mInvariants;
     std::vector<std::shared_ptr<Invariant>> mEnabled;
 
+    void checkOnBucketRange(std::shared_ptr<Bucket const> bucket,
+                            uint32_t oldestLedger, uint32_t newestLedger,
+                            std::string const& bucketName);
+
   public:
     InvariantManagerImpl();
 
@@ -27,6 +31,11 @@ class InvariantManagerImpl : public InvariantManager
                                     uint32_t ledger, uint32_t level,
                                     bool isCurr) override;
 
+    virtual void
+    checkOnMergedBucketApply(std::shared_ptr<Bucket const> bucket,
+                             uint32_t oldestLedger,
+                             uint32_t newestLedger) override;
+
     virtual void
     registerInvariant(std::shared_ptr<Invariant> invariant) override;
 
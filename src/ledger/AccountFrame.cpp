@@ -8,6 +8,7 @@
 #include "crypto/KeyUtils.h"
 #include "crypto/SecretKey.h"
 #include "crypto/SignerKey.h"
+#include "database/BulkRows.h"
 #include "database/Database.h"
 #include "ledger/LedgerManager.h"
 #include "ledger/LedgerRange.h"
@@ -229,6 +230,10 @@ AccountFrame::loadAccount(LedgerDelta& delta, AccountID const& accountID,
     return a;
 }
 
+static const char* accountColumnSelector =
+    "SELECT accountid, balance, seqnum, numsubentries, inflationdest, "
+    "homedomain, thresholds, flags, lastmodified FROM accounts";
+
 AccountFrame::pointer
 AccountFrame::loadAccount(AccountID const& accountID, Database& db)
 {
@@ -243,66 +248,175 @@ AccountFrame::loadAccount(AccountID const& accountID, Database& db)
 
     std::string actIDStrKey = KeyUtils::toStrKey(accountID);
 
-    std::string publicKey, inflationDest, creditAuthKey;
-    std::string homeDomain, thresholds;
-    soci::indicator inflationDestInd;
-
-    AccountFrame::pointer res = make_shared<AccountFrame>(accountID);
-    AccountEntry& account = res->getAccount();
-
-    auto prep =
-        db.getPreparedStatement("SELECT balance, seqnum, numsubentries, "
-                                "inflationdest, homedomain, thresholds, "
-                                "flags, lastmodified "
-                                "FROM accounts WHERE accountid=:v1");
+    std::string sql = accountColumnSelector;
+    sql += " WHERE accountid=:v1";
+    auto prep = db.getPreparedStatement(sql);
     auto& st = prep.statement();
-    st.exchange(into(account.balance));
-    st.exchange(into(account.seqNum));
-    st.exchange(into(account.numSubEntries));
-    st.exchange(into(inflationDest, inflationDestInd));
-    st.exchange(into(homeDomain));
-    st.exchange(into(thresholds));
-    st.exchange(into(account.flags));
-    st.exchange(into(res->getLastModified()));
     st.exchange(use(actIDStrKey));
-    st.define_and_bind();
+
+    AccountFrame::pointer res;
     {
         auto timer = db.getSelectTimer("account");
-        st.execute(true);
+        loadAccounts(prep,
+                     [&res](AccountFrame::pointer const& a) { res = a; });
     }
 
-    if (!st.got_data())
+    if (!res)
     {
         putCachedEntry(key, nullptr, db);
         return nullptr;
     }
 
-    account.homeDomain = homeDomain;
+    if (res->mAccountEntry.numSubEntries != 0)
+    {
+        res->mAccountEntry.signers = loadSigners(db, actIDStrKey);
+    }
 
-    bn::decode_b64(thresholds.begin(), thresholds.end(),
-                   res->mAccountEntry.thresholds.begin());
+    res->finishLoad(db);
+    return res;
+}
 
-    if (inflationDestInd == soci::i_ok)
+void
+AccountFrame::loadAccounts(std::vector<AccountID> const& accountIDs,
+                           Database& db)
+{
+    for (size_t i = 0; i < accountIDs.size(); i += kPrefetchBatchSize)
     {
-        account.inflationDest.activate() =
-            KeyUtils::fromStrKey<PublicKey>(inflationDest);
+        std::vector<std::string> strKeys;
+        for (size_t j = i; j < i + kPrefetchBatchSize; ++j)
+        {
+            auto const& id = accountIDs[std::min(j, accountIDs.size() - 1)];
+            strKeys.emplace_back(KeyUtils::toStrKey(id));
+        }
+
+        std::string sql = accountColumnSelector;
+        sql += " WHERE accountid IN " + prefetchPlaceholders();
+        auto prep = db.getPreparedStatement(sql);
+        auto& st = prep.statement();
+        for (auto& k : strKeys)
+        {
+            st.exchange(use(k));
+        }
+
+        std::unordered_map<AccountID, AccountFrame::pointer> loaded;
+        bool hasSubEntries = false;
+        {
+            auto timer = db.getSelectTimer("account");
+            loadAccounts(prep, [&](AccountFrame::pointer const& a) {
+                hasSubEntries = hasSubEntries ||
+                                a->mAccountEntry.numSubEntries != 0;
+                loaded[a->getID()] = a;
+            });
+        }
+
+        if (hasSubEntries)
+        {
+            std::string actIDStrKey, pubKey;
+            Signer signer;
+            auto prep2 = db.getPreparedStatement(
+                "SELECT accountid, publickey, weight FROM signers "
+                "WHERE accountid IN " +
+                prefetchPlaceholders());
+            auto& st2 = prep2.statement();
+            st2.exchange(into(actIDStrKey));
+            st2.exchange(into(pubKey));
+            st2.exchange(into(signer.weight));
+            for (auto& k : strKeys)
+            {
+                st2.exchange(use(k));
+            }
+            st2.define_and_bind();
+            {
+                auto timer = db.getSelectTimer("signer");
+                st2.execute(true);
+            }
+            while (st2.got_data())
+            {
+                auto it =
+                    loaded.find(KeyUtils::fromStrKey<PublicKey>(actIDStrKey));
+                if (it != loaded.end())
+                {
+                    signer.key = KeyUtils::fromStrKey<SignerKey>(pubKey);
+                    it->second->mAccountEntry.signers.push_back(signer);
+                }
+                st2.fetch();
+            }
+        }
+
+        for (size_t j = i; j < std::min(i + kPrefetchBatchSize,
+                                        accountIDs.size());
+             ++j)
+        {
+            auto it = loaded.find(accountIDs[j]);
+            if (it == loaded.end())
+            {
+                LedgerKey key;
+                key.type(ACCOUNT);
+                key.account().accountID = accountIDs[j];
+                putCachedEntry(key, nullptr, db);
+                continue;
+            }
+            it->second->finishLoad(db);
+        }
     }
+}
+
+void
+AccountFrame::loadAccounts(
+    StatementContext& prep,
+    std::function<void(AccountFrame::pointer const&)> accountProcessor)
+{
+    std::string actIDStrKey, inflationDest, homeDomain, thresholds;
+    soci::indicator inflationDestInd;
+    AccountEntry account;
+    uint32 lastModified;
 
-    account.signers.clear();
+    auto& st = prep.statement();
+    st.exchange(into(actIDStrKey));
+    st.exchange(into(account.balance));
+    st.exchange(into(account.seqNum));
+    st.exchange(into(account.numSubEntries));
+    st.exchange(into(inflationDest, inflationDestInd));
+    st.exchange(into(homeDomain));
+    st.exchange(into(thresholds));
+    st.exchange(into(account.flags));
+    st.exchange(into(lastModified));
+    st.define_and_bind();
 
-    if (account.numSubEntries != 0)
+    st.execute(true);
+    while (st.got_data())
     {
-        auto signers = loadSigners(db, actIDStrKey);
-        account.signers.insert(account.signers.begin(), signers.begin(),
-                               signers.end());
+        auto res = make_shared<AccountFrame>(
+            KeyUtils::fromStrKey<PublicKey>(actIDStrKey));
+        AccountEntry& ae = res->mAccountEntry;
+        ae.balance = account.balance;
+        ae.seqNum = account.seqNum;
+        ae.numSubEntries = account.numSubEntries;
+        ae.flags = account.flags;
+        ae.homeDomain = homeDomain;
+        bn::decode_b64(thresholds.begin(), thresholds.end(),
+                       ae.thresholds.begin());
+        if (inflationDestInd == soci::i_ok)
+        {
+            ae.inflationDest.activate() =
+                KeyUtils::fromStrKey<PublicKey>(inflationDest);
+        }
+        res->getLastModified() = lastModified;
+
+        accountProcessor(res);
+
+        st.fetch();
     }
+}
 
-    res->normalize();
-    res->mUpdateSigners = false;
-    assert(res->isValid());
-    res->mKeyCalculated = false;
-    res->putCachedEntry(db);
-    return res;
+void
+AccountFrame::finishLoad(Database& db)
+{
+    normalize();
+    mUpdateSigners = false;
+    assert(isValid());
+    mKeyCalculated = false;
+    putCachedEntry(db);
 }
 
 std::vector<Signer>
@@ -440,6 +554,75 @@ AccountFrame::storeDelete(LedgerDelta& delta, Database& db,
     delta.deleteEntry(key);
 }
 
+void
+AccountFrame::storeBulk(Database& db, soci::session& sess,
+                        std::vector<LedgerEntry> const& live,
+                        std::vector<LedgerKey> const& dead)
+{
+    BulkRows accountKeys("accounts", {{"accountid", "TEXT"}});
+    BulkRows signerKeys("signers", {{"accountid", "TEXT"}});
+    BulkRows accounts("accounts",
+                      {{"accountid", "TEXT"},
+                       {"balance", "BIGINT"},
+                       {"seqnum", "BIGINT"},
+                       {"numsubentries", "INT"},
+                       {"inflationdest", "TEXT"},
+                       {"homedomain", "TEXT"},
+                       {"thresholds", "TEXT"},
+                       {"flags", "INT"},
+                       {"lastmodified", "INT"}});
+    BulkRows signers("signers", {{"accountid", "TEXT"},
+                                 {"publickey", "TEXT"},
+                                 {"weight", "INT"}});
+
+    for (auto const& key : dead)
+    {
+        std::string actIDStrKey = KeyUtils::toStrKey(key.account().accountID);
+        accountKeys.add(actIDStrKey);
+        signerKeys.add(actIDStrKey);
+    }
+
+    for (auto const& entry : live)
+    {
+        AccountFrame frame(entry);
+        assert(frame.isValid());
+
+        auto const& a = frame.mAccountEntry;
+        std::string actIDStrKey = KeyUtils::toStrKey(a.accountID);
+        accountKeys.add(actIDStrKey);
+        signerKeys.add(actIDStrKey);
+
+        accounts.add(actIDStrKey);
+        accounts.addNumber(a.balance);
+        accounts.addNumber(a.seqNum);
+        accounts.addNumber(a.numSubEntries);
+        if (a.inflationDest)
+        {
+            accounts.add(KeyUtils::toStrKey(*a.inflationDest));
+        }
+        else
+        {
+            accounts.addNull();
+        }
+        accounts.add(a.homeDomain);
+        accounts.add(bn::encode_b64(a.thresholds));
+        accounts.addNumber(a.flags);
+        accounts.addNumber(frame.getLastModified());
+
+        for (auto const& signer : a.signers)
+        {
+            signers.add(actIDStrKey);
+            signers.add(KeyUtils::toStrKey(signer.key));
+            signers.addNumber(signer.weight);
+        }
+    }
+
+    accountKeys.erase(db, sess, "account");
+    signerKeys.erase(db, sess, "signer");
+    accounts.insert(db, sess, "account");
+    signers.insert(db, sess, "signer");
+}
+
 void
 AccountFrame::storeUpdate(LedgerDelta& delta, Database& db, bool insert)
 {
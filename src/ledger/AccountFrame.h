@@ -22,6 +22,7 @@ namespace stellar
 {
 class LedgerManager;
 class LedgerRange;
+class StatementContext;
 
 class AccountFrame : public EntryFrame
 {
@@ -120,6 +121,16 @@ class AccountFrame : public EntryFrame
     // Static helper that don't assume an instance.
     static void storeDelete(LedgerDelta& delta, Database& db,
                             LedgerKey const& key);
+
+    // Replace, in bulk, the rows of a batch of entries applied from a bucket:
+    // the rows for every entry in `live` and every key in `dead` are deleted,
+    // then every entry in `live` is inserted. Keys must be distinct.
+    //
+    // Statements run on `sess`, which may be a pool session used from a
+    // worker thread (see BulkRows); the entry cache is left to the caller.
+    static void storeBulk(Database& db, soci::session& sess,
+                          std::vector<LedgerEntry> const& live,
+                          std::vector<LedgerKey> const& dead);
     static bool exists(Database& db, LedgerKey const& key);
     static uint64_t countObjects(soci::session& sess);
     static uint64_t countObjects(soci::session& sess,
@@ -132,6 +143,10 @@ class AccountFrame : public EntryFrame
     loadAccount(LedgerDelta& delta, AccountID const& accountID, Database& db);
     static AccountFrame::pointer loadAccount(AccountID const& accountID,
                                              Database& db);
+    // Load many accounts into the entry cache at once; see
+    // EntryFrame::prefetch.
+    static void loadAccounts(std::vector<AccountID> const& accountIDs,
+                             Database& db);
 
     // compare signers, ignores weight
     static bool signerCompare(Signer const& s1, Signer const& s2);
@@ -156,6 +171,14 @@ class AccountFrame : public EntryFrame
     static void dropAll(Database& db);
 
   private:
+    // Runs `prep`, a query on the account columns, and passes each account
+    // it finds to `accountProcessor`, signers not loaded yet.
+    static void loadAccounts(
+        StatementContext& prep,
+        std::function<void(AccountFrame::pointer const&)> accountProcessor);
+    // Checks an account just loaded, signers included, and caches it.
+    void finishLoad(Database& db);
+
     static const char* kSQLCreateStatement1;
     static const char* kSQLCreateStatement2;
     static const char* kSQLCreateStatement3;
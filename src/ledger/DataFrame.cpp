@@ -7,6 +7,7 @@
 #include "crypto/KeyUtils.h"
 #include "crypto/SHA.h"
 #include "crypto/SecretKey.h"
+#include "database/BulkRows.h"
 #include "database/Database.h"
 #include "ledger/LedgerRange.h"
 #include "transactions/ManageDataOpFrame.h"
@@ -233,6 +234,41 @@ DataFrame::storeDelete(LedgerDelta& delta, Database& db, LedgerKey const& key)
     delta.deleteEntry(key);
 }
 
+void
+DataFrame::storeBulk(Database& db, soci::session& sess,
+                     std::vector<LedgerEntry> const& live,
+                     std::vector<LedgerKey> const& dead)
+{
+    BulkRows keys("accountdata", {{"accountid", "TEXT"}, {"dataname", "TEXT"}});
+    BulkRows data("accountdata", {{"accountid", "TEXT"},
+                                  {"dataname", "TEXT"},
+                                  {"datavalue", "TEXT"},
+                                  {"lastmodified", "INT"}});
+
+    for (auto const& key : dead)
+    {
+        keys.add(KeyUtils::toStrKey(key.data().accountID));
+        keys.add(key.data().dataName);
+    }
+
+    for (auto const& entry : live)
+    {
+        assert(isValid(entry));
+        auto const& d = entry.data.data();
+        std::string actIDStrKey = KeyUtils::toStrKey(d.accountID);
+        keys.add(actIDStrKey);
+        keys.add(d.dataName);
+
+        data.add(actIDStrKey);
+        data.add(d.dataName);
+        data.add(bn::encode_b64(d.dataValue));
+        data.addNumber(entry.lastModifiedLedgerSeq);
+    }
+
+    keys.erase(db, sess, "data");
+    data.insert(db, sess, "data");
+}
+
 void
 DataFrame::storeChange(LedgerDelta& delta, Database& db)
 {
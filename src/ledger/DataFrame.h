@@ -70,6 +70,16 @@ class DataFrame : public EntryFrame
     // Static helpers that don't assume an instance.
     static void storeDelete(LedgerDelta& delta, Database& db,
                             LedgerKey const& key);
+
+    // Replace, in bulk, the rows of a batch of entries applied from a bucket:
+    // the rows for every entry in `live` and every key in `dead` are deleted,
+    // then every entry in `live` is inserted. Keys must be distinct.
+    //
+    // Statements run on `sess`, which may be a pool session used from a
+    // worker thread (see BulkRows); the entry cache is left to the caller.
+    static void storeBulk(Database& db, soci::session& sess,
+                          std::vector<LedgerEntry> const& live,
+                          std::vector<LedgerKey> const& dead);
     static bool exists(Database& db, LedgerKey const& key);
     static uint64_t countObjects(soci::session& sess);
     static uint64_t countObjects(soci::session& sess,
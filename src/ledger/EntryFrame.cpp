@@ -4,7 +4,6 @@
 
 #include "ledger/EntryFrame.h"
 #include "LedgerManager.h"
-#include "crypto/Hex.h"
 #include "database/Database.h"
 #include "ledger/AccountFrame.h"
 #include "ledger/DataFrame.h"
@@ -109,30 +108,66 @@ EntryFrame::touch(LedgerDelta const& delta)
 void
 EntryFrame::flushCachedEntry(LedgerKey const& key, Database& db)
 {
-    auto s = binToHex(xdr::xdr_to_opaque(key));
-    db.getEntryCache().erase_if_exists(s);
+    db.getEntryCache().erase_if_exists(key);
 }
 
 bool
 EntryFrame::cachedEntryExists(LedgerKey const& key, Database& db)
 {
-    auto s = binToHex(xdr::xdr_to_opaque(key));
-    return db.getEntryCache().exists(s);
+    return db.getEntryCache().exists(key);
 }
 
 std::shared_ptr<LedgerEntry const>
 EntryFrame::getCachedEntry(LedgerKey const& key, Database& db)
 {
-    auto s = binToHex(xdr::xdr_to_opaque(key));
-    return db.getEntryCache().get(s);
+    return db.getEntryCache().get(key);
 }
 
 void
 EntryFrame::putCachedEntry(LedgerKey const& key,
                            std::shared_ptr<LedgerEntry const> p, Database& db)
 {
-    auto s = binToHex(xdr::xdr_to_opaque(key));
-    db.getEntryCache().put(s, p);
+    db.getEntryCache().put(key, p);
+}
+
+size_t const EntryFrame::kPrefetchBatchSize = 64;
+
+std::string
+EntryFrame::prefetchPlaceholders()
+{
+    std::string res = "(";
+    for (size_t i = 0; i < kPrefetchBatchSize; ++i)
+    {
+        res += (i == 0 ? ":k" : ", :k") + std::to_string(i);
+    }
+    return res + ")";
+}
+
+void
+EntryFrame::prefetch(std::unordered_set<LedgerKey> const& keys, Database& db)
+{
+    std::vector<AccountID> accounts;
+    std::vector<LedgerKey> trustLines;
+    for (auto const& key : keys)
+    {
+        if (cachedEntryExists(key, db))
+        {
+            continue;
+        }
+        switch (key.type())
+        {
+        case ACCOUNT:
+            accounts.emplace_back(key.account().accountID);
+            break;
+        case TRUSTLINE:
+            trustLines.emplace_back(key);
+            break;
+        default:
+            break;
+        }
+    }
+    AccountFrame::loadAccounts(accounts, db);
+    TrustFrame::loadTrustLines(trustLines, db);
 }
 
 void
@@ -246,6 +281,28 @@ EntryFrame::storeDelete(LedgerDelta& delta, Database& db, LedgerKey const& key)
     }
 }
 
+void
+EntryFrame::storeBulk(Database& db, soci::session& sess, LedgerEntryType type,
+                      std::vector<LedgerEntry> const& live,
+                      std::vector<LedgerKey> const& dead)
+{
+    switch (type)
+    {
+    case ACCOUNT:
+        AccountFrame::storeBulk(db, sess, live, dead);
+        break;
+    case TRUSTLINE:
+        TrustFrame::storeBulk(db, sess, live, dead);
+        break;
+    case OFFER:
+        OfferFrame::storeBulk(db, sess, live, dead);
+        break;
+    case DATA:
+        DataFrame::storeBulk(db, sess, live, dead);
+        break;
+    }
+}
+
 LedgerKey
 LedgerEntryKey(LedgerEntry const& e)
 {
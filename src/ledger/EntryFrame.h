@@ -5,8 +5,10 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "bucket/LedgerCmp.h"
+#include "ledger/LedgerHashUtils.h"
 #include "overlay/StellarXDR.h"
 #include "util/NonCopyable.h"
+#include <unordered_set>
 
 /*
 Frame
@@ -15,6 +17,11 @@ Parent of AccountFrame, TrustFrame, OfferFrame
 These just hold the xdr LedgerEntry objects and have some associated functions
 */
 
+namespace soci
+{
+class session;
+}
+
 namespace stellar
 {
 class Database;
@@ -31,6 +38,12 @@ class EntryFrame : public NonMovableOrCopyable
         mKeyCalculated = false;
     }
 
+    // Prefetch queries look up this many keys at once with an IN list; short
+    // batches are padded so that they all share one prepared statement.
+    static size_t const kPrefetchBatchSize;
+    // The IN list of placeholders for a batch: "(:k0, :k1, ...)".
+    static std::string prefetchPlaceholders();
+
   public:
     typedef std::shared_ptr<EntryFrame> pointer;
 
@@ -51,6 +64,12 @@ class EntryFrame : public NonMovableOrCopyable
                                std::shared_ptr<LedgerEntry const> p,
                                Database& db);
 
+    // Load the entries of `keys` the cache knows nothing about into it, with
+    // a few batched queries rather than one query per entry. Only accounts
+    // and trust lines are prefetched, other keys are ignored.
+    static void prefetch(std::unordered_set<LedgerKey> const& keys,
+                         Database& db);
+
     // helpers to get/set the last modified field
     uint32 getLastModified() const;
     uint32& getLastModified();
@@ -79,6 +98,13 @@ class EntryFrame : public NonMovableOrCopyable
     static bool exists(Database& db, LedgerKey const& key);
     static void storeDelete(LedgerDelta& delta, Database& db,
                             LedgerKey const& key);
+
+    // Bulk-replace the rows of a batch of entries and keys of the given type,
+    // as when applying buckets; see AccountFrame::storeBulk.
+    static void storeBulk(Database& db, soci::session& sess,
+                          LedgerEntryType type,
+                          std::vector<LedgerEntry> const& live,
+                          std::vector<LedgerKey> const& dead);
 };
 
 // static helper for getting a LedgerKey from a LedgerEntry.
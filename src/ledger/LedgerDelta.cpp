@@ -3,6 +3,8 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "ledger/LedgerDelta.h"
+#include "database/Database.h"
+#include "ledger/OrderBook.h"
 #include "main/Application.h"
 #include "main/Config.h"
 #include "medida/meter.h"
@@ -225,6 +227,10 @@ LedgerDelta::commit()
         mOuterDelta->mergeEntries(*this);
         mOuterDelta = nullptr;
     }
+    else
+    {
+        mDb.getOrderBook().committed();
+    }
     *mHeader = mCurrentHeader.mHeader;
     mHeader = nullptr;
 }
@@ -235,17 +241,24 @@ LedgerDelta::rollback()
     checkState();
     mHeader = nullptr;
 
+    auto flush = [this](LedgerKey const& key) {
+        EntryFrame::flushCachedEntry(key, mDb);
+        if (key.type() == OFFER)
+        {
+            mDb.getOrderBook().rolledBack(key);
+        }
+    };
     for (auto& d : mDelete)
     {
-        EntryFrame::flushCachedEntry(d, mDb);
+        flush(d);
     }
     for (auto& n : mNew)
     {
-        EntryFrame::flushCachedEntry(n.first, mDb);
+        flush(n.first);
     }
     for (auto& m : mMod)
     {
-        EntryFrame::flushCachedEntry(m.first, mDb);
+        flush(m.first);
     }
 }
 
@@ -35,7 +35,7 @@ class LedgerDelta
     std::set<LedgerKey, LedgerEntryIdCmp> mDelete;
     KeyEntryMap mPrevious;
 
-    Database& mDb; // Used strictly for rollback of db entry cache.
+    Database& mDb; // Used strictly for the db entry cache and order book.
 
     bool mUpdateLastModified;
 
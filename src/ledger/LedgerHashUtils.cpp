@@ -0,0 +1,96 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/LedgerHashUtils.h"
+#include "crypto/ShortHash.h"
+#include <cstring>
+
+namespace
+{
+
+// Packs the fields identifying an entry into a fixed buffer, large enough for
+// the longest key (a data entry with a 64 byte name).
+class KeyBytes
+{
+    unsigned char mBuf[128];
+    size_t mSize{0};
+
+  public:
+    void
+    add(void const* data, size_t size)
+    {
+        std::memcpy(mBuf + mSize, data, size);
+        mSize += size;
+    }
+
+    void
+    add(stellar::PublicKey const& pk)
+    {
+        add(pk.ed25519().data(), pk.ed25519().size());
+    }
+
+    void
+    add(stellar::Asset const& asset)
+    {
+        auto type = asset.type();
+        add(&type, sizeof(type));
+        switch (type)
+        {
+        case stellar::ASSET_TYPE_CREDIT_ALPHANUM4:
+            add(asset.alphaNum4().assetCode.data(),
+                asset.alphaNum4().assetCode.size());
+            add(asset.alphaNum4().issuer);
+            break;
+        case stellar::ASSET_TYPE_CREDIT_ALPHANUM12:
+            add(asset.alphaNum12().assetCode.data(),
+                asset.alphaNum12().assetCode.size());
+            add(asset.alphaNum12().issuer);
+            break;
+        default:
+            break;
+        }
+    }
+
+    uint64_t
+    hash() const
+    {
+        return stellar::randomShortHash(stellar::ByteSlice(mBuf, mSize));
+    }
+};
+}
+
+namespace std
+{
+
+// Hashes the key's fields in place rather than its XDR encoding, so entry
+// cache lookups don't allocate. Keys are chosen by users, so the hash is keyed
+// per process: colliding keys can't be worked out ahead of time.
+size_t
+hash<stellar::LedgerKey>::operator()(stellar::LedgerKey const& key) const
+    noexcept
+{
+    KeyBytes bytes;
+    auto type = key.type();
+    bytes.add(&type, sizeof(type));
+    switch (type)
+    {
+    case stellar::ACCOUNT:
+        bytes.add(key.account().accountID);
+        break;
+    case stellar::TRUSTLINE:
+        bytes.add(key.trustLine().accountID);
+        bytes.add(key.trustLine().asset);
+        break;
+    case stellar::OFFER:
+        bytes.add(key.offer().sellerID);
+        bytes.add(&key.offer().offerID, sizeof(key.offer().offerID));
+        break;
+    case stellar::DATA:
+        bytes.add(key.data().accountID);
+        bytes.add(key.data().dataName.data(), key.data().dataName.size());
+        break;
+    }
+    return static_cast<size_t>(bytes.hash());
+}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/StellarXDR.h"
+
+namespace stellar
+{
+using xdr::operator==;
+}
+
+namespace std
+{
+template <> struct hash<stellar::LedgerKey>
+{
+    size_t operator()(stellar::LedgerKey const& key) const noexcept;
+};
+}
@@ -113,6 +113,8 @@ LedgerManagerImpl::LedgerManagerImpl(Application& app)
     : mApp(app)
     , mTransactionApply(
           app.getMetrics().NewTimer({"ledger", "transaction", "apply"}))
+    , mTransactionPrefetch(
+          app.getMetrics().NewTimer({"ledger", "transaction", "prefetch"}))
     , mLedgerClose(app.getMetrics().NewTimer({"ledger", "ledger", "close"}))
     , mLedgerAgeClosed(app.getMetrics().NewTimer({"ledger", "age", "closed"}))
     , mLedgerAge(
@@ -723,6 +725,9 @@ LedgerManagerImpl::closeLedger(LedgerCloseData const& ledgerData)
     // sorted such that sequence numbers are respected
     vector<TransactionFramePtr> txs = ledgerData.getTxSet()->sortForApply();
 
+    // load what applying the set needs in bulk, rather than entry by entry
+    prefetchTransactionData(txs);
+
     // first, charge fees
     processFeesSeqNums(txs, ledgerDelta);
 
@@ -907,6 +912,28 @@ LedgerManagerImpl::processFeesSeqNums(std::vector<TransactionFramePtr>& txs,
     }
 }
 
+void
+LedgerManagerImpl::prefetchTransactionData(
+    std::vector<TransactionFramePtr> const& txs)
+{
+    auto timer = mTransactionPrefetch.TimeScope();
+    auto& db = getDatabase();
+
+    // Prefetching more than the cache holds would only evict entries loaded
+    // by earlier transactions before they are used.
+    auto maxKeys = db.getEntryCache().getMaxSize() / 2;
+    std::unordered_set<LedgerKey> keys;
+    for (auto const& tx : txs)
+    {
+        if (keys.size() >= maxKeys)
+        {
+            break;
+        }
+        tx->insertLedgerKeysToPrefetch(keys);
+    }
+    EntryFrame::prefetch(keys, db);
+}
+
 void
 LedgerManagerImpl::applyTransactions(std::vector<TransactionFramePtr>& txs,
                                      LedgerDelta& ledgerDelta,
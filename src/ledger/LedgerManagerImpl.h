@@ -40,6 +40,7 @@ class LedgerManagerImpl : public LedgerManager
 
     Application& mApp;
     medida::Timer& mTransactionApply;
+    medida::Timer& mTransactionPrefetch;
     medida::Timer& mLedgerClose;
     medida::Timer& mLedgerAgeClosed;
     medida::Counter& mLedgerAge;
@@ -56,6 +57,7 @@ class LedgerManagerImpl : public LedgerManager
                          CatchupWork::ProgressState progressState,
                          LedgerHeaderHistoryEntry const& lastClosed);
 
+    void prefetchTransactionData(std::vector<TransactionFramePtr> const& txs);
     void processFeesSeqNums(std::vector<TransactionFramePtr>& txs,
                             LedgerDelta& delta);
     void applyTransactions(std::vector<TransactionFramePtr>& txs,
@@ -138,3 +138,56 @@ TEST_CASE("DB cache interaction with transactions", "[ledger][dbcache]")
 
     CHECK(balance0 == acc->getAccount().balance);
 }
+
+TEST_CASE("DB cache prefetch", "[ledger][dbcache]")
+{
+    VirtualClock clock;
+    Application::pointer app = createTestApplication(clock, getTestConfig());
+    app->start();
+
+    auto& db = app->getDatabase();
+    LedgerDelta delta(app->getLedgerManager().getCurrentLedgerHeader(), db);
+
+    // More than a batch of each, some of which are not in the database.
+    std::unordered_set<LedgerKey> keys;
+    for (auto const& ae : LedgerTestUtils::generateValidAccountEntries(150))
+    {
+        LedgerEntry le;
+        le.data.type(ACCOUNT);
+        le.data.account() = ae;
+        auto frame = EntryFrame::FromXDR(le);
+        if (keys.size() % 3 != 0)
+        {
+            frame->storeAdd(delta, db);
+        }
+        keys.insert(frame->getKey());
+    }
+    for (auto const& tl : LedgerTestUtils::generateValidTrustLineEntries(150))
+    {
+        LedgerEntry le;
+        le.data.type(TRUSTLINE);
+        le.data.trustLine() = tl;
+        auto frame = EntryFrame::FromXDR(le);
+        if (keys.size() % 3 != 0)
+        {
+            frame->storeAdd(delta, db);
+        }
+        keys.insert(frame->getKey());
+    }
+
+    db.getEntryCache().clear();
+    EntryFrame::prefetch(keys, db);
+
+    for (auto const& key : keys)
+    {
+        REQUIRE(EntryFrame::cachedEntryExists(key, db));
+        auto prefetched = EntryFrame::getCachedEntry(key, db);
+        EntryFrame::flushCachedEntry(key, db);
+        auto loaded = EntryFrame::storeLoad(key, db);
+        REQUIRE(!!prefetched == !!loaded);
+        if (loaded)
+        {
+            REQUIRE(*prefetched == loaded->mEntry);
+        }
+    }
+}
@@ -7,8 +7,10 @@
 #include "crypto/KeyUtils.h"
 #include "crypto/SHA.h"
 #include "crypto/SecretKey.h"
+#include "database/BulkRows.h"
 #include "database/Database.h"
 #include "ledger/LedgerRange.h"
+#include "ledger/OrderBook.h"
 #include "transactions/ManageOfferOpFrame.h"
 #include "util/types.h"
 
@@ -267,18 +269,14 @@ OfferFrame::loadOffers(StatementContext& prep,
     }
 }
 
-void
-OfferFrame::loadBestOffers(size_t numOffers, size_t offset,
-                           Asset const& selling, Asset const& buying,
-                           vector<OfferFrame::pointer>& retOffers, Database& db)
+// Query for the offers selling `selling` for `buying`, best first; the asset
+// codes and issuers to bind to it are appended to `params`.
+static std::string
+bestOffersQuery(Asset const& selling, Asset const& buying,
+                std::vector<std::string>& params, bool after = false)
 {
     std::string sql = offerColumnSelector;
-
-    std::string sellingAssetCode, sellingIssuerStrKey;
-    std::string buyingAssetCode, buyingIssuerStrKey;
-
-    bool useSellingAsset = false;
-    bool useBuyingAsset = false;
+    std::string assetCode;
 
     if (selling.type() == ASSET_TYPE_NATIVE)
     {
@@ -288,22 +286,22 @@ OfferFrame::loadBestOffers(size_t numOffers, size_t offset,
     {
         if (selling.type() == ASSET_TYPE_CREDIT_ALPHANUM4)
         {
-            assetCodeToStr(selling.alphaNum4().assetCode, sellingAssetCode);
-            sellingIssuerStrKey =
-                KeyUtils::toStrKey(selling.alphaNum4().issuer);
+            assetCodeToStr(selling.alphaNum4().assetCode, assetCode);
+            params.emplace_back(assetCode);
+            params.emplace_back(KeyUtils::toStrKey(selling.alphaNum4().issuer));
         }
         else if (selling.type() == ASSET_TYPE_CREDIT_ALPHANUM12)
         {
-            assetCodeToStr(selling.alphaNum12().assetCode, sellingAssetCode);
-            sellingIssuerStrKey =
-                KeyUtils::toStrKey(selling.alphaNum12().issuer);
+            assetCodeToStr(selling.alphaNum12().assetCode, assetCode);
+            params.emplace_back(assetCode);
+            params.emplace_back(
+                KeyUtils::toStrKey(selling.alphaNum12().issuer));
         }
         else
         {
             throw std::runtime_error("unknown asset type");
         }
 
-        useSellingAsset = true;
         sql += " WHERE sellingassetcode = :pcur AND sellingissuer = :pi";
     }
 
@@ -315,48 +313,91 @@ OfferFrame::loadBestOffers(size_t numOffers, size_t offset,
     {
         if (buying.type() == ASSET_TYPE_CREDIT_ALPHANUM4)
         {
-            assetCodeToStr(buying.alphaNum4().assetCode, buyingAssetCode);
-            buyingIssuerStrKey = KeyUtils::toStrKey(buying.alphaNum4().issuer);
+            assetCodeToStr(buying.alphaNum4().assetCode, assetCode);
+            params.emplace_back(assetCode);
+            params.emplace_back(KeyUtils::toStrKey(buying.alphaNum4().issuer));
         }
         else if (buying.type() == ASSET_TYPE_CREDIT_ALPHANUM12)
         {
-            assetCodeToStr(buying.alphaNum12().assetCode, buyingAssetCode);
-            buyingIssuerStrKey = KeyUtils::toStrKey(buying.alphaNum12().issuer);
+            assetCodeToStr(buying.alphaNum12().assetCode, assetCode);
+            params.emplace_back(assetCode);
+            params.emplace_back(KeyUtils::toStrKey(buying.alphaNum12().issuer));
         }
         else
         {
             throw std::runtime_error("unknown asset type");
         }
 
-        useBuyingAsset = true;
         sql += " AND buyingassetcode = :gcur AND buyingissuer = :gi";
     }
 
+    if (after)
+    {
+        sql += " AND (price > :ap OR (price = :ap2 AND offerid > :aid))";
+    }
+
     // price is an approximation of the actual n/d (truncated math, 15 digits)
     // ordering by offerid gives precendence to older offers for fairness
-    sql += " ORDER BY price, offerid LIMIT :n OFFSET :o";
+    sql += " ORDER BY price, offerid";
+    return sql;
+}
+
+void
+OfferFrame::loadBestOffers(size_t numOffers, size_t offset,
+                           Asset const& selling, Asset const& buying,
+                           vector<OfferFrame::pointer>& retOffers, Database& db)
+{
+    std::vector<std::string> params;
+    std::string sql = bestOffersQuery(selling, buying, params);
+    sql += " LIMIT :n OFFSET :o";
 
     auto prep = db.getPreparedStatement(sql);
     auto& st = prep.statement();
-
-    if (useSellingAsset)
+    for (auto const& p : params)
     {
-        st.exchange(use(sellingAssetCode));
-        st.exchange(use(sellingIssuerStrKey));
+        st.exchange(use(p));
     }
+    st.exchange(use(numOffers));
+    st.exchange(use(offset));
 
-    if (useBuyingAsset)
+    auto timer = db.getSelectTimer("offer");
+    loadOffers(prep, [&retOffers](LedgerEntry const& of) {
+        retOffers.emplace_back(make_shared<OfferFrame>(of));
+    });
+}
+
+void
+OfferFrame::loadOrderBook(Asset const& selling, Asset const& buying,
+                          std::pair<double, uint64_t> const* after,
+                          size_t numOffers, std::vector<LedgerEntry>& retOffers,
+                          Database& db)
+{
+    std::vector<std::string> params;
+    std::string sql =
+        bestOffersQuery(selling, buying, params, after != nullptr);
+    sql += " LIMIT :n";
+
+    auto prep = db.getPreparedStatement(sql);
+    auto& st = prep.statement();
+    for (auto const& p : params)
     {
-        st.exchange(use(buyingAssetCode));
-        st.exchange(use(buyingIssuerStrKey));
+        st.exchange(use(p));
+    }
+    double afterPrice = after ? after->first : 0;
+    uint64_t afterID = after ? after->second : 0;
+    if (after)
+    {
+        // Starts right after the last offer loaded, without an OFFSET, which
+        // would have the database skip over all the offers before it again.
+        st.exchange(use(afterPrice));
+        st.exchange(use(afterPrice));
+        st.exchange(use(afterID));
     }
-
     st.exchange(use(numOffers));
-    st.exchange(use(offset));
 
     auto timer = db.getSelectTimer("offer");
     loadOffers(prep, [&retOffers](LedgerEntry const& of) {
-        retOffers.emplace_back(make_shared<OfferFrame>(of));
+        retOffers.emplace_back(of);
     });
 }
 
@@ -416,6 +457,7 @@ void
 OfferFrame::deleteOffersModifiedOnOrAfterLedger(Database& db,
                                                 uint32_t oldestLedger)
 {
+    db.getOrderBook().clear();
     db.getEntryCache().erase_if(
         [oldestLedger](std::shared_ptr<LedgerEntry const> le) -> bool {
             return le && le->data.type() == OFFER &&
@@ -436,6 +478,8 @@ void
 OfferFrame::storeDelete(LedgerDelta& delta, Database& db) const
 {
     storeDelete(delta, db, getKey());
+    // Also lets the order book know which book to drop on rollback.
+    db.getOrderBook().deleted(mEntry);
 }
 
 void
@@ -447,9 +491,86 @@ OfferFrame::storeDelete(LedgerDelta& delta, Database& db, LedgerKey const& key)
     st.exchange(use(key.offer().offerID));
     st.define_and_bind();
     st.execute(true);
+    db.getOrderBook().deleted(key);
     delta.deleteEntry(key);
 }
 
+// Append the type, code and issuer columns of `asset`.
+static void
+addAssetColumns(BulkRows& rows, Asset const& asset)
+{
+    rows.addNumber(static_cast<unsigned int>(asset.type()));
+    std::string assetCode;
+    switch (asset.type())
+    {
+    case ASSET_TYPE_CREDIT_ALPHANUM4:
+        assetCodeToStr(asset.alphaNum4().assetCode, assetCode);
+        rows.add(assetCode);
+        rows.add(KeyUtils::toStrKey(asset.alphaNum4().issuer));
+        break;
+    case ASSET_TYPE_CREDIT_ALPHANUM12:
+        assetCodeToStr(asset.alphaNum12().assetCode, assetCode);
+        rows.add(assetCode);
+        rows.add(KeyUtils::toStrKey(asset.alphaNum12().issuer));
+        break;
+    default:
+        rows.addNull();
+        rows.addNull();
+        break;
+    }
+}
+
+void
+OfferFrame::storeBulk(Database& db, soci::session& sess,
+                      std::vector<LedgerEntry> const& live,
+                      std::vector<LedgerKey> const& dead)
+{
+    BulkRows keys("offers", {{"offerid", "BIGINT"}});
+    BulkRows offers("offers", {{"sellerid", "TEXT"},
+                               {"offerid", "BIGINT"},
+                               {"sellingassettype", "INT"},
+                               {"sellingassetcode", "TEXT"},
+                               {"sellingissuer", "TEXT"},
+                               {"buyingassettype", "INT"},
+                               {"buyingassetcode", "TEXT"},
+                               {"buyingissuer", "TEXT"},
+                               {"amount", "BIGINT"},
+                               {"pricen", "INT"},
+                               {"priced", "INT"},
+                               {"price", "DOUBLE PRECISION"},
+                               {"flags", "INT"},
+                               {"lastmodified", "INT"}});
+
+    for (auto const& key : dead)
+    {
+        keys.addNumber(key.offer().offerID);
+    }
+
+    for (auto const& entry : live)
+    {
+        if (!isValid(entry))
+        {
+            throw std::runtime_error("Invalid offer");
+        }
+        auto const& offer = entry.data.offer();
+        keys.addNumber(offer.offerID);
+
+        offers.add(KeyUtils::toStrKey(offer.sellerID));
+        offers.addNumber(offer.offerID);
+        addAssetColumns(offers, offer.selling);
+        addAssetColumns(offers, offer.buying);
+        offers.addNumber(offer.amount);
+        offers.addNumber(offer.price.n);
+        offers.addNumber(offer.price.d);
+        offers.addNumber(double(offer.price.n) / double(offer.price.d));
+        offers.addNumber(offer.flags);
+        offers.addNumber(entry.lastModifiedLedgerSeq);
+    }
+
+    keys.erase(db, sess, "offer");
+    offers.insert(db, sess, "offer");
+}
+
 double
 OfferFrame::computePrice() const
 {
@@ -566,6 +687,7 @@ OfferFrame::storeUpdateHelper(LedgerDelta& delta, Database& db, bool insert)
     {
         throw std::runtime_error("could not update SQL");
     }
+    db.getOrderBook().stored(mEntry);
 
     if (insert)
     {
@@ -580,6 +702,7 @@ OfferFrame::storeUpdateHelper(LedgerDelta& delta, Database& db, bool insert)
 void
 OfferFrame::dropAll(Database& db)
 {
+    db.getOrderBook().clear();
     db.getSession() << "DROP TABLE IF EXISTS offers;";
     db.getSession() << kSQLCreateStatement1;
     db.getSession() << kSQLCreateStatement2;
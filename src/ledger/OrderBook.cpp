@@ -0,0 +1,235 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "ledger/OrderBook.h"
+#include "ledger/OfferFrame.h"
+#include <algorithm>
+#include <cassert>
+
+namespace stellar
+{
+using xdr::operator<;
+
+bool
+OrderBook::AssetPairCmp::operator()(AssetPair const& x,
+                                    AssetPair const& y) const
+{
+    if (x.first < y.first)
+    {
+        return true;
+    }
+    if (y.first < x.first)
+    {
+        return false;
+    }
+    return x.second < y.second;
+}
+
+OrderBook::AssetPair
+OrderBook::pairOf(OfferEntry const& offer)
+{
+    return std::make_pair(offer.selling, offer.buying);
+}
+
+OrderBook::Position
+OrderBook::positionOf(OfferEntry const& offer)
+{
+    // Must match OfferFrame::computePrice, which fills the price column
+    // loadBestOffers sorts on.
+    return std::make_pair(double(offer.price.n) / double(offer.price.d),
+                          offer.offerID);
+}
+
+OrderBook::OrderBook(size_t maxEntries, size_t pageSize)
+    : mMaxEntries(maxEntries), mPageSize(std::max<size_t>(pageSize, 1))
+{
+}
+
+void
+OrderBook::remove(uint64_t offerID)
+{
+    auto it = mLocations.find(offerID);
+    if (it == mLocations.end())
+    {
+        return;
+    }
+    auto book = mBooks.find(it->second.mPair);
+    assert(book != mBooks.end());
+    mNumEntries -= book->second.mOffers.erase(it->second.mPosition);
+    mTouched[offerID].insert(it->second.mPair);
+    mLocations.erase(it);
+}
+
+void
+OrderBook::unload(AssetPair const& pair)
+{
+    auto it = mBooks.find(pair);
+    if (it == mBooks.end())
+    {
+        return;
+    }
+    for (auto const& offer : it->second.mOffers)
+    {
+        mLocations.erase(offer.first.second);
+    }
+    mNumEntries -= it->second.mOffers.size();
+    mLru.erase(it->second.mLru);
+    mBooks.erase(it);
+}
+
+void
+OrderBook::loadPage(AssetPair const& pair, LoadedBook& book, Database& db)
+{
+    std::vector<LedgerEntry> offers;
+    OfferFrame::loadOrderBook(pair.first, pair.second,
+                              book.mEnd.second == 0 ? nullptr : &book.mEnd,
+                              mPageSize, offers, db);
+    book.mComplete = offers.size() < mPageSize;
+    for (auto& le : offers)
+    {
+        auto pos = positionOf(le.data.offer());
+        mLocations[le.data.offer().offerID] = Location{pair, pos};
+        book.mOffers.emplace_hint(
+            book.mOffers.end(), pos,
+            std::make_shared<LedgerEntry const>(std::move(le)));
+        book.mEnd = pos;
+    }
+    mNumEntries += offers.size();
+}
+
+OrderBook::LoadedBook&
+OrderBook::loadBook(AssetPair const& pair, Database& db)
+{
+    auto it = mBooks.find(pair);
+    if (it != mBooks.end())
+    {
+        mLru.splice(mLru.begin(), mLru, it->second.mLru);
+        return it->second;
+    }
+
+    auto& book = mBooks[pair];
+    mLru.push_front(pair);
+    book.mLru = mLru.begin();
+    loadPage(pair, book, db);
+    return book;
+}
+
+void
+OrderBook::evict()
+{
+    // The most recently used book stays, however large: it is in use.
+    while (mNumEntries > mMaxEntries && mLru.size() > 1)
+    {
+        unload(mLru.back());
+    }
+}
+
+OrderBook::Book const&
+OrderBook::getBook(Asset const& selling, Asset const& buying, Database& db)
+{
+    auto& book = loadBook(std::make_pair(selling, buying), db);
+    evict();
+    return book.mOffers;
+}
+
+bool
+OrderBook::loadMore(Asset const& selling, Asset const& buying, Database& db)
+{
+    auto pair = std::make_pair(selling, buying);
+    auto& book = loadBook(pair, db);
+    if (book.mComplete)
+    {
+        return false;
+    }
+    auto before = book.mOffers.size();
+    loadPage(pair, book, db);
+    evict();
+    return book.mOffers.size() != before;
+}
+
+void
+OrderBook::stored(LedgerEntry const& offer)
+{
+    auto const& oe = offer.data.offer();
+    remove(oe.offerID);
+    auto pair = pairOf(oe);
+    mTouched[oe.offerID].insert(pair);
+
+    auto it = mBooks.find(pair);
+    if (it == mBooks.end())
+    {
+        return;
+    }
+    auto pos = positionOf(oe);
+    auto& book = it->second;
+    if (!book.mComplete && book.mEnd < pos)
+    {
+        // Past the pages loaded: a later page gets it from the database.
+        return;
+    }
+    auto inserted = book.mOffers.insert(
+        std::make_pair(pos, std::make_shared<LedgerEntry const>(offer)));
+    assert(inserted.second);
+    mNumEntries++;
+    mLocations[oe.offerID] = Location{pair, pos};
+}
+
+void
+OrderBook::deleted(LedgerEntry const& offer)
+{
+    remove(offer.data.offer().offerID);
+    mTouched[offer.data.offer().offerID].insert(pairOf(offer.data.offer()));
+}
+
+void
+OrderBook::deleted(LedgerKey const& key)
+{
+    // If the offer isn't in a loaded book, its pair is unknown, and so will
+    // be the book to drop should this be rolled back: see rolledBack.
+    remove(key.offer().offerID);
+}
+
+void
+OrderBook::rolledBack(LedgerKey const& key)
+{
+    auto it = mTouched.find(key.offer().offerID);
+    if (it == mTouched.end())
+    {
+        clear();
+        return;
+    }
+    for (auto const& pair : it->second)
+    {
+        unload(pair);
+    }
+}
+
+void
+OrderBook::committed()
+{
+    mTouched.clear();
+}
+
+void
+OrderBook::clear()
+{
+    mBooks.clear();
+    mLru.clear();
+    mNumEntries = 0;
+    mLocations.clear();
+    mTouched.clear();
+}
+
+size_t
+OrderBook::numBooks() const
+{
+    return mBooks.size();
+}
+
+size_t
+OrderBook::numEntries() const
+{
+    return mNumEntries;
+}
+}
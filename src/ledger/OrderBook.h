@@ -0,0 +1,130 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/StellarXDR.h"
+#include "util/NonCopyable.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace stellar
+{
+
+class Database;
+
+/**
+ * In-memory copy of the offers of the asset pairs that have been traded on,
+ * so that crossing offers walks a sorted map instead of paging through the
+ * offers table with ever-growing SQL OFFSETs.
+ *
+ * A pair's book is loaded from the database the first time it is asked for,
+ * a page of its best offers at a time, further pages being loaded only as
+ * crossing walks past them. It is then kept in step with the database by
+ * OfferFrame, which reports every offer it stores or deletes. Once more than
+ * `maxEntries` offers are loaded, the least recently used books are dropped,
+ * to be loaded again when next needed.
+ *
+ * Like the entry cache, it follows the database state inside the ledger's
+ * transaction, so it must be told when changes are rolled back: LedgerDelta
+ * does so, and books touched by the rolled-back offers are dropped and
+ * reloaded on next use. Anything else writing offers, like applying buckets,
+ * must clear it.
+ *
+ * Only used from the main thread.
+ */
+class OrderBook : NonMovableOrCopyable
+{
+  public:
+    // Offers of a book are ordered as by loadBestOffers: by price, as
+    // computed by OfferFrame, then by ID, so older offers come first.
+    typedef std::pair<double, uint64_t> Position;
+    typedef std::map<Position, std::shared_ptr<LedgerEntry const>> Book;
+
+  private:
+    typedef std::pair<Asset, Asset> AssetPair;
+
+    struct AssetPairCmp
+    {
+        bool operator()(AssetPair const& x, AssetPair const& y) const;
+    };
+
+    struct Location
+    {
+        AssetPair mPair;
+        Position mPosition;
+    };
+
+    struct LoadedBook
+    {
+        // the best offers of the pair, up to mEnd unless mComplete
+        Book mOffers;
+        // last offer loaded; offer IDs start at 1, so none if 0
+        Position mEnd{0, 0};
+        bool mComplete{false};
+        std::list<AssetPair>::iterator mLru;
+    };
+
+    size_t const mMaxEntries;
+    size_t const mPageSize;
+
+    std::map<AssetPair, LoadedBook, AssetPairCmp> mBooks;
+    // Pairs of the loaded books, most recently used first.
+    std::list<AssetPair> mLru;
+    size_t mNumEntries{0};
+    // Where each offer of a loaded book is.
+    std::unordered_map<uint64_t, Location> mLocations;
+    // Pairs of the books each offer has been stored into or deleted from
+    // since the last ledger was committed, to drop on rollback.
+    std::unordered_map<uint64_t, std::set<AssetPair, AssetPairCmp>> mTouched;
+
+    static AssetPair pairOf(OfferEntry const& offer);
+    static Position positionOf(OfferEntry const& offer);
+
+    void remove(uint64_t offerID);
+    void unload(AssetPair const& pair);
+    void loadPage(AssetPair const& pair, LoadedBook& book, Database& db);
+    LoadedBook& loadBook(AssetPair const& pair, Database& db);
+    void evict();
+
+  public:
+    static size_t const DEFAULT_PAGE_SIZE = 256;
+
+    explicit OrderBook(size_t maxEntries, size_t pageSize = DEFAULT_PAGE_SIZE);
+
+    // The best offers selling `selling` for `buying`, loading them if need
+    // be: all of them, or as many pages as were asked for so far. Valid until
+    // the next change to the order book.
+    Book const& getBook(Asset const& selling, Asset const& buying,
+                        Database& db);
+
+    // Loads the next page of offers of the book; false if it was complete.
+    bool loadMore(Asset const& selling, Asset const& buying, Database& db);
+
+    // Record that `offer` was inserted or updated in the database.
+    void stored(LedgerEntry const& offer);
+
+    // Record that the offer was deleted from the database.
+    void deleted(LedgerEntry const& offer);
+    void deleted(LedgerKey const& key);
+
+    // Changes to the offer were rolled back.
+    void rolledBack(LedgerKey const& key);
+
+    // The changes of the ledger being closed were committed; they can no
+    // longer be rolled back.
+    void committed();
+
+    void clear();
+
+    // Number of books loaded.
+    size_t numBooks() const;
+    // Number of offers loaded, across all books.
+    size_t numEntries() const;
+};
+}
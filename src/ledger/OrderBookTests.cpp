@@ -0,0 +1,215 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "database/Database.h"
+#include "ledger/LedgerDelta.h"
+#include "ledger/LedgerManager.h"
+#include "ledger/LedgerTestUtils.h"
+#include "ledger/OfferFrame.h"
+#include "ledger/OrderBook.h"
+#include "lib/catch.hpp"
+#include "main/Application.h"
+#include "test/TestUtils.h"
+#include "test/test.h"
+
+using namespace stellar;
+
+namespace stellar
+{
+using xdr::operator==;
+}
+
+TEST_CASE("order book follows the offers table", "[ledger][orderbook]")
+{
+    VirtualClock clock;
+    Application::pointer app = createTestApplication(clock, getTestConfig());
+    app->start();
+    auto& db = app->getDatabase();
+    auto& orderBook = db.getOrderBook();
+    auto& header = app->getLedgerManager().getCurrentLedgerHeader();
+
+    auto generated = LedgerTestUtils::generateValidOfferEntries(60);
+    Asset selling = generated[0].selling;
+    Asset buying = generated[0].buying;
+    std::vector<OfferFrame> offers;
+    for (size_t i = 0; i < generated.size(); ++i)
+    {
+        LedgerEntry le;
+        le.data.type(OFFER);
+        le.data.offer() = generated[i];
+        auto& oe = le.data.offer();
+        oe.offerID = i + 1;
+        oe.selling = selling;
+        oe.buying = buying;
+        // Few distinct prices, so that ties are broken by offer ID.
+        oe.price.n = 1 + i % 4;
+        oe.price.d = 3;
+        offers.emplace_back(le);
+    }
+
+    auto checkBook = [&]() {
+        std::vector<OfferFrame::pointer> fromDb;
+        OfferFrame::loadBestOffers(1000, 0, selling, buying, fromDb, db);
+        while (orderBook.loadMore(selling, buying, db))
+        {
+        }
+        auto const& book = orderBook.getBook(selling, buying, db);
+        REQUIRE(book.size() == fromDb.size());
+        auto it = book.begin();
+        for (auto const& offer : fromDb)
+        {
+            REQUIRE(*it->second == offer->mEntry);
+            ++it;
+        }
+    };
+
+    LedgerDelta delta(header, db);
+    for (size_t i = 0; i < 30; ++i)
+    {
+        offers[i].storeAdd(delta, db);
+    }
+    checkBook();
+
+    // The book is loaded: further changes update it in place.
+    for (size_t i = 30; i < offers.size(); ++i)
+    {
+        offers[i].storeAdd(delta, db);
+    }
+    for (size_t i = 0; i < offers.size(); i += 5)
+    {
+        offers[i].getOffer().price.n += 2;
+        offers[i].storeChange(delta, db);
+    }
+    for (size_t i = 1; i < offers.size(); i += 7)
+    {
+        offers[i].storeDelete(delta, db);
+    }
+    offers[2].getOffer().buying = selling;
+    offers[2].getOffer().selling = buying;
+    offers[2].storeChange(delta, db);
+    checkBook();
+    delta.commit();
+    REQUIRE(orderBook.getBook(buying, selling, db).size() == 1);
+    REQUIRE(orderBook.numBooks() == 2);
+
+    SECTION("rollback drops the touched books")
+    {
+        {
+            soci::transaction sqlTx(db.getSession());
+            LedgerDelta inner(header, db);
+            offers[3].storeDelete(inner, db);
+            offers[4].getOffer().price.n = 1;
+            offers[4].storeChange(inner, db);
+            checkBook();
+        }
+        REQUIRE(orderBook.numBooks() == 1);
+        checkBook();
+    }
+
+    SECTION("clearing forgets all books")
+    {
+        orderBook.clear();
+        REQUIRE(orderBook.numBooks() == 0);
+        checkBook();
+    }
+}
+
+TEST_CASE("order book pages and evicts books", "[ledger][orderbook]")
+{
+    VirtualClock clock;
+    Application::pointer app = createTestApplication(clock, getTestConfig());
+    app->start();
+    auto& db = app->getDatabase();
+    auto& header = app->getLedgerManager().getCurrentLedgerHeader();
+
+    // Three books of 20 offers each.
+    auto generated = LedgerTestUtils::generateValidOfferEntries(60);
+    std::vector<std::pair<Asset, Asset>> pairs;
+    LedgerDelta delta(header, db);
+    for (size_t i = 0; i < generated.size(); ++i)
+    {
+        if (i % 20 == 0)
+        {
+            pairs.emplace_back(generated[i].selling, generated[i].buying);
+        }
+        LedgerEntry le;
+        le.data.type(OFFER);
+        le.data.offer() = generated[i];
+        auto& oe = le.data.offer();
+        oe.offerID = i + 1;
+        oe.selling = pairs.back().first;
+        oe.buying = pairs.back().second;
+        oe.price.n = 1 + i % 7;
+        oe.price.d = 5;
+        OfferFrame(le).storeAdd(delta, db);
+    }
+    delta.commit();
+
+    auto bestOffers = [&](std::pair<Asset, Asset> const& pair, size_t n) {
+        std::vector<OfferFrame::pointer> fromDb;
+        OfferFrame::loadBestOffers(n, 0, pair.first, pair.second, fromDb, db);
+        return fromDb;
+    };
+    auto sameOffers = [](OrderBook::Book const& book,
+                         std::vector<OfferFrame::pointer> const& fromDb) {
+        REQUIRE(book.size() == fromDb.size());
+        auto it = book.begin();
+        for (auto const& offer : fromDb)
+        {
+            REQUIRE(*it->second == offer->mEntry);
+            ++it;
+        }
+    };
+
+    // At most 30 offers, loaded 8 at a time.
+    OrderBook orderBook(30, 8);
+
+    SECTION("books are loaded a page at a time")
+    {
+        auto const& pair = pairs[0];
+        sameOffers(orderBook.getBook(pair.first, pair.second, db),
+                   bestOffers(pair, 8));
+        REQUIRE(orderBook.loadMore(pair.first, pair.second, db));
+        sameOffers(orderBook.getBook(pair.first, pair.second, db),
+                   bestOffers(pair, 16));
+        REQUIRE(orderBook.loadMore(pair.first, pair.second, db));
+        REQUIRE(!orderBook.loadMore(pair.first, pair.second, db));
+        sameOffers(orderBook.getBook(pair.first, pair.second, db),
+                   bestOffers(pair, 20));
+        REQUIRE(orderBook.numEntries() == 20);
+    }
+
+    SECTION("least recently used books are dropped")
+    {
+        for (auto const& pair : pairs)
+        {
+            orderBook.getBook(pair.first, pair.second, db);
+            while (orderBook.loadMore(pair.first, pair.second, db))
+            {
+            }
+        }
+        // Loading the second book completely dropped the first, and the
+        // third dropped the second.
+        REQUIRE(orderBook.numBooks() == 1);
+        REQUIRE(orderBook.numEntries() == 20);
+
+        // Using a book keeps it over the others.
+        orderBook.getBook(pairs[0].first, pairs[0].second, db);
+        REQUIRE(orderBook.numBooks() == 2);
+        orderBook.getBook(pairs[2].first, pairs[2].second, db);
+        orderBook.getBook(pairs[1].first, pairs[1].second, db);
+        REQUIRE(orderBook.numEntries() <= 30);
+        REQUIRE(orderBook.numBooks() == 2);
+
+        // Dropped books are loaded again as they were.
+        for (auto const& pair : pairs)
+        {
+            while (orderBook.loadMore(pair.first, pair.second, db))
+            {
+            }
+            sameOffers(orderBook.getBook(pair.first, pair.second, db),
+                       bestOffers(pair, 20));
+        }
+    }
+}
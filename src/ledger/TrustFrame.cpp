@@ -7,6 +7,7 @@
 #include "crypto/KeyUtils.h"
 #include "crypto/SHA.h"
 #include "crypto/SecretKey.h"
+#include "database/BulkRows.h"
 #include "database/Database.h"
 #include "ledger/LedgerRange.h"
 #include "util/types.h"
@@ -247,6 +248,60 @@ TrustFrame::storeDelete(LedgerDelta& delta, Database& db, LedgerKey const& key)
     delta.deleteEntry(key);
 }
 
+void
+TrustFrame::storeBulk(Database& db, soci::session& sess,
+                      std::vector<LedgerEntry> const& live,
+                      std::vector<LedgerKey> const& dead)
+{
+    BulkRows keys("trustlines", {{"accountid", "TEXT"},
+                                 {"issuer", "TEXT"},
+                                 {"assetcode", "TEXT"}});
+    BulkRows lines("trustlines", {{"accountid", "TEXT"},
+                                  {"assettype", "INT"},
+                                  {"issuer", "TEXT"},
+                                  {"assetcode", "TEXT"},
+                                  {"balance", "BIGINT"},
+                                  {"tlimit", "BIGINT"},
+                                  {"flags", "INT"},
+                                  {"lastmodified", "INT"}});
+
+    for (auto const& key : dead)
+    {
+        std::string actIDStrKey, issuerStrKey, assetCode;
+        getKeyFields(key, actIDStrKey, issuerStrKey, assetCode);
+        keys.add(actIDStrKey);
+        keys.add(issuerStrKey);
+        keys.add(assetCode);
+    }
+
+    for (auto const& entry : live)
+    {
+        if (!isValid(entry))
+        {
+            throw std::runtime_error("Invalid TrustEntry");
+        }
+        auto key = LedgerEntryKey(entry);
+        std::string actIDStrKey, issuerStrKey, assetCode;
+        getKeyFields(key, actIDStrKey, issuerStrKey, assetCode);
+        keys.add(actIDStrKey);
+        keys.add(issuerStrKey);
+        keys.add(assetCode);
+
+        auto const& tl = entry.data.trustLine();
+        lines.add(actIDStrKey);
+        lines.addNumber(static_cast<unsigned int>(tl.asset.type()));
+        lines.add(issuerStrKey);
+        lines.add(assetCode);
+        lines.addNumber(tl.balance);
+        lines.addNumber(tl.limit);
+        lines.addNumber(tl.flags);
+        lines.addNumber(entry.lastModifiedLedgerSeq);
+    }
+
+    keys.erase(db, sess, "trust");
+    lines.insert(db, sess, "trust");
+}
+
 void
 TrustFrame::storeChange(LedgerDelta& delta, Database& db)
 {
@@ -440,6 +495,58 @@ TrustFrame::loadTrustLine(AccountID const& accountID, Asset const& asset,
     return retLine;
 }
 
+void
+TrustFrame::loadTrustLines(std::vector<LedgerKey> const& keys, Database& db)
+{
+    // Accounts have few trust lines, so query all the lines of the accounts
+    // and keep the ones asked for.
+    std::vector<std::string> accounts;
+    {
+        std::unordered_set<AccountID> seen;
+        for (auto const& key : keys)
+        {
+            if (seen.insert(key.trustLine().accountID).second)
+            {
+                accounts.emplace_back(
+                    KeyUtils::toStrKey(key.trustLine().accountID));
+            }
+        }
+    }
+
+    std::unordered_set<LedgerKey> missing(keys.begin(), keys.end());
+    auto query = std::string(trustLineColumnSelector);
+    query += " WHERE accountid IN " + prefetchPlaceholders();
+    for (size_t i = 0; i < accounts.size(); i += kPrefetchBatchSize)
+    {
+        std::vector<std::string> batch;
+        for (size_t j = i; j < i + kPrefetchBatchSize; ++j)
+        {
+            batch.emplace_back(accounts[std::min(j, accounts.size() - 1)]);
+        }
+
+        auto prep = db.getPreparedStatement(query);
+        auto& st = prep.statement();
+        for (auto& a : batch)
+        {
+            st.exchange(use(a));
+        }
+
+        auto timer = db.getSelectTimer("trust");
+        loadLines(prep, [&missing, &db](LedgerEntry const& trust) {
+            auto key = LedgerEntryKey(trust);
+            if (missing.erase(key) != 0)
+            {
+                putCachedEntry(key, make_shared<LedgerEntry const>(trust), db);
+            }
+        });
+    }
+
+    for (auto const& key : missing)
+    {
+        putCachedEntry(key, nullptr, db);
+    }
+}
+
 std::pair<TrustFrame::pointer, AccountFrame::pointer>
 TrustFrame::loadTrustLineIssuer(AccountID const& accountID, Asset const& asset,
                                 Database& db, LedgerDelta& delta)
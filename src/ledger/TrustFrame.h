@@ -64,6 +64,16 @@ class TrustFrame : public EntryFrame
     // Static helper that don't assume an instance.
     static void storeDelete(LedgerDelta& delta, Database& db,
                             LedgerKey const& key);
+
+    // Replace, in bulk, the rows of a batch of entries applied from a bucket:
+    // the rows for every entry in `live` and every key in `dead` are deleted,
+    // then every entry in `live` is inserted. Keys must be distinct.
+    //
+    // Statements run on `sess`, which may be a pool session used from a
+    // worker thread (see BulkRows); the entry cache is left to the caller.
+    static void storeBulk(Database& db, soci::session& sess,
+                          std::vector<LedgerEntry> const& live,
+                          std::vector<LedgerKey> const& dead);
     static bool exists(Database& db, LedgerKey const& key);
     static uint64_t countObjects(soci::session& sess);
     static uint64_t countObjects(soci::session& sess,
@@ -75,6 +85,11 @@ class TrustFrame : public EntryFrame
     static pointer loadTrustLine(AccountID const& accountID, Asset const& asset,
                                  Database& db, LedgerDelta* delta = nullptr);
 
+    // Load many trust lines, none of them of an issuer, into the entry cache
+    // at once; see EntryFrame::prefetch.
+    static void loadTrustLines(std::vector<LedgerKey> const& keys,
+                               Database& db);
+
     // overload that also returns the issuer
     static std::pair<TrustFrame::pointer, AccountFrame::pointer>
     loadTrustLineIssuer(AccountID const& accountID, Asset const& asset,
@@ -66,6 +66,12 @@ ApplicationImpl::ApplicationImpl(VirtualClock& clock, Config const& cfg)
     , mAppStateCurrent(mMetrics->NewCounter({"app", "state", "current"}))
     , mAppStateChanges(mMetrics->NewTimer({"app", "state", "changes"}))
     , mLastStateChange(clock.now())
+    , mVerifySigHit(
+          mMetrics->NewMeter({"crypto", "verify", "hit"}, "signature"))
+    , mVerifySigMiss(
+          mMetrics->NewMeter({"crypto", "verify", "miss"}, "signature"))
+    , mVerifySigTotal(
+          mMetrics->NewMeter({"crypto", "verify", "total"}, "signature"))
 {
 #ifdef SIGQUIT
     mStopSignals.add(SIGQUIT);
@@ -77,6 +83,9 @@ ApplicationImpl::ApplicationImpl(VirtualClock& clock, Config const& cfg)
     std::srand(static_cast<uint32>(clock.now().time_since_epoch().count()));
 
     mNetworkID = sha256(mConfig.NETWORK_PASSPHRASE);
+    PubKeyUtils::setVerifySigCacheSize(mConfig.VERIFY_SIG_CACHE_SIZE);
+    PubKeyUtils::getVerifySigCacheCounts(mVerifySigHitsSynced,
+                                         mVerifySigMissesSynced);
 
     unsigned t = std::thread::hardware_concurrency();
     LOG(DEBUG) << "Application constructing "
@@ -572,15 +581,16 @@ ApplicationImpl::syncOwnMetrics()
         mLastStateChange = now;
     }
 
-    // Flush crypto pure-global-cache stats. They don't belong
-    // to a single app instance but first one to flush will claim
-    // them.
+    // Sync crypto pure-global-cache stats. They don't belong to a single app
+    // instance: every app reports those of the whole process.
     uint64_t vhit = 0, vmiss = 0;
-    PubKeyUtils::flushVerifySigCacheCounts(vhit, vmiss);
-    mMetrics->NewMeter({"crypto", "verify", "hit"}, "signature").Mark(vhit);
-    mMetrics->NewMeter({"crypto", "verify", "miss"}, "signature").Mark(vmiss);
-    mMetrics->NewMeter({"crypto", "verify", "total"}, "signature")
-        .Mark(vhit + vmiss);
+    PubKeyUtils::getVerifySigCacheCounts(vhit, vmiss);
+    mVerifySigHit.Mark(vhit - mVerifySigHitsSynced);
+    mVerifySigMiss.Mark(vmiss - mVerifySigMissesSynced);
+    mVerifySigTotal.Mark(vhit - mVerifySigHitsSynced + vmiss -
+                         mVerifySigMissesSynced);
+    mVerifySigHitsSynced = vhit;
+    mVerifySigMissesSynced = vmiss;
 
     // Similarly, flush global process-table stats.
     mMetrics->NewCounter({"process", "memory", "handles"})
@@ -14,6 +14,7 @@
 namespace medida
 {
 class Counter;
+class Meter;
 class Timer;
 }
 
@@ -157,6 +158,14 @@ class ApplicationImpl : public Application
     medida::Timer& mAppStateChanges;
     VirtualClock::time_point mLastStateChange;
 
+    // Lookups in the process-wide signature verification cache, marked with
+    // what happened since the last sync.
+    medida::Meter& mVerifySigHit;
+    medida::Meter& mVerifySigMiss;
+    medida::Meter& mVerifySigTotal;
+    uint64_t mVerifySigHitsSynced{0};
+    uint64_t mVerifySigMissesSynced{0};
+
     Hash mNetworkID;
 
     void shutdownMainIOService();
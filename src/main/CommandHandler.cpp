@@ -410,6 +410,7 @@ CommandHandler::peers(std::string const& params, std::string& retStr)
         root["peers"][counter]["olver"] = (int)peer->getRemoteOverlayVersion();
         root["peers"][counter]["id"] =
             mApp.getConfig().toStrKey(peer->getPeerID());
+        peer->dumpInfo(root["peers"][counter]);
 
         counter++;
     }
@@ -7,6 +7,7 @@
 #include "StellarCoreVersion.h"
 #include "crypto/Hex.h"
 #include "crypto/KeyUtils.h"
+#include "history/ArchiveFetcher.h"
 #include "history/HistoryArchive.h"
 #include "ledger/LedgerManager.h"
 #include "scp/LocalNode.h"
@@ -21,6 +22,7 @@ namespace stellar
 using xdr::operator<;
 
 const int Config::CURRENT_LEDGER_PROTOCOL_VERSION = 9;
+const size_t Config::DEFAULT_VERIFY_SIG_CACHE_SIZE;
 
 Config::Config() : NODE_SEED(SecretKey::random())
 {
@@ -65,11 +67,17 @@ Config::Config() : NODE_SEED(SecretKey::random())
     MAX_PEER_CONNECTIONS = 12;
     PEER_AUTHENTICATION_TIMEOUT = 2;
     PEER_TIMEOUT = 30;
+    PEER_OUTBOUND_QUEUE_BYTES = 8 * 1024 * 1024;
     PREFERRED_PEERS_ONLY = false;
 
     MINIMUM_IDLE_PERCENT = 0;
 
     MAX_CONCURRENT_SUBPROCESSES = 16;
+    BUCKET_APPLY_BATCH_SIZE = 1024;
+    PARALLEL_BUCKET_APPLY = false;
+    ORDER_BOOK_CACHE_SIZE = 100000;
+    CATCHUP_PIPELINE_DEPTH = 0;
+    VERIFY_SIG_CACHE_SIZE = DEFAULT_VERIFY_SIG_CACHE_SIZE;
     NODE_IS_VALIDATOR = false;
 
     DATABASE = SecretValue{"sqlite3://:memory:"};
@@ -478,6 +486,19 @@ Config::load(std::string const& filename)
                     throw std::invalid_argument("bad PEER_TIMEOUT");
                 PEER_TIMEOUT = static_cast<unsigned short>(v);
             }
+            else if (item.first == "PEER_OUTBOUND_QUEUE_BYTES")
+            {
+                if (!item.second->as<int64_t>())
+                {
+                    throw std::invalid_argument(
+                        "invalid PEER_OUTBOUND_QUEUE_BYTES");
+                }
+                auto v = item.second->as<int64_t>()->value();
+                if (v <= 0)
+                    throw std::invalid_argument(
+                        "bad PEER_OUTBOUND_QUEUE_BYTES");
+                PEER_OUTBOUND_QUEUE_BYTES = static_cast<size_t>(v);
+            }
             else if (item.first == "PREFERRED_PEERS")
             {
                 if (!item.second->is_array())
@@ -553,6 +574,60 @@ Config::load(std::string const& filename)
                 MAX_CONCURRENT_SUBPROCESSES =
                     (size_t)item.second->as<int64_t>()->value();
             }
+            else if (item.first == "BUCKET_APPLY_BATCH_SIZE")
+            {
+                if (!item.second->as<int64_t>() ||
+                    item.second->as<int64_t>()->value() <= 0)
+                {
+                    throw std::invalid_argument(
+                        "invalid BUCKET_APPLY_BATCH_SIZE");
+                }
+                BUCKET_APPLY_BATCH_SIZE =
+                    (size_t)item.second->as<int64_t>()->value();
+            }
+            else if (item.first == "ORDER_BOOK_CACHE_SIZE")
+            {
+                if (!item.second->as<int64_t>() ||
+                    item.second->as<int64_t>()->value() <= 0)
+                {
+                    throw std::invalid_argument(
+                        "invalid ORDER_BOOK_CACHE_SIZE");
+                }
+                ORDER_BOOK_CACHE_SIZE =
+                    (size_t)item.second->as<int64_t>()->value();
+            }
+            else if (item.first == "VERIFY_SIG_CACHE_SIZE")
+            {
+                if (!item.second->as<int64_t>() ||
+                    item.second->as<int64_t>()->value() <= 0)
+                {
+                    throw std::invalid_argument(
+                        "invalid VERIFY_SIG_CACHE_SIZE");
+                }
+                VERIFY_SIG_CACHE_SIZE =
+                    (size_t)item.second->as<int64_t>()->value();
+            }
+            else if (item.first == "PARALLEL_BUCKET_APPLY")
+            {
+                if (!item.second->as<bool>())
+                {
+                    throw std::invalid_argument(
+                        "invalid PARALLEL_BUCKET_APPLY");
+                }
+                PARALLEL_BUCKET_APPLY = item.second->as<bool>()->value();
+            }
+            else if (item.first == "CATCHUP_PIPELINE_DEPTH")
+            {
+                if (!item.second->as<int64_t>() ||
+                    item.second->as<int64_t>()->value() < 0 ||
+                    item.second->as<int64_t>()->value() > UINT32_MAX)
+                {
+                    throw std::invalid_argument(
+                        "invalid CATCHUP_PIPELINE_DEPTH");
+                }
+                CATCHUP_PIPELINE_DEPTH =
+                    (uint32_t)item.second->as<int64_t>()->value();
+            }
             else if (item.first == "MINIMUM_IDLE_PERCENT")
             {
                 if (!item.second->as<int64_t>() ||
@@ -578,7 +653,7 @@ Config::load(std::string const& filename)
                             throw std::invalid_argument(
                                 "malformed HISTORY config block");
                         }
-                        std::string get, put, mkdir;
+                        std::string get, put, mkdir, url;
                         for (auto const& c : *tab)
                         {
                             if (c.first == "get")
@@ -593,6 +668,10 @@ Config::load(std::string const& filename)
                             {
                                 mkdir = c.second->as<std::string>()->value();
                             }
+                            else if (c.first == "url")
+                            {
+                                url = c.second->as<std::string>()->value();
+                            }
                             else
                             {
                                 std::string err(
@@ -603,9 +682,17 @@ Config::load(std::string const& filename)
                                 throw std::invalid_argument(err);
                             }
                         }
+                        if (!url.empty() && get.empty() &&
+                            !ArchiveFetcher::supports(url))
+                        {
+                            throw std::invalid_argument(
+                                "unsupported url without get command, "
+                                "within [HISTORY." +
+                                archive.first + "]");
+                        }
                         HISTORY[archive.first] =
-                            std::make_shared<HistoryArchive>(archive.first, get,
-                                                             put, mkdir);
+                            std::make_shared<HistoryArchive>(
+                                archive.first, get, put, mkdir, url);
                     }
                 }
                 else
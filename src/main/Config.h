@@ -33,6 +33,7 @@ class Config : public std::enable_shared_from_this<Config>
 
   public:
     static const int CURRENT_LEDGER_PROTOCOL_VERSION;
+    static const size_t DEFAULT_VERIFY_SIG_CACHE_SIZE = 0x10000;
 
     typedef std::shared_ptr<Config> pointer;
 
@@ -146,6 +147,9 @@ class Config : public std::enable_shared_from_this<Config>
     unsigned MAX_PEER_CONNECTIONS;
     unsigned short PEER_AUTHENTICATION_TIMEOUT;
     unsigned short PEER_TIMEOUT;
+    // bytes of messages queued for a peer past which the oldest flooded
+    // transactions, then fetch replies, are dropped
+    size_t PEER_OUTBOUND_QUEUE_BYTES;
 
     // Peers we will always try to stay connected to
     std::vector<std::string> PREFERRED_PEERS;
@@ -168,6 +172,27 @@ class Config : public std::enable_shared_from_this<Config>
     // process-management config
     size_t MAX_CONCURRENT_SUBPROCESSES;
 
+    // Number of entries written to the database per batch of statements, and
+    // per transaction, when applying buckets during catchup.
+    size_t BUCKET_APPLY_BATCH_SIZE;
+
+    // When set, catchup merges all the buckets it needs to apply into one and
+    // applies that, in parallel over the connection pool on Postgres.
+    bool PARALLEL_BUCKET_APPLY;
+
+    // Number of offers kept in memory by the order book, across the books of
+    // all asset pairs; see OrderBook.
+    size_t ORDER_BOOK_CACHE_SIZE;
+
+    // When non-zero, catchup applies the transactions of each checkpoint as
+    // soon as it is downloaded, while downloading up to this many checkpoints
+    // ahead, instead of downloading all of them first.
+    uint32_t CATCHUP_PIPELINE_DEPTH;
+
+    // Number of signature verification results kept. The cache is shared by
+    // the whole process, so the last application started sets its size.
+    size_t VERIFY_SIG_CACHE_SIZE;
+
     // SCP config
     SecretKey NODE_SEED;
     bool NODE_IS_VALIDATOR;
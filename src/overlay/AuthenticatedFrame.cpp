@@ -0,0 +1,81 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/AuthenticatedFrame.h"
+#include "xdrpp/marshal.h"
+#include <algorithm>
+#include <cstring>
+
+namespace stellar
+{
+
+size_t const AuthenticatedFrame::kHeaderSize;
+size_t const AuthenticatedFrame::kMacSize;
+
+AuthenticatedFrame::Body
+AuthenticatedFrame::serialize(StellarMessage const& msg)
+{
+    return std::make_shared<xdr::opaque_vec<> const>(xdr::xdr_to_opaque(msg));
+}
+
+std::array<uint8_t, 8>
+AuthenticatedFrame::sequenceBytes(uint64_t sequence)
+{
+    std::array<uint8_t, 8> res;
+    for (size_t i = 0; i < res.size(); ++i)
+    {
+        res[i] = static_cast<uint8_t>(sequence >> (8 * (res.size() - 1 - i)));
+    }
+    return res;
+}
+
+AuthenticatedFrame::AuthenticatedFrame(Body body, uint64_t sequence,
+                                       HmacSha256Mac const& mac)
+    : mBody(std::move(body)), mMac(mac)
+{
+    // XDR record mark: the length of the record, with the last-fragment bit
+    uint32_t length = static_cast<uint32_t>(size() - 4);
+    length |= 0x80000000;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        mHeader[i] = static_cast<uint8_t>(length >> (8 * (3 - i)));
+    }
+    // AuthenticatedMessage discriminant: v0
+    std::fill(mHeader.begin() + 4, mHeader.begin() + 8, 0);
+    auto seq = sequenceBytes(sequence);
+    std::copy(seq.begin(), seq.end(), mHeader.begin() + 8);
+}
+
+size_t
+AuthenticatedFrame::sizeOf(xdr::opaque_vec<> const& body)
+{
+    return kHeaderSize + body.size() + kMacSize;
+}
+
+size_t
+AuthenticatedFrame::size() const
+{
+    return sizeOf(*mBody);
+}
+
+std::array<asio::const_buffer, 3>
+AuthenticatedFrame::buffers() const
+{
+    return {{asio::buffer(mHeader), asio::buffer(mBody->data(), mBody->size()),
+             asio::buffer(mMac.mac.data(), mMac.mac.size())}};
+}
+
+xdr::msg_ptr
+AuthenticatedFrame::toMsg() const
+{
+    auto res = xdr::message_t::alloc(size() - 4);
+    auto p = res->data();
+    std::memcpy(p, mHeader.data() + 4, kHeaderSize - 4);
+    p += kHeaderSize - 4;
+    std::memcpy(p, mBody->data(), mBody->size());
+    p += mBody->size();
+    std::memcpy(p, mMac.mac.data(), mMac.mac.size());
+    return res;
+}
+}
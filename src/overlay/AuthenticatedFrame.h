@@ -0,0 +1,61 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/asio.h"
+#include "overlay/StellarXDR.h"
+#include "xdrpp/message.h"
+#include <array>
+#include <memory>
+
+namespace stellar
+{
+
+/**
+ * The bytes of an AuthenticatedMessage for one peer, as written on the wire,
+ * without copying its StellarMessage into them.
+ *
+ * The message is serialized once into a shared body, which a broadcast hands
+ * to every peer; each peer only adds its own header (the XDR record mark, the
+ * union discriminant and its sequence number) and MAC around it. Writers can
+ * send the three parts as they are with buffers().
+ */
+class AuthenticatedFrame
+{
+  public:
+    typedef std::shared_ptr<xdr::opaque_vec<> const> Body;
+
+    // record mark, version and sequence
+    static size_t const kHeaderSize = 16;
+    static size_t const kMacSize = 32;
+
+  private:
+    std::array<uint8_t, kHeaderSize> mHeader;
+    Body mBody;
+    HmacSha256Mac mMac;
+
+  public:
+    // The XDR of `msg`, as the body of frames.
+    static Body serialize(StellarMessage const& msg);
+
+    // The bytes of the sequence number, as covered by the MAC of the frame
+    // along with the body.
+    static std::array<uint8_t, 8> sequenceBytes(uint64_t sequence);
+
+    AuthenticatedFrame(Body body, uint64_t sequence, HmacSha256Mac const& mac);
+
+    // Number of bytes of a frame around `body`.
+    static size_t sizeOf(xdr::opaque_vec<> const& body);
+
+    // Number of bytes of the frame.
+    size_t size() const;
+
+    std::array<asio::const_buffer, 3> buffers() const;
+
+    // A copy of the frame in a single buffer, as xdr::xdr_to_msg would have
+    // produced for the AuthenticatedMessage.
+    xdr::msg_ptr toMsg() const;
+};
+}
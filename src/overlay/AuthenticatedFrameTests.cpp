@@ -0,0 +1,53 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/SHA.h"
+#include "lib/catch.hpp"
+#include "overlay/AuthenticatedFrame.h"
+#include "xdrpp/marshal.h"
+#include <cstring>
+
+using namespace stellar;
+
+TEST_CASE("authenticated frame matches AuthenticatedMessage", "[overlay]")
+{
+    StellarMessage msg;
+    msg.type(DONT_HAVE);
+    msg.dontHave().type = TX_SET;
+    msg.dontHave().reqHash = sha256("some tx set");
+
+    HmacSha256Key key;
+    key.key = sha256("some key");
+    uint64_t sequence = 0x0102030405060708;
+
+    AuthenticatedMessage amsg;
+    amsg.v0().sequence = sequence;
+    amsg.v0().message = msg;
+    amsg.v0().mac = hmacSha256(key, xdr::xdr_to_opaque(sequence, msg));
+    auto expected = xdr::xdr_to_msg(amsg);
+
+    auto body = AuthenticatedFrame::serialize(msg);
+    auto seq = AuthenticatedFrame::sequenceBytes(sequence);
+    auto hmac = HmacSha256::create(key);
+    hmac->add(ByteSlice(seq.data(), seq.size()));
+    hmac->add(*body);
+    AuthenticatedFrame frame(body, sequence, hmac->finish());
+
+    REQUIRE(frame.size() == expected->raw_size());
+    auto actual = frame.toMsg();
+    REQUIRE(actual->raw_size() == expected->raw_size());
+    REQUIRE(std::memcmp(actual->raw_data(), expected->raw_data(),
+                        expected->raw_size()) == 0);
+
+    // The buffers written out are the same bytes.
+    std::vector<char> written;
+    for (auto const& b : frame.buffers())
+    {
+        auto p = asio::buffer_cast<char const*>(b);
+        written.insert(written.end(), p, p + asio::buffer_size(b));
+    }
+    REQUIRE(written.size() == expected->raw_size());
+    REQUIRE(std::memcmp(written.data(), expected->raw_data(),
+                        expected->raw_size()) == 0);
+}
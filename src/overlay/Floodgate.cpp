@@ -84,7 +84,9 @@ Floodgate::broadcast(StellarMessage const& msg, bool force)
     {
         return;
     }
-    Hash index = sha256(xdr::xdr_to_opaque(msg));
+    // serialized once, for both the index and every peer
+    auto body = AuthenticatedFrame::serialize(msg);
+    Hash index = sha256(*body);
     CLOG(TRACE, "Overlay") << "broadcast " << hexAbbrev(index);
 
     auto result = mFloodMap.find(index);
@@ -106,7 +108,7 @@ Floodgate::broadcast(StellarMessage const& msg, bool force)
         if (peersTold.find(peer) == peersTold.end() && peer->isAuthenticated())
         {
             mSendFromBroadcast.Mark();
-            peer->sendMessage(msg);
+            peer->sendMessage(msg, body);
             peersTold.insert(peer);
         }
     }
@@ -39,7 +39,7 @@ LoopbackPeer::getAuthCert()
 }
 
 void
-LoopbackPeer::sendMessage(xdr::msg_ptr&& msg)
+LoopbackPeer::sendMessage(OutboundQueue::Message&& msg)
 {
     if (mRemote.expired())
     {
@@ -55,7 +55,7 @@ LoopbackPeer::sendMessage(xdr::msg_ptr&& msg)
     }
 
     // CLOG(TRACE, "Overlay") << "LoopbackPeer queueing message";
-    mOutQueue.emplace_back(std::move(msg));
+    mOutQueue.emplace_back(authenticate(msg).toMsg());
     // Possibly flush some queued messages if queue's full.
     while (mOutQueue.size() > mMaxQueueDepth && !mCorked)
     {
@@ -0,0 +1,112 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/OutboundQueue.h"
+#include <cassert>
+#include <stdexcept>
+
+namespace stellar
+{
+
+OutboundQueue::Priority
+OutboundQueue::priorityOf(MessageType type)
+{
+    switch (type)
+    {
+    case TRANSACTION:
+        return PRIORITY_TRANSACTION;
+    case TX_SET:
+    case SCP_QUORUMSET:
+        return PRIORITY_FETCH_REPLY;
+    default:
+        return PRIORITY_SCP;
+    }
+}
+
+size_t
+OutboundQueue::bytesOf(Message const& msg)
+{
+    return AuthenticatedFrame::sizeOf(*msg.mBody);
+}
+
+OutboundQueue::OutboundQueue(size_t maxBytes) : mMaxBytes(maxBytes)
+{
+}
+
+size_t
+OutboundQueue::push(Message msg)
+{
+    auto priority = priorityOf(msg.mType);
+    mBytes += bytesOf(msg);
+    mLanes[priority].emplace_back(std::move(msg));
+
+    // a message only makes room by dropping others as unimportant as itself
+    size_t dropped = 0;
+    for (int p = PRIORITY_COUNT - 1;
+         p >= priority && p > PRIORITY_SCP && mBytes > mMaxBytes; --p)
+    {
+        auto& lane = mLanes[p];
+        size_t keep = p == priority ? 1 : 0;
+        while (lane.size() > keep && mBytes > mMaxBytes)
+        {
+            mBytes -= bytesOf(lane.front());
+            lane.pop_front();
+            ++dropped;
+        }
+    }
+    return dropped;
+}
+
+bool
+OutboundQueue::empty() const
+{
+    return size() == 0;
+}
+
+size_t
+OutboundQueue::size() const
+{
+    size_t res = 0;
+    for (auto const& lane : mLanes)
+    {
+        res += lane.size();
+    }
+    return res;
+}
+
+size_t
+OutboundQueue::bytes() const
+{
+    return mBytes;
+}
+
+OutboundQueue::Message const&
+OutboundQueue::front() const
+{
+    for (auto const& lane : mLanes)
+    {
+        if (!lane.empty())
+        {
+            return lane.front();
+        }
+    }
+    assert(false);
+    throw std::runtime_error("front of empty outbound queue");
+}
+
+void
+OutboundQueue::pop()
+{
+    for (auto& lane : mLanes)
+    {
+        if (!lane.empty())
+        {
+            mBytes -= bytesOf(lane.front());
+            lane.pop_front();
+            return;
+        }
+    }
+    assert(false);
+}
+}
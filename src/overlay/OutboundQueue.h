@@ -0,0 +1,74 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "overlay/AuthenticatedFrame.h"
+#include "overlay/StellarXDR.h"
+#include <array>
+#include <deque>
+
+namespace stellar
+{
+
+/**
+ * Messages waiting to be sent to a peer, by priority, within a budget of
+ * bytes.
+ *
+ * SCP and control messages go first, then replies to fetches of transaction
+ * and quorum sets, then flooded transactions; messages of a priority are sent
+ * in the order they were queued. Once the budget is exceeded, the oldest
+ * transactions, then the oldest fetch replies, are dropped to make room for
+ * messages at least as important: a peer that doesn't keep up would otherwise
+ * have its SCP messages wait behind, and our memory fill with, a transaction
+ * storm. SCP and control messages are never dropped.
+ *
+ * Messages are not yet given their sequence number and MAC, which depend on
+ * the order they end up being sent in.
+ */
+class OutboundQueue
+{
+  public:
+    enum Priority
+    {
+        PRIORITY_SCP = 0,
+        PRIORITY_FETCH_REPLY = 1,
+        PRIORITY_TRANSACTION = 2,
+        PRIORITY_COUNT = 3
+    };
+
+    struct Message
+    {
+        MessageType mType;
+        AuthenticatedFrame::Body mBody;
+    };
+
+    static Priority priorityOf(MessageType type);
+
+  private:
+    size_t const mMaxBytes;
+    size_t mBytes{0};
+    std::array<std::deque<Message>, PRIORITY_COUNT> mLanes;
+
+    static size_t bytesOf(Message const& msg);
+
+  public:
+    explicit OutboundQueue(size_t maxBytes);
+
+    // Queues `msg`, then drops the oldest messages of its priority or lower
+    // until back within budget, but never `msg` itself. Returns the number of
+    // messages dropped.
+    size_t push(Message msg);
+
+    bool empty() const;
+    // Number of messages queued.
+    size_t size() const;
+    // Bytes of the frames of the messages queued.
+    size_t bytes() const;
+
+    // The next message to send.
+    Message const& front() const;
+    void pop();
+};
+}
@@ -0,0 +1,112 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "lib/catch.hpp"
+#include "overlay/OutboundQueue.h"
+
+using namespace stellar;
+
+namespace
+{
+
+// A message of `type` whose frame takes 100 bytes.
+OutboundQueue::Message
+makeMessage(MessageType type, uint8_t tag)
+{
+    auto body = std::make_shared<xdr::opaque_vec<>>(
+        100 - AuthenticatedFrame::kHeaderSize - AuthenticatedFrame::kMacSize,
+        tag);
+    return OutboundQueue::Message{type, body};
+}
+
+uint8_t
+tagOf(OutboundQueue::Message const& msg)
+{
+    return (*msg.mBody)[0];
+}
+}
+
+TEST_CASE("outbound queue priorities", "[overlay][outboundqueue]")
+{
+    OutboundQueue queue(1000);
+    REQUIRE(queue.empty());
+
+    queue.push(makeMessage(TRANSACTION, 1));
+    queue.push(makeMessage(TX_SET, 2));
+    queue.push(makeMessage(TRANSACTION, 3));
+    queue.push(makeMessage(SCP_MESSAGE, 4));
+    queue.push(makeMessage(SCP_QUORUMSET, 5));
+    queue.push(makeMessage(GET_TX_SET, 6));
+    REQUIRE(queue.size() == 6);
+    REQUIRE(queue.bytes() == 600);
+
+    std::vector<uint8_t> order;
+    while (!queue.empty())
+    {
+        order.push_back(tagOf(queue.front()));
+        queue.pop();
+    }
+    REQUIRE(order == std::vector<uint8_t>{4, 6, 2, 5, 1, 3});
+    REQUIRE(queue.bytes() == 0);
+}
+
+TEST_CASE("outbound queue limits", "[overlay][outboundqueue]")
+{
+    OutboundQueue queue(500);
+
+    SECTION("oldest transactions are dropped first")
+    {
+        for (uint8_t i = 0; i < 5; i++)
+        {
+            REQUIRE(queue.push(makeMessage(TRANSACTION, i)) == 0);
+        }
+        REQUIRE(queue.push(makeMessage(TRANSACTION, 5)) == 1);
+        REQUIRE(queue.push(makeMessage(SCP_MESSAGE, 6)) == 1);
+        REQUIRE(queue.size() == 5);
+        REQUIRE(queue.bytes() == 500);
+        REQUIRE(tagOf(queue.front()) == 6);
+        queue.pop();
+        REQUIRE(tagOf(queue.front()) == 2);
+    }
+
+    SECTION("fetch replies only go when transactions are gone")
+    {
+        queue.push(makeMessage(TX_SET, 0));
+        queue.push(makeMessage(TRANSACTION, 1));
+        queue.push(makeMessage(TX_SET, 2));
+        queue.push(makeMessage(TRANSACTION, 3));
+        queue.push(makeMessage(SCP_MESSAGE, 4));
+        REQUIRE(queue.push(makeMessage(SCP_MESSAGE, 5)) == 1);
+        REQUIRE(queue.push(makeMessage(SCP_MESSAGE, 6)) == 1);
+        REQUIRE(queue.push(makeMessage(SCP_MESSAGE, 7)) == 1);
+        REQUIRE(queue.size() == 5);
+        queue.pop();
+        queue.pop();
+        queue.pop();
+        queue.pop();
+        REQUIRE(tagOf(queue.front()) == 2);
+    }
+
+    SECTION("transactions don't make room by dropping fetch replies")
+    {
+        for (uint8_t i = 0; i < 5; i++)
+        {
+            queue.push(makeMessage(SCP_QUORUMSET, i));
+        }
+        REQUIRE(queue.push(makeMessage(TRANSACTION, 5)) == 0);
+        REQUIRE(queue.size() == 6);
+        REQUIRE(queue.push(makeMessage(TRANSACTION, 6)) == 1);
+        REQUIRE(queue.size() == 6);
+    }
+
+    SECTION("SCP messages are never dropped")
+    {
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            REQUIRE(queue.push(makeMessage(SCP_MESSAGE, i)) == 0);
+        }
+        REQUIRE(queue.size() == 8);
+        REQUIRE(queue.bytes() == 800);
+    }
+}
@@ -46,7 +46,7 @@ class PeerStub : public Peer
         return "127.0.0.1";
     }
     virtual void
-    sendMessage(xdr::msg_ptr&& xdrBytes) override
+    sendMessage(OutboundQueue::Message&& msg) override
     {
         sent++;
     }
@@ -444,6 +444,13 @@ msgSummary(StellarMessage const& msg)
 
 void
 Peer::sendMessage(StellarMessage const& msg)
+{
+    sendMessage(msg, AuthenticatedFrame::serialize(msg));
+}
+
+void
+Peer::sendMessage(StellarMessage const& msg,
+                  AuthenticatedFrame::Body const& body)
 {
     if (Logging::logTrace("Overlay"))
         CLOG(TRACE, "Overlay")
@@ -496,17 +503,27 @@ Peer::sendMessage(StellarMessage const& msg)
         break;
     };
 
-    AuthenticatedMessage amsg;
-    amsg.v0().message = msg;
-    if (msg.type() != HELLO && msg.type() != ERROR_MSG)
+    this->sendMessage(OutboundQueue::Message{msg.type(), body});
+}
+
+AuthenticatedFrame
+Peer::authenticate(OutboundQueue::Message const& msg)
+{
+    // Same bytes as the AuthenticatedMessage of msg would serialize to, with
+    // the MAC over the sequence number followed by the message.
+    uint64_t sequence = 0;
+    HmacSha256Mac mac;
+    if (msg.mType != HELLO && msg.mType != ERROR_MSG)
     {
-        amsg.v0().sequence = mSendMacSeq;
-        amsg.v0().mac =
-            hmacSha256(mSendMacKey, xdr::xdr_to_opaque(mSendMacSeq, msg));
+        sequence = mSendMacSeq;
+        auto seq = AuthenticatedFrame::sequenceBytes(sequence);
+        auto hmac = HmacSha256::create(mSendMacKey);
+        hmac->add(ByteSlice(seq.data(), seq.size()));
+        hmac->add(*msg.mBody);
+        mac = hmac->finish();
         ++mSendMacSeq;
     }
-    xdr::msg_ptr xdrBytes(xdr::xdr_to_msg(amsg));
-    this->sendMessage(std::move(xdrBytes));
+    return AuthenticatedFrame(msg.mBody, sequence, mac);
 }
 
 void
@@ -751,21 +768,26 @@ Peer::recvTransaction(StellarMessage const& msg)
     if (transaction)
     {
         // add it to our current set
-        // and make sure it is valid
-        auto recvRes = mApp.getHerder().recvTransaction(transaction);
-
-        if (recvRes == Herder::TX_STATUS_PENDING ||
-            recvRes == Herder::TX_STATUS_DUPLICATE)
-        {
-            // record that this peer sent us this transaction
-            mApp.getOverlayManager().recvFloodedMsg(msg, shared_from_this());
-
-            if (recvRes == Herder::TX_STATUS_PENDING)
-            {
-                // if it's a new transaction, broadcast it
-                mApp.getOverlayManager().broadcastMessage(msg);
-            }
-        }
+        // and make sure it is valid, once the herder gets to it; if it's too
+        // busy to, the transaction is dropped
+        auto self = shared_from_this();
+        mApp.getHerder().recvTransaction(
+            transaction,
+            [self, msg](Herder::TransactionSubmitStatus recvRes) {
+                auto& app = self->getApp();
+                if (recvRes == Herder::TX_STATUS_PENDING ||
+                    recvRes == Herder::TX_STATUS_DUPLICATE)
+                {
+                    // record that this peer sent us this transaction
+                    app.getOverlayManager().recvFloodedMsg(msg, self);
+
+                    if (recvRes == Herder::TX_STATUS_PENDING)
+                    {
+                        // if it's a new transaction, broadcast it
+                        app.getOverlayManager().broadcastMessage(msg);
+                    }
+                }
+            });
     }
 }
 
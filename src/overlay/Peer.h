@@ -6,11 +6,18 @@
 
 #include "util/asio.h"
 #include "database/Database.h"
+#include "overlay/AuthenticatedFrame.h"
+#include "overlay/OutboundQueue.h"
 #include "overlay/StellarXDR.h"
 #include "util/NonCopyable.h"
 #include "util/Timer.h"
 #include "xdrpp/message.h"
 
+namespace Json
+{
+class Value;
+}
+
 namespace medida
 {
 class Timer;
@@ -163,14 +170,15 @@ class Peer : public std::enable_shared_from_this<Peer>,
     void sendDontHave(MessageType type, uint256 const& itemID);
     void sendPeers();
 
-    // NB: This is a move-argument because the write-buffer has to travel
-    // with the write-request through the async IO system, and we might have
-    // several queued at once. We have carefully arranged this to not copy
-    // data more than the once necessary into this buffer, but it can't be
-    // put in a reused/non-owned buffer without having to buffer/queue
-    // messages somewhere else. The async write request will point _into_
-    // this owned buffer. This is really the best we can do.
-    virtual void sendMessage(xdr::msg_ptr&& xdrBytes) = 0;
+    // Queues a message for sending. Its body may be shared with the messages
+    // of other peers. It is only given its sequence number and MAC, by
+    // authenticate, once it's about to be written, so that implementations
+    // are free to reorder or drop queued messages.
+    virtual void sendMessage(OutboundQueue::Message&& msg) = 0;
+
+    // The frame to write for `msg`, taking the next sequence number if it
+    // needs one. Frames must be written in the order they were made.
+    AuthenticatedFrame authenticate(OutboundQueue::Message const& msg);
     virtual void
     connected()
     {
@@ -200,6 +208,10 @@ class Peer : public std::enable_shared_from_this<Peer>,
     void sendGetScpState(uint32 ledgerSeq);
 
     void sendMessage(StellarMessage const& msg);
+    // Same, with msg already serialized by AuthenticatedFrame::serialize, so
+    // that a message sent to several peers is serialized only once.
+    void sendMessage(StellarMessage const& msg,
+                     AuthenticatedFrame::Body const& body);
 
     PeerRole
     getRole() const
@@ -269,6 +281,14 @@ class Peer : public std::enable_shared_from_this<Peer>,
     void drop(ErrorCode err, std::string const& msg);
     virtual void drop() = 0;
     virtual std::string getIP() = 0;
+
+    // Add statistics about this connection to its entry in the peers
+    // report.
+    virtual void
+    dumpInfo(Json::Value& ret) const
+    {
+    }
+
     virtual ~Peer()
     {
     }
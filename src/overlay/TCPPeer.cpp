@@ -4,6 +4,7 @@
 
 #include "overlay/TCPPeer.h"
 #include "database/Database.h"
+#include "lib/json/json.h"
 #include "main/Application.h"
 #include "main/Config.h"
 #include "medida/meter.h"
@@ -29,7 +30,11 @@ using namespace std;
 
 TCPPeer::TCPPeer(Application& app, Peer::PeerRole role,
                  std::shared_ptr<TCPPeer::SocketType> socket)
-    : Peer(app, role), mSocket(socket)
+    : Peer(app, role)
+    , mSocket(socket)
+    , mOutboundQueue(app.getConfig().PEER_OUTBOUND_QUEUE_BYTES)
+    , mOutboundQueueDrop(app.getMetrics().NewMeter(
+          {"overlay", "outbound-queue", "drop"}, "message"))
 {
 }
 
@@ -120,19 +125,38 @@ TCPPeer::getIP()
     return mIP;
 }
 
+static Json::Value
+histogramInfo(medida::Histogram const& h)
+{
+    Json::Value res;
+    res["count"] = (Json::UInt64)h.count();
+    res["mean"] = h.mean();
+    res["max"] = h.max();
+    return res;
+}
+
+void
+TCPPeer::dumpInfo(Json::Value& ret) const
+{
+    ret["write_queue_depth"] = histogramInfo(mWriteQueueDepth);
+    ret["write_size"] = histogramInfo(mWriteSize);
+}
+
 void
-TCPPeer::sendMessage(xdr::msg_ptr&& xdrBytes)
+TCPPeer::sendMessage(OutboundQueue::Message&& msg)
 {
     if (Logging::logTrace("Overlay"))
         CLOG(TRACE, "Overlay") << "TCPPeer:sendMessage to " << toString();
     assertThreadIsMain();
 
-    // places the buffer to write into the write queue
-    auto buf = std::make_shared<xdr::msg_ptr>(std::move(xdrBytes));
-
+    // places the message to write into the outbound queue
     auto self = static_pointer_cast<TCPPeer>(shared_from_this());
 
-    self->mWriteQueue.emplace(buf);
+    auto dropped = self->mOutboundQueue.push(std::move(msg));
+    if (dropped != 0)
+    {
+        mOutboundQueueDrop.Mark(dropped);
+    }
 
     if (!self->mWriting)
     {
@@ -149,48 +173,63 @@ TCPPeer::messageSender()
 
     auto self = static_pointer_cast<TCPPeer>(shared_from_this());
 
-    // if nothing to do, flush and return
-    if (mWriteQueue.empty())
+    if (mOutboundQueue.empty())
     {
-        mSocket->async_flush([self](asio::error_code const& ec, std::size_t) {
-            self->writeHandler(ec, 0);
+        mWriting = false;
+        return;
+    }
+
+    // authenticate as many queued messages as fit in one write, but at least
+    // one; their frames stay in the write queue, keeping their buffers alive,
+    // until the write completes
+    mWriteQueueDepth.Update(mOutboundQueue.size());
+    std::vector<asio::const_buffer> buffers;
+    std::size_t size = 0;
+    while (!mOutboundQueue.empty())
+    {
+        auto const& msg = mOutboundQueue.front();
+        auto frameSize = AuthenticatedFrame::sizeOf(*msg.mBody);
+        if (!mWriteQueue.empty() && size + frameSize > MAX_COALESCED_WRITE_SIZE)
+        {
+            break;
+        }
+        mWriteQueue.emplace_back(authenticate(msg));
+        mOutboundQueue.pop();
+        auto frameBuffers = mWriteQueue.back().buffers();
+        buffers.insert(buffers.end(), frameBuffers.begin(),
+                       frameBuffers.end());
+        size += frameSize;
+    }
+    mWriteSize.Update(size);
+
+    // Frames are written straight to the socket: going through the buffered
+    // stream would copy them into its small buffer and write them out a
+    // buffer at a time.
+    asio::async_write(
+        mSocket->next_layer(), buffers,
+        [self](asio::error_code const& ec, std::size_t length) {
+            self->writeHandler(ec, length, self->mWriteQueue.size());
+            self->mWriteQueue.clear();
+
+            // continue processing the queue
             if (!ec)
             {
-                if (!self->mWriteQueue.empty())
-                {
-                    self->messageSender();
-                }
-                else
-                {
-                    self->mWriting = false;
-                }
+                self->messageSender();
             }
         });
-        return;
-    }
-
-    // peek the buffer from the queue
-    // do not remove it yet as we need the buffer for the duration of the
-    // write operation
-    auto buf = mWriteQueue.front();
-
-    asio::async_write(*(mSocket.get()),
-                      asio::buffer((*buf)->raw_data(), (*buf)->raw_size()),
-                      [self](asio::error_code const& ec, std::size_t length) {
-                          self->writeHandler(ec, length);
-                          self->mWriteQueue.pop(); // done with front element
-
-                          // continue processing the queue/flush
-                          if (!ec)
-                          {
-                              self->messageSender();
-                          }
-                      });
 }
 
 void
 TCPPeer::writeHandler(asio::error_code const& error,
                       std::size_t bytes_transferred)
+{
+    writeHandler(error, bytes_transferred, bytes_transferred != 0 ? 1 : 0);
+}
+
+void
+TCPPeer::writeHandler(asio::error_code const& error,
+                      std::size_t bytes_transferred,
+                      std::size_t messages_transferred)
 {
     assertThreadIsMain();
     mLastWrite = mApp.getClock().now();
@@ -210,7 +249,7 @@ TCPPeer::writeHandler(asio::error_code const& error,
     else if (bytes_transferred != 0)
     {
         LoadManager::PeerContext loadCtx(mApp, mPeerID);
-        mMessageWrite.Mark();
+        mMessageWrite.Mark(messages_transferred);
         mByteWrite.Mark(bytes_transferred);
     }
 }
@@ -5,8 +5,9 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "overlay/Peer.h"
+#include "medida/histogram.h"
 #include "util/Timer.h"
-#include <queue>
+#include <deque>
 
 namespace medida
 {
@@ -18,6 +19,8 @@ namespace stellar
 
 static auto const MAX_UNAUTH_MESSAGE_SIZE = 0x1000;
 static auto const MAX_MESSAGE_SIZE = 0x1000000;
+// queued messages are written together until they add up to this size
+static auto const MAX_COALESCED_WRITE_SIZE = 0x40000;
 
 // Peer that communicates via a TCP socket.
 class TCPPeer : public Peer
@@ -31,11 +34,19 @@ class TCPPeer : public Peer
     std::vector<uint8_t> mIncomingHeader;
     std::vector<uint8_t> mIncomingBody;
 
-    std::queue<std::shared_ptr<xdr::msg_ptr>> mWriteQueue;
+    OutboundQueue mOutboundQueue;
+    // frames of the write in progress
+    std::deque<AuthenticatedFrame> mWriteQueue;
     bool mWriting{false};
 
+    // Kept per peer, to tell apart the peers we can't keep up with, rather
+    // than in the metrics registry; reported by `dumpInfo`.
+    medida::Histogram mWriteQueueDepth;
+    medida::Histogram mWriteSize;
+    medida::Meter& mOutboundQueueDrop;
+
     void recvMessage();
-    void sendMessage(xdr::msg_ptr&& xdrBytes) override;
+    void sendMessage(OutboundQueue::Message&& msg) override;
 
     void messageSender();
 
@@ -45,6 +56,9 @@ class TCPPeer : public Peer
 
     void writeHandler(asio::error_code const& error,
                       std::size_t bytes_transferred) override;
+    void writeHandler(asio::error_code const& error,
+                      std::size_t bytes_transferred,
+                      std::size_t messages_transferred);
     void readHeaderHandler(asio::error_code const& error,
                            std::size_t bytes_transferred) override;
     void readBodyHandler(asio::error_code const& error,
@@ -67,5 +81,6 @@ class TCPPeer : public Peer
 
     virtual void drop() override;
     virtual std::string getIP() override;
+    virtual void dumpInfo(Json::Value& ret) const override;
 };
 }
@@ -4,6 +4,7 @@
 
 #include "TCPPeer.h"
 #include "lib/catch.hpp"
+#include "lib/json/json.h"
 #include "main/Application.h"
 #include "main/Config.h"
 #include "overlay/OverlayManager.h"
@@ -50,6 +51,12 @@ TEST_CASE("TCPPeer can communicate", "[overlay]")
     REQUIRE(p1);
     REQUIRE(p0->isAuthenticated());
     REQUIRE(p1->isAuthenticated());
+
+    // Each peer reports its own writes: at least the handshake's.
+    Json::Value info;
+    p0->dumpInfo(info);
+    REQUIRE(info["write_size"]["count"].asUInt64() > 0);
+    REQUIRE(info["write_queue_depth"]["max"].asDouble() >= 1);
     s->stopAllNodes();
 }
 }
@@ -1347,9 +1347,8 @@ BallotProtocol::attemptBump()
                 break;
             }
 
-            bool vBlocking = LocalNode::isVBlocking(
-                getLocalNode()->getQuorumSet(), mLatestEnvelopes,
-                [&](SCPStatement const& st) {
+            bool vBlocking = getLocalNode()->isVBlocking(
+                mLatestEnvelopes, [&](SCPStatement const& st) {
                     bool res;
                     auto const& pl = st.pledges;
                     if (pl.type() == SCP_ST_PREPARE)
@@ -1806,9 +1805,10 @@ BallotProtocol::advanceSlot(SCPStatement const& hint)
     // when a single message causes several
     if (!mHeardFromQuorum && mCurrentBallot)
     {
-        if (LocalNode::isQuorum(
-                getLocalNode()->getQuorumSet(), mLatestEnvelopes,
-                std::bind(&Slot::getQuorumSetFromStatement, &mSlot, _1),
+        if (getLocalNode()->isQuorum(
+                mLatestEnvelopes,
+                std::bind(&Slot::getCompiledQuorumSetFromStatement, &mSlot,
+                          _1),
                 [&](SCPStatement const& st) {
                     bool res;
                     if (st.pledges.type() == SCP_ST_PREPARE)
@@ -0,0 +1,180 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "scp/CompiledQuorumSet.h"
+#include <algorithm>
+#include <bitset>
+
+namespace stellar
+{
+
+uint32_t
+NodeIndex::indexOf(NodeID const& nodeID)
+{
+    auto res = mIndexes.emplace(nodeID, static_cast<uint32_t>(mIndexes.size()));
+    return res.first->second;
+}
+
+size_t
+NodeIndex::size() const
+{
+    return mIndexes.size();
+}
+
+void
+NodeIndex::clear()
+{
+    mIndexes.clear();
+}
+
+void
+NodeBitSet::set(uint32_t index)
+{
+    size_t word = index / 64;
+    if (word >= mWords.size())
+    {
+        mWords.resize(word + 1, 0);
+    }
+    mWords[word] |= uint64_t(1) << (index % 64);
+}
+
+void
+NodeBitSet::reset(uint32_t index)
+{
+    size_t word = index / 64;
+    if (word < mWords.size())
+    {
+        mWords[word] &= ~(uint64_t(1) << (index % 64));
+    }
+}
+
+bool
+NodeBitSet::test(uint32_t index) const
+{
+    size_t word = index / 64;
+    return word < mWords.size() &&
+           (mWords[word] & (uint64_t(1) << (index % 64))) != 0;
+}
+
+size_t
+NodeBitSet::countCommon(NodeBitSet const& other) const
+{
+    size_t res = 0;
+    size_t n = std::min(mWords.size(), other.mWords.size());
+    for (size_t i = 0; i < n; ++i)
+    {
+        res += std::bitset<64>(mWords[i] & other.mWords[i]).count();
+    }
+    return res;
+}
+
+CompiledQuorumSet::CompiledQuorumSet(SCPQuorumSet const& qSet,
+                                     NodeIndex& index)
+{
+    compile(qSet, index, mRoot);
+}
+
+void
+CompiledQuorumSet::compile(SCPQuorumSet const& qSet, NodeIndex& index,
+                           Level& level)
+{
+    level.mThreshold = qSet.threshold;
+    for (auto const& validator : qSet.validators)
+    {
+        auto i = index.indexOf(validator);
+        if (level.mValidators.test(i))
+        {
+            level.mRepeated.push_back(i);
+        }
+        else
+        {
+            level.mValidators.set(i);
+        }
+    }
+    level.mInnerSets.resize(qSet.innerSets.size());
+    for (size_t i = 0; i < qSet.innerSets.size(); ++i)
+    {
+        compile(qSet.innerSets[i], index, level.mInnerSets[i]);
+    }
+
+    // Like LocalNode::isVBlockingInternal, there is no v-blocking set for a
+    // threshold of 0, and a level whose threshold can't be met anyway is
+    // blocked by any one of its members.
+    size_t members = qSet.validators.size() + qSet.innerSets.size();
+    if (qSet.threshold == 0)
+    {
+        level.mBlockingThreshold = 0;
+    }
+    else if (members + 1 > qSet.threshold)
+    {
+        level.mBlockingThreshold = members + 1 - qSet.threshold;
+    }
+    else
+    {
+        level.mBlockingThreshold = 1;
+    }
+}
+
+size_t
+CompiledQuorumSet::countValidators(Level const& level, NodeBitSet const& nodes)
+{
+    size_t res = level.mValidators.countCommon(nodes);
+    for (auto i : level.mRepeated)
+    {
+        res += nodes.test(i) ? 1 : 0;
+    }
+    return res;
+}
+
+// A threshold of 0 is never met, as in LocalNode::isQuorumSliceInternal.
+bool
+CompiledQuorumSet::isQuorumSlice(Level const& level, NodeBitSet const& nodes)
+{
+    if (level.mThreshold == 0)
+    {
+        return false;
+    }
+    size_t count = countValidators(level, nodes);
+    for (auto const& inner : level.mInnerSets)
+    {
+        if (count >= level.mThreshold)
+        {
+            break;
+        }
+        count += isQuorumSlice(inner, nodes) ? 1 : 0;
+    }
+    return count >= level.mThreshold;
+}
+
+bool
+CompiledQuorumSet::isVBlocking(Level const& level, NodeBitSet const& nodes)
+{
+    if (level.mBlockingThreshold == 0)
+    {
+        return false;
+    }
+    size_t count = countValidators(level, nodes);
+    for (auto const& inner : level.mInnerSets)
+    {
+        if (count >= level.mBlockingThreshold)
+        {
+            break;
+        }
+        count += isVBlocking(inner, nodes) ? 1 : 0;
+    }
+    return count >= level.mBlockingThreshold;
+}
+
+bool
+CompiledQuorumSet::isQuorumSlice(NodeBitSet const& nodes) const
+{
+    return isQuorumSlice(mRoot, nodes);
+}
+
+bool
+CompiledQuorumSet::isVBlocking(NodeBitSet const& nodes) const
+{
+    return isVBlocking(mRoot, nodes);
+}
+}
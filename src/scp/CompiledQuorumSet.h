@@ -0,0 +1,86 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/SecretKey.h"
+#include "xdr/Stellar-SCP.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * Numbers the nodes that appear in quorum sets, so that sets of nodes can be
+ * represented as bitsets.
+ */
+class NodeIndex
+{
+    std::unordered_map<NodeID, uint32_t> mIndexes;
+
+  public:
+    // index of `nodeID`, numbering it if it's new
+    uint32_t indexOf(NodeID const& nodeID);
+
+    size_t size() const;
+    void clear();
+};
+
+/**
+ * A set of nodes, by their index in a NodeIndex.
+ */
+class NodeBitSet
+{
+    std::vector<uint64_t> mWords;
+
+  public:
+    void set(uint32_t index);
+    void reset(uint32_t index);
+    bool test(uint32_t index) const;
+
+    // number of nodes in both sets
+    size_t countCommon(NodeBitSet const& other) const;
+};
+
+/**
+ * A quorum set translated to node indexes once, so that checking it against
+ * sets of nodes is a matter of a few bitset operations per level instead of
+ * searching the set for every validator.
+ *
+ * Behaves exactly as LocalNode::isQuorumSlice and LocalNode::isVBlocking on
+ * the quorum set it was built from, including for repeated validators.
+ */
+class CompiledQuorumSet
+{
+    struct Level
+    {
+        uint32_t mThreshold;
+        // members needed to block this level, 0 if it can't be blocked
+        size_t mBlockingThreshold;
+        NodeBitSet mValidators;
+        // validators listed more than once, for each extra occurrence
+        std::vector<uint32_t> mRepeated;
+        std::vector<Level> mInnerSets;
+    };
+
+    Level mRoot;
+
+    static void compile(SCPQuorumSet const& qSet, NodeIndex& index,
+                        Level& level);
+    static size_t countValidators(Level const& level, NodeBitSet const& nodes);
+    static bool isQuorumSlice(Level const& level, NodeBitSet const& nodes);
+    static bool isVBlocking(Level const& level, NodeBitSet const& nodes);
+
+  public:
+    CompiledQuorumSet(SCPQuorumSet const& qSet, NodeIndex& index);
+
+    bool isQuorumSlice(NodeBitSet const& nodes) const;
+    bool isVBlocking(NodeBitSet const& nodes) const;
+};
+
+typedef std::shared_ptr<CompiledQuorumSet const> CompiledQuorumSetPtr;
+}
@@ -0,0 +1,206 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/SHA.h"
+#include "crypto/SecretKey.h"
+#include "lib/catch.hpp"
+#include "scp/CompiledQuorumSet.h"
+#include "scp/LocalNode.h"
+#include "util/Logging.h"
+#include "util/Math.h"
+
+namespace stellar
+{
+
+namespace
+{
+
+PublicKey
+makePublicKey(int i)
+{
+    auto hash = sha256("NODE_SEED_" + std::to_string(i));
+    return SecretKey::fromSeed(hash).getPublicKey();
+}
+
+// Random, not necessarily sane, quorum set over `keys`: validators may be
+// repeated and thresholds may be 0 or too high.
+SCPQuorumSet
+randomQSet(std::vector<PublicKey> const& keys, int depth)
+{
+    SCPQuorumSet qSet;
+    auto nValidators = rand_uniform<size_t>(0, 5);
+    for (size_t i = 0; i < nValidators; ++i)
+    {
+        qSet.validators.emplace_back(rand_element(keys));
+    }
+    auto nInner = depth > 0 ? rand_uniform<size_t>(0, 3) : 0;
+    for (size_t i = 0; i < nInner; ++i)
+    {
+        qSet.innerSets.emplace_back(randomQSet(keys, depth - 1));
+    }
+    qSet.threshold = rand_uniform<uint32>(0, nValidators + nInner + 1);
+    return qSet;
+}
+
+std::map<NodeID, SCPEnvelope>
+makeEnvelopes(std::vector<PublicKey> const& nodes)
+{
+    std::map<NodeID, SCPEnvelope> res;
+    for (auto const& n : nodes)
+    {
+        res[n].statement.nodeID = n;
+    }
+    return res;
+}
+}
+
+TEST_CASE("compiled quorum set evaluation", "[scp][quorumset]")
+{
+    std::vector<PublicKey> keys;
+    for (int i = 0; i < 12; i++)
+    {
+        keys.push_back(makePublicKey(i));
+    }
+
+    SECTION("slices and v-blocking sets")
+    {
+        NodeIndex index;
+        for (int i = 0; i < 2000; i++)
+        {
+            auto qSet = randomQSet(keys, 2);
+            CompiledQuorumSet compiled(qSet, index);
+
+            std::vector<NodeID> nodeSet;
+            NodeBitSet nodes;
+            for (auto const& k : keys)
+            {
+                if (rand_flip())
+                {
+                    nodeSet.emplace_back(k);
+                    nodes.set(index.indexOf(k));
+                }
+            }
+            REQUIRE(compiled.isQuorumSlice(nodes) ==
+                    LocalNode::isQuorumSlice(qSet, nodeSet));
+            REQUIRE(compiled.isVBlocking(nodes) ==
+                    LocalNode::isVBlocking(qSet, nodeSet));
+        }
+    }
+
+    SECTION("quorums")
+    {
+        for (int i = 0; i < 500; i++)
+        {
+            LocalNode node(SecretKey::random(), true, randomQSet(keys, 1),
+                           nullptr);
+            auto envs = makeEnvelopes(keys);
+
+            // Some nodes have no known quorum set.
+            std::map<NodeID, SCPQuorumSetPtr> qSets;
+            std::map<NodeID, CompiledQuorumSetPtr> compiledQSets;
+            for (auto const& k : keys)
+            {
+                if (rand_uniform(0, 9) != 0)
+                {
+                    qSets[k] = std::make_shared<SCPQuorumSet>(
+                        randomQSet(keys, 1));
+                    compiledQSets[k] = node.compileQuorumSet(*qSets[k]);
+                }
+            }
+            std::set<NodeID> filtered;
+            for (auto const& k : keys)
+            {
+                if (rand_uniform(0, 4) != 0)
+                {
+                    filtered.insert(k);
+                }
+            }
+            auto filter = [&](SCPStatement const& st) {
+                return filtered.count(st.nodeID) != 0;
+            };
+
+            auto expected = LocalNode::isQuorum(
+                node.getQuorumSet(), envs,
+                [&](SCPStatement const& st) { return qSets[st.nodeID]; },
+                filter);
+            auto actual = node.isQuorum(envs,
+                                        [&](SCPStatement const& st) {
+                                            return compiledQSets[st.nodeID];
+                                        },
+                                        filter);
+            REQUIRE(actual == expected);
+            REQUIRE(node.isVBlocking(envs, filter) ==
+                    LocalNode::isVBlocking(node.getQuorumSet(), envs,
+                                           filter));
+        }
+    }
+}
+
+// 150 validators in 30 organizations of 5, every validator requiring 2/3 of
+// the organizations, each organization requiring 3 of its validators.
+TEST_CASE("quorum evaluation benchmark", "[scp][bench][hide]")
+{
+    size_t const nOrgs = 30;
+    size_t const orgSize = 5;
+    size_t const rounds = 1000;
+
+    std::vector<PublicKey> keys;
+    SCPQuorumSet qSet;
+    qSet.threshold = nOrgs * 2 / 3 + 1;
+    for (size_t i = 0; i < nOrgs; i++)
+    {
+        SCPQuorumSet org;
+        org.threshold = 3;
+        for (size_t j = 0; j < orgSize; j++)
+        {
+            keys.push_back(makePublicKey(static_cast<int>(i * orgSize + j)));
+            org.validators.emplace_back(keys.back());
+        }
+        qSet.innerSets.emplace_back(org);
+    }
+
+    LocalNode node(SecretKey::random(), true, qSet, nullptr);
+    auto envs = makeEnvelopes(keys);
+    // Each validator sends its own copy of the quorum set.
+    std::map<NodeID, SCPQuorumSetPtr> qSets;
+    std::map<NodeID, CompiledQuorumSetPtr> compiledQSets;
+    for (auto const& k : keys)
+    {
+        qSets[k] = std::make_shared<SCPQuorumSet>(qSet);
+        compiledQSets[k] = node.compileQuorumSet(qSet);
+    }
+    // Leave out 9 organizations, so that the quorum barely holds.
+    std::set<NodeID> filtered(keys.begin(), keys.end() - orgSize * 9);
+    auto filter = [&](SCPStatement const& st) {
+        return filtered.count(st.nodeID) != 0;
+    };
+
+    LOG(INFO) << "Benchmarking " << rounds << " quorum checks over "
+              << keys.size() << " nodes";
+    bool expected;
+    {
+        TIMED_SCOPE(timerBlkObj, "quorum sets");
+        for (size_t i = 0; i < rounds; i++)
+        {
+            expected = LocalNode::isQuorum(
+                node.getQuorumSet(), envs,
+                [&](SCPStatement const& st) { return qSets[st.nodeID]; },
+                filter);
+        }
+    }
+    bool actual;
+    {
+        TIMED_SCOPE(timerBlkObj, "compiled quorum sets");
+        for (size_t i = 0; i < rounds; i++)
+        {
+            actual = node.isQuorum(envs,
+                                   [&](SCPStatement const& st) {
+                                       return compiledQSets[st.nodeID];
+                                   },
+                                   filter);
+        }
+    }
+    REQUIRE(actual == expected);
+}
+}
@@ -20,6 +20,9 @@ namespace stellar
 using xdr::operator==;
 using xdr::operator<;
 
+const size_t LocalNode::COMPILED_QSET_CACHE_SIZE = 10000;
+const size_t LocalNode::MAX_INDEXED_NODES = 100000;
+
 LocalNode::LocalNode(SecretKey const& secretKey, bool isValidator,
                      SCPQuorumSet const& qSet, SCP* scp)
     : mNodeID(secretKey.getPublicKey())
@@ -27,9 +30,12 @@ LocalNode::LocalNode(SecretKey const& secretKey, bool isValidator,
     , mIsValidator(isValidator)
     , mQSet(qSet)
     , mSCP(scp)
+    , mCompiledQSets(COMPILED_QSET_CACHE_SIZE)
+    , mCompiledSingletonQSets(COMPILED_QSET_CACHE_SIZE)
 {
     normalizeQSet(mQSet);
     mQSetHash = sha256(xdr::xdr_to_opaque(mQSet));
+    mCompiledQSet = compileQuorumSet(mQSet);
 
     CLOG(INFO, "SCP") << "LocalNode::LocalNode"
                       << "@" << KeyUtils::toShortString(mNodeID)
@@ -53,6 +59,7 @@ LocalNode::updateQuorumSet(SCPQuorumSet const& qSet)
 {
     mQSetHash = sha256(xdr::xdr_to_opaque(qSet));
     mQSet = qSet;
+    mCompiledQSet = compileQuorumSet(mQSet);
 }
 
 SCPQuorumSet const&
@@ -78,6 +85,53 @@ LocalNode::getSingletonQSet(NodeID const& nodeID)
 {
     return std::make_shared<SCPQuorumSet>(buildSingletonQSet(nodeID));
 }
+
+CompiledQuorumSetPtr
+LocalNode::getCompiledQuorumSet(Hash const& qSetHash)
+{
+    if (mCompiledQSets.exists(qSetHash))
+    {
+        return mCompiledQSets.get(qSetHash);
+    }
+    auto qSet = mSCP->getDriver().getQSet(qSetHash);
+    if (!qSet)
+    {
+        return nullptr;
+    }
+    auto res = compileQuorumSet(*qSet);
+    mCompiledQSets.put(qSetHash, res);
+    return res;
+}
+
+CompiledQuorumSetPtr
+LocalNode::getCompiledSingletonQSet(NodeID const& nodeID)
+{
+    if (mCompiledSingletonQSets.exists(nodeID))
+    {
+        return mCompiledSingletonQSets.get(nodeID);
+    }
+    auto res = compileQuorumSet(buildSingletonQSet(nodeID));
+    mCompiledSingletonQSets.put(nodeID, res);
+    return res;
+}
+
+CompiledQuorumSetPtr
+LocalNode::compileQuorumSet(SCPQuorumSet const& qSet)
+{
+    return std::make_shared<CompiledQuorumSet>(qSet, mNodeIndex);
+}
+
+void
+LocalNode::maybeResetNodeIndex()
+{
+    if (mNodeIndex.size() > MAX_INDEXED_NODES)
+    {
+        mNodeIndex.clear();
+        mCompiledQSets.clear();
+        mCompiledSingletonQSets.clear();
+        mCompiledQSet = compileQuorumSet(mQSet);
+    }
+}
 void
 LocalNode::forAllNodesInternal(SCPQuorumSet const& qset,
                                std::function<void(NodeID const&)> proc)
@@ -289,6 +343,65 @@ LocalNode::isQuorum(
     return isQuorumSlice(qSet, pNodes);
 }
 
+bool
+LocalNode::isVBlocking(std::map<NodeID, SCPEnvelope> const& map,
+                       std::function<bool(SCPStatement const&)> const& filter)
+{
+    maybeResetNodeIndex();
+    NodeBitSet nodes;
+    for (auto const& it : map)
+    {
+        if (filter(it.second.statement))
+        {
+            nodes.set(mNodeIndex.indexOf(it.first));
+        }
+    }
+    return mCompiledQSet->isVBlocking(nodes);
+}
+
+bool
+LocalNode::isQuorum(
+    std::map<NodeID, SCPEnvelope> const& map,
+    std::function<CompiledQuorumSetPtr(SCPStatement const&)> const& qfun,
+    std::function<bool(SCPStatement const&)> const& filter)
+{
+    maybeResetNodeIndex();
+
+    // Nodes without a quorum set can't be part of the quorum; leaving them
+    // out from the start reaches the same fixpoint as the static version.
+    std::vector<std::pair<uint32_t, CompiledQuorumSetPtr>> candidates;
+    NodeBitSet nodes;
+    for (auto const& it : map)
+    {
+        if (filter(it.second.statement))
+        {
+            auto qSet = qfun(it.second.statement);
+            if (qSet)
+            {
+                auto i = mNodeIndex.indexOf(it.first);
+                candidates.emplace_back(i, qSet);
+                nodes.set(i);
+            }
+        }
+    }
+
+    bool changed;
+    do
+    {
+        changed = false;
+        for (auto const& c : candidates)
+        {
+            if (nodes.test(c.first) && !c.second->isQuorumSlice(nodes))
+            {
+                nodes.reset(c.first);
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    return mCompiledQSet->isQuorumSlice(nodes);
+}
+
 std::vector<NodeID>
 LocalNode::findClosestVBlocking(
     SCPQuorumSet const& qset, std::map<NodeID, SCPEnvelope> const& map,
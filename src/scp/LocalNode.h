@@ -8,6 +8,8 @@
 #include <set>
 #include <vector>
 
+#include "lib/util/lrucache.hpp"
+#include "scp/CompiledQuorumSet.h"
 #include "scp/SCP.h"
 #include "util/HashOfHash.h"
 
@@ -31,6 +33,19 @@ class LocalNode
 
     SCP* mSCP;
 
+    static const size_t COMPILED_QSET_CACHE_SIZE;
+    // past this many nodes, the node index is rebuilt to forget stale nodes
+    static const size_t MAX_INDEXED_NODES;
+
+    // nodes of the compiled quorum sets, the quorum sets by hash and the
+    // singleton quorum sets {{X}} by node
+    NodeIndex mNodeIndex;
+    CompiledQuorumSetPtr mCompiledQSet;
+    cache::lru_cache<Hash, CompiledQuorumSetPtr> mCompiledQSets;
+    cache::lru_cache<NodeID, CompiledQuorumSetPtr> mCompiledSingletonQSets;
+
+    void maybeResetNodeIndex();
+
   public:
     LocalNode(SecretKey const& secretKey, bool isValidator,
               SCPQuorumSet const& qSet, SCP* scp);
@@ -52,6 +67,24 @@ class LocalNode
     // returns the quorum set {{X}}
     static SCPQuorumSetPtr getSingletonQSet(NodeID const& nodeID);
 
+    // returns the quorum set with the given hash, as provided by the driver,
+    // compiled once for the checks below; nullptr if the driver lacks it
+    CompiledQuorumSetPtr getCompiledQuorumSet(Hash const& qSetHash);
+    // returns the quorum set {{X}}, compiled once
+    CompiledQuorumSetPtr getCompiledSingletonQSet(NodeID const& nodeID);
+    // compiles qSet for this node, without caching it
+    CompiledQuorumSetPtr compileQuorumSet(SCPQuorumSet const& qSet);
+
+    // Same as the static isVBlocking and isQuorum below, for this node's
+    // quorum set, evaluated on compiled quorum sets; `qfun` returns the
+    // compiled quorum set of the node of a statement.
+    bool isVBlocking(std::map<NodeID, SCPEnvelope> const& map,
+                     std::function<bool(SCPStatement const&)> const& filter);
+    bool isQuorum(
+        std::map<NodeID, SCPEnvelope> const& map,
+        std::function<CompiledQuorumSetPtr(SCPStatement const&)> const& qfun,
+        std::function<bool(SCPStatement const&)> const& filter);
+
     // runs proc over all nodes contained in qset
     static void forAllNodes(SCPQuorumSet const& qset,
                             std::function<void(NodeID const&)> proc);
@@ -292,6 +292,17 @@ Slot::getQuorumSetFromStatement(SCPStatement const& st)
     return res;
 }
 
+CompiledQuorumSetPtr
+Slot::getCompiledQuorumSetFromStatement(SCPStatement const& st)
+{
+    if (st.pledges.type() == SCP_ST_EXTERNALIZE)
+    {
+        return getLocalNode()->getCompiledSingletonQSet(st.nodeID);
+    }
+    return getLocalNode()->getCompiledQuorumSet(
+        getCompanionQuorumSetHashFromStatement(st));
+}
+
 void
 Slot::dumpInfo(Json::Value& ret)
 {
@@ -342,7 +353,7 @@ Slot::federatedAccept(StatementPredicate voted, StatementPredicate accepted,
 {
     // Checks if the nodes that claimed to accept the statement form a
     // v-blocking set
-    if (LocalNode::isVBlocking(getLocalNode()->getQuorumSet(), envs, accepted))
+    if (getLocalNode()->isVBlocking(envs, accepted))
     {
         return true;
     }
@@ -355,9 +366,8 @@ Slot::federatedAccept(StatementPredicate voted, StatementPredicate accepted,
         return res;
     };
 
-    if (LocalNode::isQuorum(
-            getLocalNode()->getQuorumSet(), envs,
-            std::bind(&Slot::getQuorumSetFromStatement, this, _1),
+    if (getLocalNode()->isQuorum(
+            envs, std::bind(&Slot::getCompiledQuorumSetFromStatement, this, _1),
             ratifyFilter))
     {
         return true;
@@ -370,9 +380,9 @@ bool
 Slot::federatedRatify(StatementPredicate voted,
                       std::map<NodeID, SCPEnvelope> const& envs)
 {
-    return LocalNode::isQuorum(
-        getLocalNode()->getQuorumSet(), envs,
-        std::bind(&Slot::getQuorumSetFromStatement, this, _1), voted);
+    return getLocalNode()->isQuorum(
+        envs, std::bind(&Slot::getCompiledQuorumSetFromStatement, this, _1),
+        voted);
 }
 
 std::shared_ptr<LocalNode>
@@ -144,6 +144,9 @@ class Slot : public std::enable_shared_from_this<Slot>
     // returns the QuorumSet that should be used for a node given the
     // statement (singleton for externalize)
     SCPQuorumSetPtr getQuorumSetFromStatement(SCPStatement const& st);
+    // same, compiled by the local node
+    CompiledQuorumSetPtr
+    getCompiledQuorumSetFromStatement(SCPStatement const& st);
 
     // wraps a statement in an envelope (sign it, etc)
     SCPEnvelope createEnvelope(SCPStatement const& statement);
@@ -6,6 +6,7 @@
 #include "database/Database.h"
 #include "ledger/LedgerDelta.h"
 #include "ledger/LedgerManager.h"
+#include "ledger/OrderBook.h"
 #include "ledger/TrustFrame.h"
 #include "util/Logging.h"
 
@@ -261,80 +262,78 @@ OfferExchange::convertWithOffers(
     wheatReceived = 0;
 
     Database& db = mLedgerManager.getDatabase();
+    auto& orderBook = db.getOrderBook();
 
-    size_t offerOffset = 0;
+    // Crossing offers changes the book, so rather than holding an iterator,
+    // look for the next offer after the last one visited each time.
+    OrderBook::Position lastPosition;
+    bool first = true;
 
     bool needMore = (maxWheatReceive > 0 && maxSheepSend > 0);
 
     while (needMore)
     {
-        std::vector<OfferFrame::pointer> retList;
-        OfferFrame::loadBestOffers(5, offerOffset, wheat, sheep, retList, db);
-
-        offerOffset += retList.size();
-
-        for (auto& wheatOffer : retList)
+        auto const& book = orderBook.getBook(wheat, sheep, db);
+        auto it = first ? book.begin() : book.upper_bound(lastPosition);
+        if (it == book.end())
         {
-            if (filter)
+            if (orderBook.loadMore(wheat, sheep, db))
             {
-                OfferFilterResult r = filter(*wheatOffer);
-                switch (r)
-                {
-                case eKeep:
-                    break;
-                case eStop:
-                    return eFilterStop;
-                case eSkip:
-                    continue;
-                }
+                continue;
             }
+            // still stuff to fill but no more offers
+            break;
+        }
+        first = false;
+        lastPosition = it->first;
 
-            int64_t numWheatReceived;
-            int64_t numSheepSend;
-
-            CrossOfferResult cor =
-                crossOffer(*wheatOffer, maxWheatReceive, numWheatReceived,
-                           maxSheepSend, numSheepSend);
-
-            assert(numSheepSend >= 0);
-            assert(numSheepSend <= maxSheepSend);
-            assert(numWheatReceived >= 0);
-            assert(numWheatReceived <= maxWheatReceive);
-
-            switch (cor)
+        OfferFrame wheatOffer(*it->second);
+        if (filter)
+        {
+            OfferFilterResult r = filter(wheatOffer);
+            switch (r)
             {
-            case eOfferTaken:
-                assert(offerOffset > 0);
-                offerOffset--; // adjust offset as an offer was deleted
-                break;
-            case eOfferPartial:
+            case eKeep:
                 break;
-            case eOfferCantConvert:
-                return ePartial;
+            case eStop:
+                return eFilterStop;
+            case eSkip:
+                continue;
             }
+        }
 
-            sheepSend += numSheepSend;
-            maxSheepSend -= numSheepSend;
+        int64_t numWheatReceived;
+        int64_t numSheepSend;
 
-            wheatReceived += numWheatReceived;
-            maxWheatReceive -= numWheatReceived;
+        CrossOfferResult cor =
+            crossOffer(wheatOffer, maxWheatReceive, numWheatReceived,
+                       maxSheepSend, numSheepSend);
 
-            needMore = (maxWheatReceive > 0 && maxSheepSend > 0);
-            if (!needMore)
-            {
-                return eOK;
-            }
-            else if (cor == eOfferPartial)
-            {
-                return ePartial;
-            }
+        assert(numSheepSend >= 0);
+        assert(numSheepSend <= maxSheepSend);
+        assert(numWheatReceived >= 0);
+        assert(numWheatReceived <= maxWheatReceive);
+
+        if (cor == eOfferCantConvert)
+        {
+            return ePartial;
         }
 
-        // still stuff to fill but no more offers
-        if (needMore && retList.size() < 5)
+        sheepSend += numSheepSend;
+        maxSheepSend -= numSheepSend;
+
+        wheatReceived += numWheatReceived;
+        maxWheatReceive -= numWheatReceived;
+
+        needMore = (maxWheatReceive > 0 && maxSheepSend > 0);
+        if (!needMore)
         {
             return eOK;
         }
+        else if (cor == eOfferPartial)
+        {
+            return ePartial;
+        }
     }
     return eOK;
 }
@@ -49,6 +49,38 @@ getNeededThreshold(AccountFrame const& account, ThresholdLevel const level)
         abort();
     }
 }
+
+void
+insertAccount(AccountID const& accountID, std::unordered_set<LedgerKey>& keys)
+{
+    LedgerKey key;
+    key.type(ACCOUNT);
+    key.account().accountID = accountID;
+    keys.insert(key);
+}
+
+// Issuers have no trust line of their own asset, but theirs is loaded along
+// with any other.
+void
+insertTrustLine(AccountID const& accountID, Asset const& asset,
+                std::unordered_set<LedgerKey>& keys)
+{
+    if (asset.type() == ASSET_TYPE_NATIVE)
+    {
+        return;
+    }
+    auto issuer = getIssuer(asset);
+    insertAccount(issuer, keys);
+    if (accountID == issuer)
+    {
+        return;
+    }
+    LedgerKey key;
+    key.type(TRUSTLINE);
+    key.trustLine().accountID = accountID;
+    key.trustLine().asset = asset;
+    keys.insert(key);
+}
 }
 
 shared_ptr<OperationFrame>
@@ -87,6 +119,72 @@ OperationFrame::makeHelper(Operation const& op, OperationResult& res,
     }
 }
 
+void
+OperationFrame::insertLedgerKeysToPrefetch(Operation const& op,
+                                           AccountID const& sourceID,
+                                           std::unordered_set<LedgerKey>& keys)
+{
+    insertAccount(sourceID, keys);
+    switch (op.body.type())
+    {
+    case CREATE_ACCOUNT:
+        insertAccount(op.body.createAccountOp().destination, keys);
+        break;
+    case PAYMENT:
+    {
+        auto const& payment = op.body.paymentOp();
+        insertAccount(payment.destination, keys);
+        insertTrustLine(sourceID, payment.asset, keys);
+        insertTrustLine(payment.destination, payment.asset, keys);
+        break;
+    }
+    case PATH_PAYMENT:
+    {
+        auto const& payment = op.body.pathPaymentOp();
+        insertAccount(payment.destination, keys);
+        insertTrustLine(sourceID, payment.sendAsset, keys);
+        insertTrustLine(payment.destination, payment.destAsset, keys);
+        break;
+    }
+    case MANAGE_OFFER:
+        insertTrustLine(sourceID, op.body.manageOfferOp().selling, keys);
+        insertTrustLine(sourceID, op.body.manageOfferOp().buying, keys);
+        break;
+    case CREATE_PASSIVE_OFFER:
+        insertTrustLine(sourceID, op.body.createPassiveOfferOp().selling,
+                        keys);
+        insertTrustLine(sourceID, op.body.createPassiveOfferOp().buying,
+                        keys);
+        break;
+    case CHANGE_TRUST:
+        insertTrustLine(sourceID, op.body.changeTrustOp().line, keys);
+        break;
+    case ALLOW_TRUST:
+    {
+        auto const& allowTrust = op.body.allowTrustOp();
+        Asset asset;
+        asset.type(allowTrust.asset.type());
+        if (asset.type() == ASSET_TYPE_CREDIT_ALPHANUM4)
+        {
+            asset.alphaNum4().assetCode = allowTrust.asset.assetCode4();
+            asset.alphaNum4().issuer = sourceID;
+        }
+        else if (asset.type() == ASSET_TYPE_CREDIT_ALPHANUM12)
+        {
+            asset.alphaNum12().assetCode = allowTrust.asset.assetCode12();
+            asset.alphaNum12().issuer = sourceID;
+        }
+        insertTrustLine(allowTrust.trustor, asset, keys);
+        break;
+    }
+    case ACCOUNT_MERGE:
+        insertAccount(op.body.destination(), keys);
+        break;
+    default:
+        break;
+    }
+}
+
 OperationFrame::OperationFrame(Operation const& op, OperationResult& res,
                                TransactionFrame& parentTx)
     : mOperation(op), mParentTx(parentTx), mResult(res)
@@ -5,10 +5,12 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "ledger/AccountFrame.h"
+#include "ledger/LedgerHashUtils.h"
 #include "ledger/LedgerManager.h"
 #include "overlay/StellarXDR.h"
 #include "util/types.h"
 #include <memory>
+#include <unordered_set>
 
 namespace medida
 {
@@ -55,6 +57,12 @@ class OperationFrame
                    TransactionFrame& parentTx);
     OperationFrame(OperationFrame const&) = delete;
 
+    // Add the keys of the accounts and trust lines applying `op` will load,
+    // `sourceID` being the source account of the operation.
+    static void
+    insertLedgerKeysToPrefetch(Operation const& op, AccountID const& sourceID,
+                               std::unordered_set<LedgerKey>& keys);
+
     AccountFrame&
     getSourceAccount() const
     {
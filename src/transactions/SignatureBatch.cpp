@@ -0,0 +1,97 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "transactions/SignatureBatch.h"
+#include "crypto/SecretKey.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace stellar
+{
+
+namespace
+{
+
+// Signatures to verify, shared by the threads verifying them. Each thread
+// claims the next one until none are left, so that the caller never waits on
+// tasks still queued behind busy workers: it verifies what they don't.
+//
+// Tasks that only start once all are claimed never touch mItems, which may be
+// gone by then.
+struct VerifyState
+{
+    std::vector<SignatureBatch::Item> const& mItems;
+    size_t const mSize;
+    std::atomic<size_t> mNext{0};
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    size_t mDone{0};
+
+    explicit VerifyState(std::vector<SignatureBatch::Item> const& items)
+        : mItems(items), mSize(items.size())
+    {
+    }
+
+    void
+    run()
+    {
+        size_t done = 0;
+        size_t i;
+        while ((i = mNext++) < mSize)
+        {
+            auto const& item = mItems[i];
+            PubKeyUtils::verifySig(item.mKey, item.mSignature, item.mHash);
+            ++done;
+        }
+        if (done != 0)
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mDone += done;
+            if (mDone == mSize)
+            {
+                mCond.notify_all();
+            }
+        }
+    }
+};
+}
+
+void
+SignatureBatch::add(PublicKey const& key, Signature const& signature,
+                    Hash const& hash)
+{
+    mItems.emplace_back(Item{key, signature, hash});
+}
+
+size_t
+SignatureBatch::size() const
+{
+    return mItems.size();
+}
+
+void
+SignatureBatch::verify(asio::io_service& workers, size_t nWorkers) const
+{
+    if (mItems.empty())
+    {
+        return;
+    }
+
+    auto state = std::make_shared<VerifyState>(mItems);
+
+    nWorkers = std::min(nWorkers, mItems.size() - 1);
+    for (size_t i = 0; i < nWorkers; ++i)
+    {
+        workers.post([state]() { state->run(); });
+    }
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mMutex);
+    state->mCond.wait(lock, [&]() { return state->mDone == state->mSize; });
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/asio.h"
+#include "xdr/Stellar-types.h"
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * Signatures to verify ahead of the transactions they belong to, in parallel.
+ *
+ * Checking a transaction verifies its signatures one after another, on the
+ * main thread. Verifying them all beforehand, spread over the worker threads,
+ * leaves the results in the process-wide verification cache, so that checking
+ * the transactions afterwards only looks them up.
+ */
+class SignatureBatch
+{
+  public:
+    struct Item
+    {
+        PublicKey mKey;
+        Signature mSignature;
+        Hash mHash;
+    };
+
+  private:
+    std::vector<Item> mItems;
+
+  public:
+    // Adds `signature` of `hash` by `key`.
+    void add(PublicKey const& key, Signature const& signature,
+             Hash const& hash);
+
+    size_t size() const;
+
+    // Verifies the signatures of the batch, on the calling thread and on up
+    // to `nWorkers` tasks posted to `workers`, returning once all are done.
+    void verify(asio::io_service& workers, size_t nWorkers) const;
+};
+}
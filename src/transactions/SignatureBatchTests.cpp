@@ -0,0 +1,63 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/asio.h"
+#include "crypto/SHA.h"
+#include "crypto/SecretKey.h"
+#include "lib/catch.hpp"
+#include "transactions/SignatureBatch.h"
+#include <thread>
+
+using namespace stellar;
+
+TEST_CASE("signature batch fills the verify cache", "[signature][batch]")
+{
+    asio::io_service workers;
+    auto work = std::make_shared<asio::io_service::work>(workers);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; i++)
+    {
+        threads.emplace_back([&]() { workers.run(); });
+    }
+
+    std::vector<PublicKey> keys;
+    std::vector<Signature> sigs;
+    std::vector<Hash> hashes;
+    SignatureBatch batch;
+    for (int i = 0; i < 200; i++)
+    {
+        auto sk = SecretKey::random();
+        hashes.emplace_back(sha256("message " + std::to_string(i)));
+        sigs.emplace_back(sk.sign(hashes.back()));
+        // every third signature is by another key
+        keys.emplace_back(i % 3 == 0 ? PubKeyUtils::random()
+                                     : sk.getPublicKey());
+        batch.add(keys.back(), sigs.back(), hashes.back());
+    }
+    REQUIRE(batch.size() == 200);
+
+    uint64_t hits0, misses0, hits1, misses1, hits2, misses2;
+    PubKeyUtils::clearVerifySigCache();
+    PubKeyUtils::getVerifySigCacheCounts(hits0, misses0);
+
+    batch.verify(workers, threads.size());
+    PubKeyUtils::getVerifySigCacheCounts(hits1, misses1);
+    REQUIRE(hits1 - hits0 == 0);
+    REQUIRE(misses1 - misses0 == 200);
+
+    for (int i = 0; i < 200; i++)
+    {
+        REQUIRE(PubKeyUtils::verifySig(keys[i], sigs[i], hashes[i]) ==
+                (i % 3 != 0));
+    }
+    PubKeyUtils::getVerifySigCacheCounts(hits2, misses2);
+    REQUIRE(hits2 - hits1 == 200);
+    REQUIRE(misses2 - misses1 == 0);
+
+    work.reset();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
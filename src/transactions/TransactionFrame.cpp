@@ -6,12 +6,14 @@
 #include "TransactionFrame.h"
 #include "OperationFrame.h"
 #include "crypto/Hex.h"
+#include "crypto/KeyUtils.h"
 #include "crypto/SHA.h"
 #include "crypto/SignerKey.h"
 #include "database/Database.h"
 #include "herder/TxSetFrame.h"
 #include "ledger/LedgerDelta.h"
 #include "main/Application.h"
+#include "transactions/SignatureBatch.h"
 #include "transactions/SignatureChecker.h"
 #include "transactions/SignatureUtils.h"
 #include "util/Algoritm.h"
@@ -31,6 +33,7 @@ namespace stellar
 {
 
 using namespace std;
+using xdr::operator<;
 using xdr::operator==;
 
 TransactionFramePtr
@@ -103,6 +106,94 @@ TransactionFrame::getFeeRatio(LedgerManager const& lm) const
     return ((double)getFee() / (double)getMinFee(lm));
 }
 
+void
+TransactionFrame::insertLedgerKeysToPrefetch(
+    std::unordered_set<LedgerKey>& keys) const
+{
+    for (auto const& op : mEnvelope.tx.operations)
+    {
+        OperationFrame::insertLedgerKeysToPrefetch(
+            op, op.sourceAccount ? *op.sourceAccount : getSourceID(), keys);
+    }
+    // The transaction's source account is loaded even without operations.
+    LedgerKey key;
+    key.type(ACCOUNT);
+    key.account().accountID = getSourceID();
+    keys.insert(key);
+}
+
+void
+TransactionFrame::insertSignaturesToVerify(SignatureBatch& batch,
+                                           Database& db) const
+{
+    std::set<AccountID> accounts;
+    accounts.insert(getSourceID());
+    for (auto const& op : mEnvelope.tx.operations)
+    {
+        if (op.sourceAccount)
+        {
+            accounts.insert(*op.sourceAccount);
+        }
+    }
+
+    // the master keys and ed25519 signers of the accounts whose signatures
+    // will be checked
+    std::set<PublicKey> keys;
+    for (auto const& id : accounts)
+    {
+        auto account = AccountFrame::loadAccount(id, db);
+        if (!account)
+        {
+            continue;
+        }
+        keys.insert(id);
+        for (auto const& signer : account->getAccount().signers)
+        {
+            if (signer.key.type() == SIGNER_KEY_TYPE_ED25519)
+            {
+                keys.insert(KeyUtils::convertKey<PublicKey>(signer.key));
+            }
+        }
+    }
+
+    // SignatureChecker only verifies signatures whose hint matches the key
+    for (auto const& sig : mEnvelope.signatures)
+    {
+        for (auto const& key : keys)
+        {
+            if (SignatureUtils::doesHintMatch(key.ed25519(), sig.hint))
+            {
+                batch.add(key, sig.signature, getContentsHash());
+            }
+        }
+    }
+}
+
+void
+TransactionFrame::verifySourceKeySignatures() const
+{
+    std::set<AccountID> accounts;
+    accounts.insert(getSourceID());
+    for (auto const& op : mEnvelope.tx.operations)
+    {
+        if (op.sourceAccount)
+        {
+            accounts.insert(*op.sourceAccount);
+        }
+    }
+
+    for (auto const& sig : mEnvelope.signatures)
+    {
+        for (auto const& id : accounts)
+        {
+            if (SignatureUtils::doesHintMatch(id.ed25519(), sig.hint))
+            {
+                PubKeyUtils::verifySig(id, sig.signature, getContentsHash());
+            }
+        }
+    }
+}
+
 uint32_t
 TransactionFrame::getFee() const
 {
@@ -454,6 +545,23 @@ TransactionFrame::checkValid(Application& app, SequenceNumber current)
     return res;
 }
 
+bool
+TransactionFrame::checkValidAgain(Application& app, SequenceNumber current)
+{
+    resetSigningAccount();
+    resetResults();
+    if (!loadAccount(app.getLedgerManager().getCurrentLedgerVersion(), nullptr,
+                     app.getDatabase()))
+    {
+        return false;
+    }
+    if (current == 0)
+    {
+        current = mSigningAccount->getSeqNum();
+    }
+    return current + 1 == mEnvelope.tx.seqNum;
+}
+
 void
 TransactionFrame::markResultFailed()
 {
@@ -5,12 +5,14 @@
 // of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
 
 #include "ledger/AccountFrame.h"
+#include "ledger/LedgerHashUtils.h"
 #include "ledger/LedgerManager.h"
 #include "overlay/StellarXDR.h"
 #include "util/types.h"
 
 #include <memory>
 #include <set>
+#include <unordered_set>
 
 namespace soci
 {
@@ -27,6 +29,7 @@ class Application;
 class OperationFrame;
 class LedgerDelta;
 class SecretKey;
+class SignatureBatch;
 class SignatureChecker;
 class XDROutputFileStream;
 class SHA256;
@@ -128,6 +131,21 @@ class TransactionFrame
         return mEnvelope.tx.sourceAccount;
     }
 
+    // Add the keys of the accounts and trust lines applying this transaction
+    // will load, so they can be prefetched; see EntryFrame::prefetch.
+    void insertLedgerKeysToPrefetch(std::unordered_set<LedgerKey>& keys) const;
+
+    // Add the signatures checking this transaction against the current state
+    // of its source accounts would verify, so they can be verified ahead of
+    // time; see SignatureBatch.
+    void insertSignaturesToVerify(SignatureBatch& batch, Database& db) const;
+
+    // Verify, so that checking the transaction finds them in the cache, the
+    // signatures by the master keys of its source accounts, which are known
+    // without loading the accounts. Safe to call from a worker thread while
+    // no other thread uses the transaction.
+    void verifySourceKeySignatures() const;
+
     uint32_t getFee() const;
 
     int64_t getMinFee(LedgerManager const& lm) const;
@@ -142,6 +160,12 @@ class TransactionFrame
 
     bool checkValid(Application& app, SequenceNumber current);
 
+    // checkValid for a transaction that passed it against the current state
+    // of the ledger, with whatever sequence number: only loads the source
+    // account and checks the sequence number. When it fails, checkValid
+    // must be called to get the result.
+    bool checkValidAgain(Application& app, SequenceNumber current);
+
     // collect fee, consume sequence number
     void processFeeSeqNum(LedgerDelta& delta, LedgerManager& ledgerManager);
 
@@ -0,0 +1,233 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace stellar
+{
+
+/**
+ * Fixed-capacity cache with the same interface as cache::lru_cache, for hot
+ * paths where the latter's allocations show up.
+ *
+ * Entries live in a single open-addressing table with linear probing, sized
+ * to stay at most half full, so lookups touch one or two adjacent slots and
+ * allocate nothing. Instead of keeping entries in recency order, eviction
+ * uses the CLOCK approximation of LRU: every access sets a bit on the entry,
+ * and a hand sweeping the table evicts the first entry whose bit is clear,
+ * clearing the bits it passes over.
+ */
+template <typename K, typename V, typename H = std::hash<K>,
+          typename E = std::equal_to<K>>
+class ClockCache
+{
+    struct Slot
+    {
+        K mKey;
+        V mValue;
+        size_t mHash{0};
+        bool mOccupied{false};
+        bool mReferenced{false};
+    };
+
+    std::vector<Slot> mSlots;
+    size_t mMask;
+    size_t mMaxSize;
+    size_t mSize{0};
+    size_t mHand{0};
+    H mHasher;
+    E mEqual;
+
+    static size_t
+    tableSize(size_t maxSize)
+    {
+        size_t n = 2;
+        while (n < 2 * maxSize)
+        {
+            n *= 2;
+        }
+        return n;
+    }
+
+    // Slot holding `key`, or the empty slot where it would go.
+    size_t
+    find(K const& key, size_t hash) const
+    {
+        size_t i = hash & mMask;
+        while (mSlots[i].mOccupied &&
+               !(mSlots[i].mHash == hash && mEqual(mSlots[i].mKey, key)))
+        {
+            i = (i + 1) & mMask;
+        }
+        return i;
+    }
+
+    Slot*
+    lookup(K const& key)
+    {
+        auto& slot = mSlots[find(key, mHasher(key))];
+        return slot.mOccupied ? &slot : nullptr;
+    }
+
+    Slot const*
+    lookup(K const& key) const
+    {
+        auto const& slot = mSlots[find(key, mHasher(key))];
+        return slot.mOccupied ? &slot : nullptr;
+    }
+
+    // Empty slot `i`, then shift back any entries of the following run that
+    // can move closer to their home slot, so probes never need tombstones.
+    void
+    remove(size_t i)
+    {
+        mSlots[i] = Slot();
+        --mSize;
+        for (size_t j = (i + 1) & mMask; mSlots[j].mOccupied;
+             j = (j + 1) & mMask)
+        {
+            size_t home = mSlots[j].mHash & mMask;
+            if (((j - home) & mMask) >= ((j - i) & mMask))
+            {
+                mSlots[i] = std::move(mSlots[j]);
+                mSlots[j] = Slot();
+                i = j;
+            }
+        }
+    }
+
+    void
+    evictOne()
+    {
+        while (!mSlots[mHand].mOccupied || mSlots[mHand].mReferenced)
+        {
+            mSlots[mHand].mReferenced = false;
+            mHand = (mHand + 1) & mMask;
+        }
+        remove(mHand);
+    }
+
+  public:
+    explicit ClockCache(size_t maxSize)
+        : mSlots(tableSize(maxSize))
+        , mMask(mSlots.size() - 1)
+        , mMaxSize(maxSize)
+    {
+    }
+
+    void
+    put(K const& key, V const& value)
+    {
+        if (mMaxSize == 0)
+        {
+            return;
+        }
+        size_t hash = mHasher(key);
+        size_t i = find(key, hash);
+        if (!mSlots[i].mOccupied)
+        {
+            if (mSize == mMaxSize)
+            {
+                evictOne();
+                i = find(key, hash);
+            }
+            mSlots[i].mKey = key;
+            mSlots[i].mHash = hash;
+            mSlots[i].mOccupied = true;
+            ++mSize;
+        }
+        mSlots[i].mValue = value;
+        mSlots[i].mReferenced = true;
+    }
+
+    V&
+    get(K const& key)
+    {
+        auto slot = lookup(key);
+        if (!slot)
+        {
+            throw std::range_error("There is no such key in cache");
+        }
+        slot->mReferenced = true;
+        return slot->mValue;
+    }
+
+    // Like get, but returns nullptr rather than throwing for a missing key,
+    // saving the separate exists() probe.
+    V*
+    maybeGet(K const& key)
+    {
+        auto slot = lookup(key);
+        if (!slot)
+        {
+            return nullptr;
+        }
+        slot->mReferenced = true;
+        return &slot->mValue;
+    }
+
+    void
+    erase_if_exists(K const& key)
+    {
+        size_t i = find(key, mHasher(key));
+        if (mSlots[i].mOccupied)
+        {
+            remove(i);
+        }
+    }
+
+    template <typename F>
+    void
+    erase_if(F const& f)
+    {
+        // Removing shifts entries backwards, possibly onto slots already
+        // visited, so rebuild the table from the survivors instead.
+        std::vector<Slot> old(mSlots.size());
+        old.swap(mSlots);
+        mSize = 0;
+        for (auto& slot : old)
+        {
+            if (slot.mOccupied && !f(slot.mValue))
+            {
+                size_t i = find(slot.mKey, slot.mHash);
+                mSlots[i] = std::move(slot);
+                ++mSize;
+            }
+        }
+    }
+
+    void
+    clear()
+    {
+        for (auto& slot : mSlots)
+        {
+            slot = Slot();
+        }
+        mSize = 0;
+    }
+
+    bool
+    exists(K const& key) const
+    {
+        return lookup(key) != nullptr;
+    }
+
+    size_t
+    size() const
+    {
+        return mSize;
+    }
+
+    size_t
+    getMaxSize() const
+    {
+        return mMaxSize;
+    }
+};
+}
@@ -0,0 +1,199 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "lib/catch.hpp"
+#include "util/ClockCache.h"
+#include <map>
+#include <random>
+
+namespace stellar
+{
+
+using IntCache = ClockCache<int, int>;
+
+// Sends many keys to the same slot, to exercise probing and removal.
+struct CollidingHash
+{
+    size_t
+    operator()(int i) const
+    {
+        return static_cast<size_t>(i % 3);
+    }
+};
+
+TEST_CASE("clock cache empty", "[clock_cache]")
+{
+    auto c = IntCache{5};
+
+    REQUIRE(c.size() == 0);
+    REQUIRE(!c.exists(0));
+    REQUIRE(c.maybeGet(0) == nullptr);
+    REQUIRE_THROWS_AS(c.get(0), std::range_error);
+}
+
+TEST_CASE("clock cache keeps at most max size items", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    for (int i = 0; i < 5; ++i)
+    {
+        c.put(i, i);
+        REQUIRE(c.size() == i + 1);
+    }
+    c.put(5, 5);
+    REQUIRE(c.size() == 5);
+    REQUIRE(c.exists(5));
+    int kept = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        kept += c.exists(i) ? 1 : 0;
+    }
+    REQUIRE(kept == 4);
+}
+
+TEST_CASE("clock cache keeps recently read items", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    for (int i = 0; i < 6; ++i)
+    {
+        c.put(i, i);
+    }
+
+    // Evicting made the hand sweep past every item, clearing their bits, so
+    // the next eviction picks the only one not read since.
+    std::vector<int> kept;
+    for (int i = 0; i < 5; ++i)
+    {
+        if (c.exists(i))
+        {
+            kept.emplace_back(i);
+        }
+    }
+    REQUIRE(kept.size() == 4);
+    for (size_t i = 1; i < kept.size(); ++i)
+    {
+        REQUIRE(c.get(kept[i]) == kept[i]);
+    }
+    c.put(6, 6);
+
+    REQUIRE(c.size() == 5);
+    REQUIRE(!c.exists(kept[0]));
+    for (size_t i = 1; i < kept.size(); ++i)
+    {
+        REQUIRE(c.exists(kept[i]));
+    }
+    REQUIRE(c.exists(5));
+    REQUIRE(c.exists(6));
+}
+
+TEST_CASE("clock cache replace element", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    for (int i = 0; i < 5; ++i)
+    {
+        c.put(0, i);
+        REQUIRE(c.get(0) == i);
+        REQUIRE(*c.maybeGet(0) == i);
+    }
+    REQUIRE(c.size() == 1);
+}
+
+TEST_CASE("clock cache erase_if removes some nodes", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    for (int i = 0; i < 5; ++i)
+    {
+        c.put(i, i);
+    }
+    c.erase_if([](int i) { return i % 2 == 0; });
+
+    REQUIRE(c.size() == 2);
+    REQUIRE(!c.exists(0));
+    REQUIRE(c.exists(1));
+    REQUIRE(!c.exists(2));
+    REQUIRE(c.exists(3));
+    REQUIRE(!c.exists(4));
+}
+
+TEST_CASE("clock cache erase_if removes all nodes", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    for (int i = 0; i < 5; ++i)
+    {
+        c.put(i, i);
+    }
+    c.erase_if([](int) { return true; });
+
+    REQUIRE(c.size() == 0);
+    for (int i = 0; i < 5; ++i)
+    {
+        REQUIRE(!c.exists(i));
+    }
+}
+
+TEST_CASE("clock cache clear and erase_if_exists", "[clock_cache]")
+{
+    auto c = IntCache{5};
+    c.put(0, 0);
+    c.put(1, 1);
+    c.erase_if_exists(0);
+    c.erase_if_exists(7);
+    REQUIRE(c.size() == 1);
+    REQUIRE(!c.exists(0));
+    REQUIRE(c.exists(1));
+    c.clear();
+    REQUIRE(c.size() == 0);
+    REQUIRE(!c.exists(1));
+}
+
+TEST_CASE("clock cache zero size cache holds nothing", "[clock_cache]")
+{
+    auto c = IntCache{0};
+    c.put(0, 0);
+    REQUIRE(c.size() == 0);
+    REQUIRE(!c.exists(0));
+}
+
+TEST_CASE("clock cache colliding keys agree with a map", "[clock_cache]")
+{
+    std::default_random_engine gen;
+    std::uniform_int_distribution<int> keys(0, 100);
+    std::uniform_int_distribution<int> ops(0, 2);
+    ClockCache<int, int, CollidingHash> c{16};
+    std::map<int, int> model;
+    for (int n = 0; n < 10000; ++n)
+    {
+        int k = keys(gen);
+        switch (ops(gen))
+        {
+        case 0:
+            c.put(k, n);
+            model[k] = n;
+            break;
+        case 1:
+            c.erase_if_exists(k);
+            model.erase(k);
+            break;
+        default:
+            // Entries may have been evicted, but never hold stale values.
+            if (auto v = c.maybeGet(k))
+            {
+                REQUIRE(model.count(k) == 1);
+                REQUIRE(*v == model[k]);
+            }
+            break;
+        }
+        REQUIRE(c.size() <= 16);
+    }
+    size_t found = 0;
+    for (int k = 0; k <= 100; ++k)
+    {
+        if (c.exists(k))
+        {
+            REQUIRE(c.get(k) == model[k]);
+            ++found;
+        }
+    }
+    REQUIRE(found == c.size());
+}
+}
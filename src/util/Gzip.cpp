@@ -0,0 +1,246 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/Gzip.h"
+#include "crypto/ByteSlice.h"
+#include "crypto/SHA.h"
+#include "util/make_unique.h"
+#include <fstream>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace stellar
+{
+namespace gz
+{
+
+// Size of the buffers files are read into, and streams are decompressed into.
+static const size_t GZIP_BUFFER_SIZE = 1024 * 1024;
+
+// zlib's windowBits for the largest window, plus 16 for the gzip format.
+static const int GZIP_WINDOW_BITS = 15 + 16;
+
+static void
+throwZlibError(char const* what, z_stream const& stream)
+{
+    std::string msg(what);
+    if (stream.msg)
+    {
+        msg += ": ";
+        msg += stream.msg;
+    }
+    throw std::runtime_error(msg);
+}
+
+GzipDeflater::GzipDeflater()
+    : mStream(make_unique<z_stream>()), mOut(GZIP_BUFFER_SIZE)
+{
+    // The gzip tool's default level.
+    if (deflateInit2(mStream.get(), Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                     GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::runtime_error("failed to initialize gzip compression");
+    }
+}
+
+GzipDeflater::~GzipDeflater()
+{
+    deflateEnd(mStream.get());
+}
+
+void
+GzipDeflater::run(int flush, Sink const& out)
+{
+    int res;
+    do
+    {
+        mStream->next_out = mOut.data();
+        mStream->avail_out = static_cast<uInt>(mOut.size());
+        res = deflate(mStream.get(), flush);
+        if (res == Z_STREAM_ERROR)
+        {
+            throwZlibError("gzip compression failed", *mStream);
+        }
+        auto produced = mOut.size() - mStream->avail_out;
+        if (produced != 0)
+        {
+            out(mOut.data(), produced);
+        }
+    } while (mStream->avail_out == 0 ||
+             (flush == Z_FINISH && res != Z_STREAM_END));
+}
+
+void
+GzipDeflater::add(uint8_t const* data, size_t size, Sink const& out)
+{
+    mStream->next_in = const_cast<uint8_t*>(data);
+    mStream->avail_in = static_cast<uInt>(size);
+    run(Z_NO_FLUSH, out);
+}
+
+void
+GzipDeflater::finish(Sink const& out)
+{
+    mStream->next_in = nullptr;
+    mStream->avail_in = 0;
+    run(Z_FINISH, out);
+}
+
+GzipInflater::GzipInflater()
+    : mStream(make_unique<z_stream>()), mOut(GZIP_BUFFER_SIZE)
+{
+    if (inflateInit2(mStream.get(), GZIP_WINDOW_BITS) != Z_OK)
+    {
+        throw std::runtime_error("failed to initialize gzip decompression");
+    }
+}
+
+GzipInflater::~GzipInflater()
+{
+    inflateEnd(mStream.get());
+}
+
+void
+GzipInflater::add(uint8_t const* data, size_t size, Sink const& out)
+{
+    mStream->next_in = const_cast<uint8_t*>(data);
+    mStream->avail_in = static_cast<uInt>(size);
+    while (true)
+    {
+        if (mMemberEnded)
+        {
+            if (mStream->avail_in == 0)
+            {
+                return;
+            }
+            // Another member follows.
+            inflateReset(mStream.get());
+            mMemberEnded = false;
+        }
+
+        mStream->next_out = mOut.data();
+        mStream->avail_out = static_cast<uInt>(mOut.size());
+        auto res = inflate(mStream.get(), Z_NO_FLUSH);
+        if (res == Z_STREAM_END)
+        {
+            mMemberEnded = true;
+        }
+        else if (res != Z_OK && res != Z_BUF_ERROR)
+        {
+            throwZlibError("corrupt gzip stream", *mStream);
+        }
+
+        auto produced = mOut.size() - mStream->avail_out;
+        if (produced != 0)
+        {
+            out(mOut.data(), produced);
+        }
+        // With room left for output, everything was consumed.
+        if (!mMemberEnded && mStream->avail_out != 0)
+        {
+            return;
+        }
+    }
+}
+
+void
+GzipInflater::finish()
+{
+    if (!mMemberEnded)
+    {
+        throw std::runtime_error("truncated gzip stream");
+    }
+}
+
+static void
+openFiles(std::string const& in, std::ifstream& inStream,
+          std::string const& out, std::ofstream& outStream)
+{
+    inStream.open(in, std::ifstream::binary);
+    if (!inStream)
+    {
+        throw std::runtime_error("failed to open " + in + ", reason: " +
+                                 std::to_string(errno));
+    }
+    outStream.open(out, std::ofstream::binary | std::ofstream::trunc);
+    if (!outStream)
+    {
+        throw std::runtime_error("failed to open " + out + ", reason: " +
+                                 std::to_string(errno));
+    }
+}
+
+// Calls `process` on the contents of `in` in blocks, then checks both
+// streams went fine.
+template <typename F>
+static void
+processFile(std::string const& in, std::ifstream& inStream,
+            std::string const& out, std::ofstream& outStream, F process)
+{
+    std::vector<char> buf(GZIP_BUFFER_SIZE);
+    while (inStream)
+    {
+        inStream.read(buf.data(), buf.size());
+        process(reinterpret_cast<uint8_t const*>(buf.data()),
+                static_cast<size_t>(inStream.gcount()));
+    }
+    if (inStream.bad())
+    {
+        throw std::runtime_error("failed to read " + in);
+    }
+    outStream.close();
+    if (!outStream)
+    {
+        throw std::runtime_error("failed to write " + out);
+    }
+}
+
+void
+gzipFile(std::string const& in, std::string const& out)
+{
+    std::ifstream inStream;
+    std::ofstream outStream;
+    openFiles(in, inStream, out, outStream);
+
+    GzipDeflater deflater;
+    auto sink = [&outStream](uint8_t const* data, size_t size) {
+        outStream.write(reinterpret_cast<char const*>(data), size);
+    };
+    processFile(in, inStream, out, outStream,
+                [&](uint8_t const* data, size_t size) {
+                    deflater.add(data, size, sink);
+                    if (!inStream)
+                    {
+                        deflater.finish(sink);
+                    }
+                });
+}
+
+uint64_t
+gunzipFile(std::string const& in, std::string const& out, SHA256* hasher)
+{
+    std::ifstream inStream;
+    std::ofstream outStream;
+    openFiles(in, inStream, out, outStream);
+
+    GzipInflater inflater;
+    uint64_t written = 0;
+    auto sink = [&outStream, hasher, &written](uint8_t const* data,
+                                               size_t size) {
+        outStream.write(reinterpret_cast<char const*>(data), size);
+        written += size;
+        if (hasher)
+        {
+            hasher->add(ByteSlice(data, size));
+        }
+    };
+    processFile(in, inStream, out, outStream,
+                [&](uint8_t const* data, size_t size) {
+                    inflater.add(data, size, sink);
+                });
+    inflater.finish();
+    return written;
+}
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "util/NonCopyable.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct z_stream_s;
+
+namespace stellar
+{
+
+class SHA256;
+
+/**
+ * In-process, streaming gzip compression and decompression, producing and
+ * accepting the same format as the gzip tool, so that history archives can be
+ * read and written by either.
+ *
+ * Errors, including corrupt input, throw std::runtime_error.
+ */
+namespace gz
+{
+
+// Receives the output of a GzipDeflater or GzipInflater, in pieces.
+typedef std::function<void(uint8_t const* data, size_t size)> Sink;
+
+// Compresses a stream given in pieces.
+class GzipDeflater : NonMovableOrCopyable
+{
+    std::unique_ptr<z_stream_s> mStream;
+    std::vector<uint8_t> mOut;
+
+    void run(int flush, Sink const& out);
+
+  public:
+    GzipDeflater();
+    ~GzipDeflater();
+
+    void add(uint8_t const* data, size_t size, Sink const& out);
+    // Writes the end of the stream.
+    void finish(Sink const& out);
+};
+
+// Decompresses a stream given in pieces. Like the gzip tool, accepts several
+// gzip members one after the other.
+class GzipInflater : NonMovableOrCopyable
+{
+    std::unique_ptr<z_stream_s> mStream;
+    std::vector<uint8_t> mOut;
+    bool mMemberEnded{false};
+
+  public:
+    GzipInflater();
+    ~GzipInflater();
+
+    void add(uint8_t const* data, size_t size, Sink const& out);
+    // Throws if the input stopped in the middle of a member.
+    void finish();
+};
+
+// Compresses `in` into `out`.
+void gzipFile(std::string const& in, std::string const& out);
+
+// Decompresses `in` into `out`, adding what it writes to `hasher` if it isn't
+// null. Returns the number of bytes written.
+uint64_t gunzipFile(std::string const& in, std::string const& out,
+                    SHA256* hasher = nullptr);
+}
+}
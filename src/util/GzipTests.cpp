@@ -0,0 +1,90 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/SHA.h"
+#include "lib/catch.hpp"
+#include "util/Gzip.h"
+#include "util/Math.h"
+#include "util/TmpDir.h"
+#include <fstream>
+
+using namespace stellar;
+
+namespace
+{
+
+void
+writeFile(std::string const& filename, std::string const& contents)
+{
+    std::ofstream out(filename, std::ofstream::binary);
+    out.write(contents.data(), contents.size());
+}
+
+std::string
+readFile(std::string const& filename)
+{
+    std::ifstream in(filename, std::ifstream::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+}
+}
+
+TEST_CASE("gzip files round-trip", "[gzip]")
+{
+    TmpDir tmp("gzip");
+    std::string plain = tmp.getName() + "/file";
+    std::string compressed = plain + ".gz";
+    std::string unzipped = plain + ".out";
+
+    // Compressible and incompressible data, larger than the buffers.
+    std::string contents(3 * 1024 * 1024, 'a');
+    for (size_t i = 0; i < 1024 * 1024; i++)
+    {
+        contents[i] = static_cast<char>(rand_uniform(0, 255));
+    }
+
+    SECTION("one member")
+    {
+        writeFile(plain, contents);
+        gz::gzipFile(plain, compressed);
+        auto hasher = SHA256::create();
+        gz::gunzipFile(compressed, unzipped, hasher.get());
+        REQUIRE(readFile(unzipped) == contents);
+        REQUIRE(hasher->finish() == sha256(contents));
+    }
+
+    SECTION("several members")
+    {
+        writeFile(plain, contents);
+        gz::gzipFile(plain, compressed);
+        auto member = readFile(compressed);
+        writeFile(compressed, member + member);
+        gz::gunzipFile(compressed, unzipped);
+        REQUIRE(readFile(unzipped) == contents + contents);
+    }
+
+    SECTION("empty file")
+    {
+        writeFile(plain, "");
+        gz::gzipFile(plain, compressed);
+        gz::gunzipFile(compressed, unzipped);
+        REQUIRE(readFile(unzipped).empty());
+    }
+
+    SECTION("truncated or corrupt input")
+    {
+        writeFile(plain, contents);
+        gz::gzipFile(plain, compressed);
+        auto member = readFile(compressed);
+
+        writeFile(compressed, member.substr(0, member.size() / 2));
+        REQUIRE_THROWS_AS(gz::gunzipFile(compressed, unzipped),
+                          std::runtime_error);
+
+        member[member.size() / 2] ^= 0xff;
+        writeFile(compressed, member);
+        REQUIRE_THROWS_AS(gz::gunzipFile(compressed, unzipped),
+                          std::runtime_error);
+    }
+}
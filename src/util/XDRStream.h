@@ -8,6 +8,7 @@
 #include "crypto/SHA.h"
 #include "util/Logging.h"
 #include "xdrpp/marshal.h"
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -15,6 +16,11 @@
 namespace stellar
 {
 
+// Default size of the block buffers used by XDR file streams. Records are
+// decoded from, and encoded into, these buffers in place, so the underlying
+// file is only touched once per block rather than several times per record.
+static const size_t XDR_FILE_STREAM_BUFFER_SIZE = 1024 * 1024;
+
 /**
  * Helper for loading a sequence of XDR objects from a file one at a time,
  * rather than all at once.
@@ -23,10 +29,78 @@ class XDRInputFileStream
 {
     std::ifstream mIn;
     std::vector<char> mBuf;
+    // Unconsumed bytes are mBuf[mBufPos, mBufEnd); mBuf[0] is at file offset
+    // mBufOffset.
+    size_t mBufPos{0};
+    size_t mBufEnd{0};
+    std::streamoff mBufOffset{0};
     unsigned int mSizeLimit;
 
+    // Make at least `n` unconsumed bytes available in the buffer, reading a
+    // block from the file if needed. Returns false if the file has fewer than
+    // `n` bytes left.
+    bool
+    fill(size_t n)
+    {
+        if (mBufEnd - mBufPos >= n)
+        {
+            return true;
+        }
+        if (!mIn)
+        {
+            return false;
+        }
+
+        // Move the unconsumed tail to the front and top up the buffer.
+        size_t left = mBufEnd - mBufPos;
+        if (left != 0 && mBufPos != 0)
+        {
+            std::memmove(mBuf.data(), mBuf.data() + mBufPos, left);
+        }
+        mBufOffset += mBufPos;
+        mBufPos = 0;
+        mBufEnd = left;
+        if (mBuf.size() < n)
+        {
+            mBuf.resize(n);
+        }
+        mIn.read(mBuf.data() + mBufEnd, mBuf.size() - mBufEnd);
+        mBufEnd += static_cast<size_t>(mIn.gcount());
+        return mBufEnd >= n;
+    }
+
+    bool
+    readSize(uint32_t& sz)
+    {
+        if (!fill(4))
+        {
+            return false;
+        }
+
+        // Read 4 bytes of size, big-endian, with XDR 'continuation' bit cleared
+        // (high bit of high byte).
+        char const* szBuf = mBuf.data() + mBufPos;
+        sz = 0;
+        sz |= static_cast<uint8_t>(szBuf[0] & '\x7f');
+        sz <<= 8;
+        sz |= static_cast<uint8_t>(szBuf[1]);
+        sz <<= 8;
+        sz |= static_cast<uint8_t>(szBuf[2]);
+        sz <<= 8;
+        sz |= static_cast<uint8_t>(szBuf[3]);
+
+        if (mSizeLimit != 0 && sz > mSizeLimit)
+        {
+            return false;
+        }
+        mBufPos += 4;
+        return true;
+    }
+
   public:
-    XDRInputFileStream(unsigned int sizeLimit = 0) : mSizeLimit{sizeLimit}
+    XDRInputFileStream(unsigned int sizeLimit = 0,
+                       size_t bufferSize = XDR_FILE_STREAM_BUFFER_SIZE)
+        : mBuf(bufferSize), mSizeLimit{sizeLimit}
     {
     }
 
@@ -34,6 +108,8 @@ class XDRInputFileStream
     close()
     {
         mIn.close();
+        mBufOffset = 0;
+        mBufPos = mBufEnd = 0;
     }
 
     void
@@ -49,62 +125,126 @@ class XDRInputFileStream
             CLOG(ERROR, "Fs") << msg;
             throw std::runtime_error(msg);
         }
+        mBufOffset = 0;
+        mBufPos = mBufEnd = 0;
     }
 
     operator bool() const
     {
-        return mIn.good();
+        return mBufPos < mBufEnd || mIn.good();
     }
 
-    template <typename T>
-    bool
-    readOne(T& out)
+    // Offset of the next record to be read.
+    std::streamoff
+    pos() const
     {
-        char szBuf[4];
-        if (!mIn.read(szBuf, 4))
+        return mBufOffset + static_cast<std::streamoff>(mBufPos);
+    }
+
+    // Position the stream at `offset`, which must be a record boundary
+    // previously returned by `pos`.
+    void
+    seek(std::streamoff offset)
+    {
+        if (offset >= mBufOffset &&
+            offset <= mBufOffset + static_cast<std::streamoff>(mBufEnd))
         {
-            return false;
+            mBufPos = static_cast<size_t>(offset - mBufOffset);
+            return;
         }
+        mIn.clear();
+        mIn.seekg(offset);
+        mBufOffset = offset;
+        mBufPos = mBufEnd = 0;
+    }
 
-        // Read 4 bytes of size, big-endian, with XDR 'continuation' bit cleared
-        // (high bit of high byte).
-        uint32_t sz = 0;
-        sz |= static_cast<uint8_t>(szBuf[0] & '\x7f');
-        sz <<= 8;
-        sz |= static_cast<uint8_t>(szBuf[1]);
-        sz <<= 8;
-        sz |= static_cast<uint8_t>(szBuf[2]);
-        sz <<= 8;
-        sz |= static_cast<uint8_t>(szBuf[3]);
-
-        if (mSizeLimit != 0 && sz > mSizeLimit)
+    // Step over the next record without decoding it; returns false at end of
+    // file.
+    bool
+    skipOne()
+    {
+        uint32_t sz;
+        if (!readSize(sz))
         {
             return false;
         }
-        if (sz > mBuf.size())
+        if (mBufEnd - mBufPos >= sz)
+        {
+            mBufPos += sz;
+        }
+        else
         {
-            mBuf.resize(sz);
+            seek(pos() + sz);
         }
-        if (!mIn.read(mBuf.data(), sz))
+        return true;
+    }
+
+    template <typename T>
+    bool
+    readOne(T& out)
+    {
+        uint32_t sz;
+        if (!readSize(sz))
+        {
+            return false;
+        }
+        if (!fill(sz))
         {
             throw xdr::xdr_runtime_error("malformed XDR file");
         }
-        xdr::xdr_get g(mBuf.data(), mBuf.data() + sz);
+        char const* begin = mBuf.data() + mBufPos;
+        xdr::xdr_get g(begin, begin + sz);
+        mBufPos += sz;
         xdr::xdr_argpack_archive(g, out);
         return true;
     }
 };
 
+/**
+ * Helper for writing a sequence of XDR objects to a file. Records are encoded
+ * into a block buffer that is written out when full and on `close`.
+ */
 class XDROutputFileStream
 {
     std::ofstream mOut;
     std::vector<char> mBuf;
+    size_t mBufEnd{0};
+
+    bool
+    flush()
+    {
+        if (mBufEnd != 0)
+        {
+            mOut.write(mBuf.data(), mBufEnd);
+            mBufEnd = 0;
+        }
+        return mOut.good();
+    }
 
   public:
-    void
+    XDROutputFileStream(size_t bufferSize = XDR_FILE_STREAM_BUFFER_SIZE)
+        : mBuf(bufferSize)
+    {
+    }
+
+    // Closing here can't report failure: callers that need the data on disk
+    // must call `close` themselves and check its result.
+    ~XDROutputFileStream()
+    {
+        if (mOut.is_open())
+        {
+            close();
+        }
+    }
+
+    // Write out any buffered records and close the file. Returns false if
+    // any record written since `open` failed to reach the file.
+    bool
     close()
     {
+        bool ok = flush();
         mOut.close();
+        return ok && !mOut.fail();
     }
 
     void
@@ -120,6 +260,7 @@ class XDROutputFileStream
             CLOG(FATAL, "Fs") << msg;
             throw std::runtime_error(msg);
         }
+        mBufEnd = 0;
     }
 
     operator bool() const
@@ -134,28 +275,33 @@ class XDROutputFileStream
         uint32_t sz = (uint32_t)xdr::xdr_size(t);
         assert(sz < 0x80000000);
 
-        if (mBuf.size() < sz + 4)
+        if (mBuf.size() - mBufEnd < sz + 4)
         {
-            mBuf.resize(sz + 4);
+            if (!flush())
+            {
+                return false;
+            }
+            if (mBuf.size() < sz + 4)
+            {
+                mBuf.resize(sz + 4);
+            }
         }
 
         // Write 4 bytes of size, big-endian, with XDR 'continuation' bit set on
         // high bit of high byte.
-        mBuf[0] = static_cast<char>((sz >> 24) & 0xFF) | '\x80';
-        mBuf[1] = static_cast<char>((sz >> 16) & 0xFF);
-        mBuf[2] = static_cast<char>((sz >> 8) & 0xFF);
-        mBuf[3] = static_cast<char>(sz & 0xFF);
+        char* buf = mBuf.data() + mBufEnd;
+        buf[0] = static_cast<char>((sz >> 24) & 0xFF) | '\x80';
+        buf[1] = static_cast<char>((sz >> 16) & 0xFF);
+        buf[2] = static_cast<char>((sz >> 8) & 0xFF);
+        buf[3] = static_cast<char>(sz & 0xFF);
 
-        xdr::xdr_put p(mBuf.data() + 4, mBuf.data() + 4 + sz);
+        xdr::xdr_put p(buf + 4, buf + 4 + sz);
         xdr_argpack_archive(p, t);
+        mBufEnd += sz + 4;
 
-        if (!mOut.write(mBuf.data(), sz + 4))
-        {
-            return false;
-        }
         if (hasher)
         {
-            hasher->add(ByteSlice(mBuf.data(), sz + 4));
+            hasher->add(ByteSlice(buf, sz + 4));
         }
         if (bytesPut)
         {
@@ -0,0 +1,66 @@
+// Copyright 2017 Stellar Development Foundation and contributors. Licensed
+// under the Apache License, Version 2.0. See the COPYING file at the root
+// of this distribution or at http://www.apache.org/licenses/LICENSE-2.0
+
+#include "crypto/SHA.h"
+#include "ledger/LedgerTestUtils.h"
+#include "lib/catch.hpp"
+#include "util/TmpDir.h"
+#include "util/XDRStream.h"
+
+using namespace stellar;
+using xdr::operator==;
+
+TEST_CASE("XDR file streams round-trip through small buffers", "[xdrstream]")
+{
+    TmpDir tmp("xdrstream");
+    std::string filename = tmp.getName() + "/entries.xdr";
+    auto entries = LedgerTestUtils::generateValidLedgerEntries(200);
+
+    for (size_t bufferSize : {4, 64, 1024, 1024 * 1024})
+    {
+        auto h1 = SHA256::create();
+        auto h2 = SHA256::create();
+        std::vector<std::streamoff> offsets;
+        {
+            XDROutputFileStream out(bufferSize);
+            out.open(filename);
+            for (auto const& e : entries)
+            {
+                REQUIRE(out.writeOne(e, h1.get()));
+                h2->add(xdr::xdr_to_opaque(static_cast<uint32_t>(
+                    0x80000000 | xdr::xdr_size(e))));
+                h2->add(xdr::xdr_to_opaque(e));
+            }
+            REQUIRE(out.close());
+        }
+        REQUIRE(h1->finish() == h2->finish());
+
+        XDRInputFileStream in(0, bufferSize);
+        in.open(filename);
+        LedgerEntry e;
+        for (auto const& expected : entries)
+        {
+            offsets.push_back(in.pos());
+            REQUIRE(in);
+            REQUIRE(in.readOne(e));
+            REQUIRE(e == expected);
+        }
+        REQUIRE(!in.readOne(e));
+        REQUIRE(!in);
+
+        // Seek backwards and forwards, skipping some records.
+        for (size_t i : {150, 3, 199, 0, 100})
+        {
+            in.seek(offsets[i]);
+            REQUIRE(in.skipOne());
+            if (i + 1 < offsets.size())
+            {
+                REQUIRE(in.pos() == offsets[i + 1]);
+            }
+            in.seek(offsets[i]);
+            REQUIRE(in.readOne(e));
+            REQUIRE(e == entries[i]);
+        }
+    }
+}